@@ -0,0 +1,213 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+#include "action.h"
+#include "screen_renderer.h"
+
+// Show everything on the console screen so far (the table and the question under it) in one go, then read the player's answer
+void ReadConsoleAnswer(std::string &answer) {
+    ConsoleScreen().Present();
+    if (!getline(std::cin, answer)) {
+        throw std::runtime_error("the input ended while waiting for an answer");
+    }
+}
+
+// Ask the player at the console what they want to do, with the same prompts as the original betting loop
+PlayerAction ConsoleActionProvider::ChooseAction(const TurnState &turn) {
+    ScreenRenderer &screen = ConsoleScreen();
+    std::string choice = "";
+    PlayerAction action;
+
+    // If the big blind has the option before the flop, they can only raise or check
+    if (turn.bigBlindOption) {
+        screen << turn.name << " still has the highest bet from the big blind. ";
+        screen << turn.name << " can either (r)aise or (c)heck.\n";
+        // Receive the player's input for the choice they decide
+        ReadConsoleAnswer(choice);
+
+        // Keep asking until they give one of the two viable options
+        while (choice != "r" && choice != "c") {
+            screen << "That is not a valid choice, please enter again.\n";
+            screen << "Choose to (r)aise or (c)heck\n";
+
+            ReadConsoleAnswer(choice);
+        }
+
+        if (choice == "r") {
+            return AskForRaise(turn);
+        }
+        action.type = CHECK;
+        return action;
+    }
+
+    // If the player has already matched the highest bet, the option for them would be "check" instead of "call"
+    std::string callOrCheck = turn.callingCost == 0 ? "(c)heck" : "(c)all";
+    screen << turn.name << " must decide to (r)aise, " << callOrCheck << " or (f)old.\n";
+
+    ReadConsoleAnswer(choice);
+
+    while (choice != "r" && choice != "c" && choice != "f") {
+        screen << "That is not a valid choice, please enter again." << '\n';
+        screen << "Choose to (r)aise, " << callOrCheck << " or (f)old.\n";
+
+        ReadConsoleAnswer(choice);
+    }
+
+    if (choice == "r") {
+        return AskForRaise(turn);
+    }
+    else if (choice == "f") {
+        action.type = FOLD;
+    }
+    else {
+        action.type = turn.callingCost == 0 ? CHECK : CALL;
+    }
+
+    return action;
+}
+
+// Ask how much the player wants to raise, or whether they want to go all-in or fold if they cannot afford a raise
+PlayerAction ConsoleActionProvider::AskForRaise(const TurnState &turn) {
+    ScreenRenderer &screen = ConsoleScreen();
+    PlayerAction action;
+
+    // Check if the amount to call the current bet is too high for the current player to raise it
+    // For example, if the current highest bet is 5, but the player only has 5 (or less),
+    // the player cannot raise and bet 6. They are then limited to going all-in or folding
+    if (turn.callingCost >= turn.chips) {
+        // Explain their situation and offer a new choice
+        std::string choice;
+        screen << "You do not have enough chips to raise the current max bet. Would you like to go (a)ll-in or (f)old?\n";
+        ReadConsoleAnswer(choice);
+
+        // Loop to make sure the player inputs a readable response
+        while (choice != "a" && choice != "f") {
+            screen << "Select either 'a' for all-in or 'f' for fold: ";
+
+            ReadConsoleAnswer(choice);
+        }
+
+        action.type = choice == "a" ? ALL_IN : FOLD;
+        return action;
+    }
+
+    // Otherwise, ask how much the player would like to raise
+    std::string bet;
+    int maxRaise = turn.chips - turn.callingCost;
+    screen << "How much would you like to raise?";
+    screen << " (Enter a number between 1 and " << maxRaise << "): ";
+    ReadConsoleAnswer(bet);
+
+    // Loop to ensure the player only raises an amount they have
+    while (bet.empty() || bet.size() > 9 || !std::all_of(bet.begin(), bet.end(), ::isdigit) || stoi(bet) < 1 || stoi(bet) > maxRaise) {
+        screen << "Not a valid raise amount.";
+        screen << " Enter a number between 1 and " << maxRaise << ": ";
+        ReadConsoleAnswer(bet);
+    }
+
+    action.type = RAISE;
+    action.amount = stoi(bet);
+    return action;
+}
+
+// The table is only shown when the console screen is not quiet
+bool ConsoleActionProvider::ShowsTable() {
+    return !ConsoleScreen().IsQuiet();
+}
+
+// Initialization of a script with the actions to play in order, and the action to use once they run out
+ScriptedActionProvider::ScriptedActionProvider(std::vector<PlayerAction> actions, PlayerAction fallback) {
+    this->actions = actions;
+    this->fallback = fallback;
+    nextAction = 0;
+}
+
+// Return the next action in the script, or the fallback action once the script is finished
+PlayerAction ScriptedActionProvider::ChooseAction(const TurnState &) {
+    if (nextAction < actions.size()) {
+        return actions.at(nextAction++);
+    }
+
+    return fallback;
+}
+
+// Return how many actions in the script have not been used yet
+int ScriptedActionProvider::ActionsLeft() {
+    return actions.size() - nextAction;
+}
+
+// Give the player with this name their own provider
+void TableActionProvider::AddPlayer(std::string name, ActionProvider &provider) {
+    seats[name] = &provider;
+}
+
+// Pass the decision on to the provider of the player whose turn it is
+// Throws std::out_of_range if the player was never added to the table
+PlayerAction TableActionProvider::ChooseAction(const TurnState &turn) {
+    auto seat = seats.find(turn.name);
+    if (seat != seats.end()) {
+        return seat->second->ChooseAction(turn);
+    }
+
+    throw std::out_of_range("TableActionProvider: no provider for player \"" + turn.name + "\"");
+}
+
+// Write an action as its short word
+std::string ActionString(PlayerAction action) {
+    switch (action.type) {
+        case FOLD:
+            return "f";
+        case CHECK:
+            return "k";
+        case CALL:
+            return "c";
+        case RAISE:
+            return "r" + std::to_string(action.amount);
+        case ALL_IN:
+            return "a";
+    }
+
+    return "?";
+}
+
+// Read a list of actions written as short words separated by spaces
+std::vector<PlayerAction> ParseActions(std::string text) {
+    std::vector<PlayerAction> actions;
+    std::istringstream words(text);
+    std::string word;
+
+    while (words >> word) {
+        PlayerAction action;
+
+        if (word == "f") {
+            action.type = FOLD;
+        }
+        else if (word == "k") {
+            action.type = CHECK;
+        }
+        else if (word == "c") {
+            action.type = CALL;
+        }
+        else if (word == "a") {
+            action.type = ALL_IN;
+        }
+        // A raise needs its amount written straight after the "r"
+        else if (word.size() > 1 && word.size() <= 10 && word[0] == 'r' &&
+                 std::all_of(word.begin() + 1, word.end(), ::isdigit)) {
+            action.type = RAISE;
+            action.amount = std::stoi(word.substr(1));
+        }
+        else {
+            throw std::invalid_argument("ParseActions: \"" + word + "\" is not an action");
+        }
+
+        actions.push_back(action);
+    }
+
+    return actions;
+}
@@ -0,0 +1,131 @@
+#ifndef ACTION_H
+#define ACTION_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "card.h"
+
+// The different decisions a player can make when it is their turn to bet
+enum ActionType {
+    FOLD,
+    CHECK,
+    CALL,
+    RAISE,
+    ALL_IN
+};
+
+/* One player's decision. For a RAISE, "amount" is how many chips go in on top of what it costs to call
+   the current highest bet (the same number a human types in when asked how much to raise); it is ignored otherwise.
+   Round accepts any decision and turns it into the closest one the player can actually make:
+   checking with a bet to call is a call, raising without enough chips (or by more than the player has) is going all-in,
+   and a raise of less than 1 chip is raised to 1.
+*/
+struct PlayerAction {
+    ActionType type = CALL;
+    int amount = 0;
+};
+
+/* Everything a player can see when it is their turn to bet. Round fills one in for each decision
+   and hands it to its ActionProvider.
+*/
+struct TurnState {
+    // The player's place in the round's players vector, and their name
+    int playerIndex = 0;
+    std::string name;
+    // The player's own cards, the community cards dealt so far, and the hand key of the best hand they make (0 before the flop)
+    CardMask hand = 0;
+    CardMask communityHand = 0;
+    unsigned int handKey = 0;
+    // The player's chips behind, what they have bet so far this hand, and the highest bet at the table
+    int chips = 0;
+    int totalBet = 0;
+    int highestBet = 0;
+    // How many more chips it costs the player to match the highest bet (0 means they can check)
+    int callingCost = 0;
+    // Every chip bet by every player so far this hand
+    int pot = 0;
+    int numPlayers = 0;
+    int numFolded = 0;
+    int numAllIn = 0;
+    // The round number during the first betting round of a hand, -1 for the betting rounds after each street
+    int roundNumber = -1;
+    // True when the big blind gets the last word before the flop with no raise to answer:
+    // anything but a raise (or going all-in) checks and ends the betting round
+    bool bigBlindOption = false;
+};
+
+/* The interface between a Round and whoever makes its players' decisions. A Round asks its provider for every
+   decision, so the same game can be played by people at the console, by code choosing actions on its own,
+   or by a fixed script, and only the console version ever waits for anything.
+*/
+class ActionProvider {
+    public:
+        virtual ~ActionProvider() {}
+        // Decide what the player described by "turn" does
+        virtual PlayerAction ChooseAction(const TurnState &turn) = 0;
+        // Whether the Round should print the table for each player and pause at the end of each hand,
+        // which only makes sense when people are playing at the console
+        virtual bool ShowsTable() { return false; }
+        // Copy the state of the provider's random number generator out (returning false if it makes no random decisions), or back in,
+        // so a game saved in a snapshot (see snapshot.h) carries on with the same decisions it would have made
+        virtual bool SaveRandomState(uint64_t [4]) { return false; }
+        virtual void RestoreRandomState(const uint64_t [4]) {}
+};
+
+/* The human players at the console: the table is shown before every decision and each decision is typed in,
+   asking again until a valid answer is given. Each question is added under the table on the console screen (see screen_renderer.h),
+   which is shown in one go just before the answer is read. When the console screen is quiet, nothing is shown at all
+   and the answers are just read one after another, so a whole game can be played from a file of answers.
+   If the input ends before a valid answer is given, ChooseAction throws std::runtime_error, as asking again would never get one.
+*/
+class ConsoleActionProvider : public ActionProvider {
+    public:
+        PlayerAction ChooseAction(const TurnState &turn);
+        bool ShowsTable();
+
+    private:
+        PlayerAction AskForRaise(const TurnState &turn);
+};
+
+// Show everything on the console screen so far (a question and anything above it) in one go, then read a line of the answer.
+// Throws std::runtime_error if the input has ended, such as a file of answers that has run out
+void ReadConsoleAnswer(std::string &answer);
+
+/* Decisions taken one after another from a fixed list, whoever's turn it is. Once the list runs out,
+   every further decision is the fallback action (calling by default, which checks when there is nothing to call).
+*/
+class ScriptedActionProvider : public ActionProvider {
+    public:
+        ScriptedActionProvider(std::vector<PlayerAction> actions, PlayerAction fallback = PlayerAction());
+        PlayerAction ChooseAction(const TurnState &turn);
+        int ActionsLeft();
+
+    private:
+        std::vector<PlayerAction> actions;
+        size_t nextAction;
+        PlayerAction fallback;
+};
+
+/* Each player's decisions made by that player's own provider, found by the player's name. This lets players with
+   different strategies sit at the same table, since a Round has only one provider for all of its players.
+   The providers are not owned by the table and must outlive it. Once every player has been added, several Rounds
+   may share one table from different threads, since choosing an action only looks the player up.
+*/
+class TableActionProvider : public ActionProvider {
+    public:
+        void AddPlayer(std::string name, ActionProvider &provider);
+        PlayerAction ChooseAction(const TurnState &turn);
+
+    private:
+        std::unordered_map<std::string, ActionProvider *> seats;
+};
+
+// Write an action as a short word: "f" to fold, "k" to check, "c" to call, "r" followed by the amount to raise, "a" for all-in
+std::string ActionString(PlayerAction action);
+// Read a list of actions written as short words separated by spaces, such as "c r10 k f a".
+// Throws std::invalid_argument if any word is not an action
+std::vector<PlayerAction> ParseActions(std::string text);
+
+#endif
@@ -1,29 +1,160 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <stdexcept>
+#include <cctype>
 
 #include "card.h"
 
-// Instantiate the card object with the input card number and card suit
-// Also, create a string version of the card to call when necessary
+// Instantiate the card object with the input card number and card suit,
+// packing both into the card's one-byte code
 Card::Card(int cardNumber, int suit) {
-    this->cardNumber = cardNumber;
-    this->suit = suit;
+    // A card number of 0 (or suit of 0) is an empty card
+    if (cardNumber == 0 || suit == 0) {
+        code = NO_CARD;
+        return;
+    }
+
+    // The Ace (card number 1) ranks above the King, so it takes the top rank
+    int rank = cardNumber == 1 ? 12 : cardNumber - 2;
+    code = ((suit - 1) << CARD_SUIT_SHIFT) | rank;
+}
+
+// Create a card straight from its one-byte code
+Card Card::FromCode(unsigned char code) {
+    Card card;
+    card.code = code;
+    return card;
 }
 
 // Getter for the card number
-int Card::GetCardNumber() {
-    return cardNumber;
+int Card::GetCardNumber() const {
+    if (code == NO_CARD) {
+        return 0;
+    }
+
+    int rank = code & 0xF;
+    return rank == 12 ? 1 : rank + 2;
+}
+
+// Getter for the card number with the Ace counted high (2-14), the way hands are ranked
+int Card::GetHighCardNumber() const {
+    if (code == NO_CARD) {
+        return 0;
+    }
+
+    return (code & 0xF) + 2;
 }
 
 // Getter for the card suit
-int Card::GetCardSuit() {
-    return suit;
+int Card::GetCardSuit() const {
+    if (code == NO_CARD) {
+        return 0;
+    }
+
+    return (code >> CARD_SUIT_SHIFT) + 1;
+}
+
+// Getter for the card's one-byte code
+unsigned char Card::GetCardCode() const {
+    return code;
+}
+
+// Getter for the card as a set holding only this card, or an empty set for an empty card
+// (or any code that is not a card, so a damaged code can never shift the bit past the end of the mask)
+CardMask Card::GetCardMask() const {
+    if (!IsValidCardCode(code)) {
+        return 0;
+    }
+
+    return CardMask(1) << code;
 }
 
 // Getter for the card as string
 std::string Card::GetCardString() {
-    return ConvertToString(cardNumber, suit);
+    return ConvertToString(GetCardNumber(), GetCardSuit());
+}
+
+// Getter for the card as a string, the same as GetCardString but looked up in a table of every card's name made the first time
+// it is needed, so showing a card never builds a new string
+const std::string &Card::GetCardName() const {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> table(1 << (CARD_SUIT_SHIFT + 2), "");
+        for (int suit = 1; suit <= 4; suit++) {
+            for (int cardNumber = 1; cardNumber <= 13; cardNumber++) {
+                table[Card(cardNumber, suit).GetCardCode()] = ConvertToString(cardNumber, suit);
+            }
+        }
+        return table;
+    }();
+    static const std::string noCard = ConvertToString(0, 0);
+
+    return IsValidCardCode(code) ? names[code] : noCard;
+}
+
+// Return whether a one-byte code is one of the 52 cards: a rank of 0-12 and a suit of 0-3
+bool IsValidCardCode(unsigned char code) {
+    return (code & 0xF) < 13 && (code >> CARD_SUIT_SHIFT) < 4;
+}
+
+// Read one card from its short name, such as "Ah", "Td" or "10d"
+bool ParseCard(std::string text, Card &card) {
+    const std::string numberLetters = "A23456789TJQK";
+    const std::string suitLetters = "dhsc";
+
+    if (text.size() < 2) {
+        return false;
+    }
+
+    // "10" is accepted as well as "T", since that is how the card is written everywhere else in the game
+    std::string numberText = text.substr(0, text.size() - 1);
+    if (numberText == "10") {
+        numberText = "T";
+    }
+
+    size_t cardNumber = numberText.size() == 1 ? numberLetters.find(toupper(numberText[0])) : std::string::npos;
+    size_t suit = suitLetters.find(tolower(text.back()));
+    if (cardNumber == std::string::npos || suit == std::string::npos) {
+        return false;
+    }
+
+    card = Card(cardNumber + 1, suit + 1);
+    return true;
+}
+
+// Read any number of cards written one after another into a set of cards
+CardMask ParseCards(std::string text) {
+    CardMask cards = 0;
+    std::string cardText;
+
+    for (size_t i = 0; i < text.size(); i++) {
+        if (isspace(text[i]) || text[i] == ',') {
+            continue;
+        }
+
+        // Each card ends with its suit letter, so collect characters until one of them is found
+        cardText += text[i];
+        if (!isalpha(text[i]) || cardText.size() == 1) {
+            continue;
+        }
+
+        Card card;
+        if (!ParseCard(cardText, card)) {
+            throw std::invalid_argument("ParseCards: '" + cardText + "' is not a card");
+        }
+        if (cards & card.GetCardMask()) {
+            throw std::invalid_argument("ParseCards: " + card.GetCardString() + " is written twice");
+        }
+
+        cards |= card.GetCardMask();
+        cardText.clear();
+    }
+
+    if (!cardText.empty()) {
+        throw std::invalid_argument("ParseCards: '" + cardText + "' is not a card");
+    }
+
+    return cards;
 }
 
 // Take in the card suit number and card number and convert it to a string
@@ -60,4 +191,33 @@ std::string CombineNumberAndSuit(int cardNumber, std::string suit) {
         default:
             return std::to_string(cardNumber) + " of " + suit;
     }
+}
+
+// Return the number of cards in a set of cards
+int CountCards(CardMask cards) {
+    return __builtin_popcountll(cards);
+}
+
+// Return the 13-bit set of card numbers held in one suit of a set of cards
+unsigned int SuitRanks(CardMask cards, int suit) {
+    return (cards >> (suit * MASK_LANE_BITS)) & MASK_LANE_RANKS;
+}
+
+// Fill the array with every card in the set, from lowest card number to highest,
+// treating the Ace as card number 1 the same way the hands were always sorted
+int MaskToCards(CardMask mask, Card cards[]) {
+    int numCards = 0;
+
+    // Start with the Aces (rank 12), then go from the Deuces (rank 0) up to the Kings (rank 11)
+    for (int i = 0; i < 13; i++) {
+        int rank = (i + 12) % 13;
+        for (int suit = 0; suit < 4; suit++) {
+            if (mask & (CardMask(1) << (suit * MASK_LANE_BITS + rank))) {
+                cards[numCards] = Card::FromCode((suit << CARD_SUIT_SHIFT) | rank);
+                numCards++;
+            }
+        }
+    }
+
+    return numCards;
 }
\ No newline at end of file
@@ -3,20 +3,59 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+
+/* A set of cards stored as one bit per card. Each suit gets its own 16-bit lane
+   (Diamonds in bits 0-15, Hearts in 16-31, Spades in 32-47, Clubs in 48-63), and within a lane
+   bit 0 is the Deuce and bit 12 is the Ace, so only 52 of the 64 bits are ever used.
+   Shifting a lane down gives the card numbers held in that suit, ready for straight and flush checks.
+*/
+typedef uint64_t CardMask;
+
+const int CARD_SUIT_SHIFT = 4;
+const int MASK_LANE_BITS = 16;
+const unsigned int MASK_LANE_RANKS = 0x1FFF;
+// The code used for an empty Card, such as one made with the default constructor
+const unsigned char NO_CARD = 0xFF;
 
 // Class created for holding the card's descriptions as a pair (suit and card number)
+// Both are packed into a single byte: the suit (0-3) in the upper bits and the rank (0 for a Deuce up to 12 for an Ace)
+// in the lower 4 bits, which is also the card's bit position within a CardMask
 class Card {
     public:
         Card(int cardNumber = 0, int suit = 0);
+        static Card FromCode(unsigned char code);
         std::string GetCardString();
-        int GetCardNumber();
-        int GetCardSuit();
+        const std::string &GetCardName() const;
+        int GetCardNumber() const;
+        int GetHighCardNumber() const;
+        int GetCardSuit() const;
+        unsigned char GetCardCode() const;
+        // The set holding only this card, or an empty set (0) for an empty card made with NO_CARD
+        CardMask GetCardMask() const;
     
     private:
-        int cardNumber;
-        int suit;
+        unsigned char code;
 };
 
+// Return whether a one-byte code is one of the 52 cards (NO_CARD and damaged codes are not)
+bool IsValidCardCode(unsigned char code);
+// Return the number of cards in a set of cards
+int CountCards(CardMask cards);
+// Return the 13-bit set of card numbers held in one suit (0-3) of a set of cards
+unsigned int SuitRanks(CardMask cards, int suit);
+// Fill "cards" with every card in the set, ordered from lowest to highest card number (Aces first, as card number 1),
+// and return how many were placed. The array needs room for CountCards(mask) cards
+int MaskToCards(CardMask mask, Card cards[]);
+
+// Read one card from its short name: the card number (A, K, Q, J, T or 10, 9 ... 2) followed by the
+// first letter of the suit, such as "Ah" for the Ace of Hearts or "Td" for the 10 of Diamonds.
+// Returns false, leaving card unchanged, if the text is not a card
+bool ParseCard(std::string text, Card &card);
+// Read any number of cards written one after another, with or without spaces ("AhKs", "2c 7d 9h"), into a set of cards.
+// Throws std::invalid_argument if any part of the text is not a card or the same card is written twice
+CardMask ParseCards(std::string text);
+
 // Take the numerical value for the card "(1, 4)", and convert it to a string:
 // "Ace of clubs"
 std::string ConvertToString(int cardNumber, int suit);
@@ -2,25 +2,30 @@
 #include <string>
 #include <vector>
 #include <algorithm>
-#include <random>
-#include <chrono>
+#include <stdexcept>
 
 #include "deck.h"
 
 // Initialization of the deck with the appropriate number of cards
 Deck::Deck(int numDecks) {
+    if (numDecks < 1 || numDecks > MAX_DECKS) {
+        throw std::out_of_range("Deck: between 1 and " + std::to_string(MAX_DECKS) + " decks can be combined");
+    }
+
     // If more than one deck is being combined in this set of cards, 
     // multiply the number of decks desired by 52 cards for each deck
     this->numCards = 52 * numDecks;
     
-    // Populate the deck
-    Deck::FillDeck();
-    
-    // Make sure the deck is appropriately randomized
-    Deck::ShuffleDeck();
+    // Start the deck's generator from a seed that is different for every deck, and populate the deck
+    // A new deck is in exactly the same state as one given the same seed with SeedDeck, so GetSeed is all it takes to repeat it.
+    // The cards are picked at random as they are drawn (or shuffled with ShuffleDeck before dealing in order with DealCard)
+    Deck::SeedDeck(RandomSeed());
 }
 
+// Put every card back in the deck in order, including any taken out with RemoveCards
 void Deck::FillDeck() {
+    int position = 0;
+
     // Outer loop to handle the number of sets of 52 cards
     for (int decks = 0; decks < numCards / 52; decks++) {
         // First inner loop to handle each of the 4 suits in turn
@@ -29,37 +34,120 @@ void Deck::FillDeck() {
             for (int cards = 0; cards < 13; cards++) {
                 // Use the suit number and the card number and assign it to the Card object 
                 // (with addition so it starts at 1 as opposed to zero)
-                Card newCard = Card(cards + 1, suits + 1);
-                deck.push_back(newCard);
+                deck[position++] = Card(cards + 1, suits + 1);
             }
         }
     }
+
+    cardsInPlay = numCards;
+    nextCard = 0;
 }
 
 // Getter function for getting the human-readable string version of the card
 // "Queen of Hearts" instead of "12, 2"
 std::string Deck::GetCard() {
-    return deck.at(0).GetCardString();
+    if (nextCard >= cardsInPlay) {
+        throw std::out_of_range("Deck::GetCard: no cards are left in the deck");
+    }
+
+    return deck[nextCard].GetCardString();
 }
 
+// Restart the deck's generator from a seed and put every card back in order, so the shuffles that follow
+// can be repeated exactly by any deck seeded with the same number
+void Deck::SeedDeck(uint64_t seed) {
+    this->seed = seed;
+    generator.Seed(seed);
+    FillDeck();
+}
+
+// Return the seed the deck's generator was last started from
+uint64_t Deck::GetSeed() {
+    return seed;
+}
+
+// Put every dealt card back and shuffle the whole deck again with the deck's own generator
 void Deck::ShuffleDeck() {
-    // Make the seed assigned to the exact time it is called so each seed will be different, 
-    // thus fully randomizing the shuffle
-    unsigned seed = std::chrono::system_clock::now()
-                        .time_since_epoch()
-                        .count();
-    
-    // Use the std built-in shuffle function to shuffle with the newly created seed 
-    std::shuffle(std::begin(deck), std::end(deck), std::default_random_engine(seed));
+    ShuffleDeck(generator);
 }
 
-// For each dealing of the cards, erase the dealt card from the deck
-Card Deck::DealCard() {
-    Card temp = deck.at(0);
+// Put every dealt card back without shuffling, ready for the cards to be drawn at random with DrawCard.
+// Cards taken out with RemoveCards stay out
+void Deck::CollectCards() {
+    nextCard = 0;
+}
 
-    // Erase the top card after assigning it to a temp object
-    deck.erase(deck.begin());
+// Deal a random card from the cards not yet dealt with the deck's own generator
+Card Deck::DrawCard() {
+    return DrawCard(generator);
+}
+
+// Take every card in the given set out of the deck, for cards that are already known to be out of play
+// (such as the hole cards and board of a hand being analyzed). The removed cards are swapped to the end of the array,
+// where they stay out of play through any number of shuffles until FillDeck is called
+void Deck::RemoveCards(CardMask cards) {
+    for (int i = 0; i < cardsInPlay; i++) {
+        if (cards & deck[i].GetCardMask()) {
+            std::swap(deck[i], deck[cardsInPlay - 1]);
+            cardsInPlay--;
+            i--;
+        }
+    }
+
+    // The swaps may have moved cards around the cursor, so start dealing from the top again
+    nextCard = 0;
+}
+
+// Return how many cards have not been dealt yet
+int Deck::CardsLeft() {
+    return cardsInPlay - nextCard;
+}
+
+// For each dealing of the cards, hand out the card at the cursor and move the cursor to the next card
+Card Deck::DealCard() {
+    if (nextCard >= cardsInPlay) {
+        throw std::out_of_range("Deck::DealCard: no cards are left in the deck");
+    }
 
     // Return the dealt card so that it can be assigned to the appropriate hand
-    return temp;
+    return deck[nextCard++];
+}
+
+// Copy the order of every card, where dealing has got to and the generator's state into a snapshot
+void Deck::SaveSnapshot(DeckSnapshot &snapshot) const {
+    generator.GetState(snapshot.generatorState);
+    snapshot.seed = seed;
+    snapshot.numCards = numCards;
+    snapshot.cardsInPlay = cardsInPlay;
+    snapshot.nextCard = nextCard;
+    for (int i = 0; i < numCards; i++) {
+        snapshot.cardCodes[i] = deck[i].GetCardCode();
+    }
+}
+
+// Check the counts, the cursor and every card code in a deck snapshot
+void Deck::CheckSnapshot(const DeckSnapshot &snapshot) {
+    if (snapshot.numCards < 52 || snapshot.numCards > MAX_DECK_CARDS || snapshot.numCards % 52 != 0 || snapshot.cardsInPlay < 0 ||
+        snapshot.cardsInPlay > snapshot.numCards || snapshot.nextCard < 0 || snapshot.nextCard > snapshot.cardsInPlay) {
+        throw std::invalid_argument("Deck::CheckSnapshot: the snapshot is not of a deck");
+    }
+    for (int i = 0; i < snapshot.numCards; i++) {
+        if (!IsValidCardCode(snapshot.cardCodes[i])) {
+            throw std::invalid_argument("Deck::CheckSnapshot: the snapshot has a card code that is not a card");
+        }
+    }
+}
+
+// Put the deck back exactly as a snapshot has it. Throws std::invalid_argument if the snapshot could not have come from a deck
+void Deck::RestoreSnapshot(const DeckSnapshot &snapshot) {
+    CheckSnapshot(snapshot);
+
+    generator.SetState(snapshot.generatorState);
+    seed = snapshot.seed;
+    numCards = snapshot.numCards;
+    cardsInPlay = snapshot.cardsInPlay;
+    nextCard = snapshot.nextCard;
+    for (int i = 0; i < numCards; i++) {
+        deck[i] = Card::FromCode(snapshot.cardCodes[i]);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#include "equity.h"
+#include "deck.h"
+#include "hand_evaluator.h"
+#include "thread_pool.h"
+#include "random_generator.h"
+
+// Start a tally with no boards counted
+EquityTally::EquityTally(int numPlayers) {
+    boards = 0;
+    wins.assign(numPlayers, 0);
+    ties.assign(numPlayers, 0);
+    shares.assign(numPlayers, 0);
+    shareSquares.assign(numPlayers, 0);
+}
+
+// Evaluate every player's hand on a finished board and add the outcome to the tally "count" times
+// (more than once when the same board stands for several boards that are known to play out identically)
+void EquityTally::AddBoard(const EquitySpot &spot, CardMask board, long count) {
+    unsigned int handKeys[MAX_EQUITY_PLAYERS];
+    unsigned int bestKey = 0;
+    int numWinners = 0;
+
+    // Find the best hand key, and how many players share it
+    for (size_t i = 0; i < spot.holeCards.size(); i++) {
+        handKeys[i] = EvaluateHand(spot.holeCards[i] | board);
+        if (handKeys[i] > bestKey) {
+            bestKey = handKeys[i];
+            numWinners = 1;
+        }
+        else if (handKeys[i] == bestKey) {
+            numWinners++;
+        }
+    }
+
+    // Give each winner their share of the pot
+    double share = 1.0 / numWinners;
+    for (size_t i = 0; i < spot.holeCards.size(); i++) {
+        if (handKeys[i] != bestKey) {
+            continue;
+        }
+
+        if (numWinners == 1) {
+            wins[i] += count;
+        }
+        else {
+            ties[i] += count;
+        }
+        shares[i] += share * count;
+        shareSquares[i] += share * share * count;
+    }
+
+    boards += count;
+}
+
+// Add another tally's totals to this one
+void EquityTally::Merge(const EquityTally &other) {
+    boards += other.boards;
+
+    for (size_t i = 0; i < wins.size(); i++) {
+        wins[i] += other.wins[i];
+        ties[i] += other.ties[i];
+        shares[i] += other.shares[i];
+        shareSquares[i] += other.shareSquares[i];
+    }
+}
+
+// Turn the totals into fractions for each player, given how long the calculation took
+EquityResult EquityTally::GetResult(double seconds) {
+    EquityResult result;
+    result.boards = boards;
+    result.seconds = seconds;
+    result.handsPerSecond = seconds > 0 ? boards * wins.size() / seconds : 0;
+
+    for (size_t i = 0; i < wins.size(); i++) {
+        PlayerEquity player;
+
+        if (boards > 0) {
+            player.win = (double) wins[i] / boards;
+            player.tie = (double) ties[i] / boards;
+            player.equity = shares[i] / boards;
+            // The variance of a single board's share, divided by the number of boards
+            double variance = shareSquares[i] / boards - player.equity * player.equity;
+            player.standardError = variance > 0 ? std::sqrt(variance / boards) : 0;
+        }
+
+        result.players.push_back(player);
+    }
+
+    return result;
+}
+
+// Return every card that is already known in a spot
+CardMask KnownCards(const EquitySpot &spot) {
+    CardMask known = spot.board | spot.deadCards;
+
+    for (CardMask hole : spot.holeCards) {
+        known |= hole;
+    }
+
+    return known;
+}
+
+// Check that a spot can be analyzed, throwing std::invalid_argument if it cannot
+void CheckEquitySpot(const EquitySpot &spot) {
+    int numPlayers = spot.holeCards.size();
+    if (numPlayers < MIN_EQUITY_PLAYERS || numPlayers > MAX_EQUITY_PLAYERS) {
+        throw std::invalid_argument("CheckEquitySpot: " + std::to_string(numPlayers) + " players given, between " +
+                                    std::to_string(MIN_EQUITY_PLAYERS) + " and " + std::to_string(MAX_EQUITY_PLAYERS) + " are needed");
+    }
+
+    // Add up the cards one group at a time, so any card used twice is caught
+    CardMask known = 0;
+    int numKnown = 0;
+    for (int i = 0; i < numPlayers; i++) {
+        if (CountCards(spot.holeCards[i]) != 2) {
+            throw std::invalid_argument("CheckEquitySpot: player " + std::to_string(i + 1) + " needs exactly 2 hole cards");
+        }
+        known |= spot.holeCards[i];
+        numKnown += 2;
+    }
+
+    if (CountCards(spot.board) > BOARD_SIZE) {
+        throw std::invalid_argument("CheckEquitySpot: the board has more than " + std::to_string(BOARD_SIZE) + " cards");
+    }
+    known |= spot.board | spot.deadCards;
+    numKnown += CountCards(spot.board) + CountCards(spot.deadCards);
+
+    if (CountCards(known) != numKnown) {
+        throw std::invalid_argument("CheckEquitySpot: the same card is used more than once");
+    }
+    if (52 - numKnown < BOARD_SIZE - CountCards(spot.board)) {
+        throw std::invalid_argument("CheckEquitySpot: not enough cards are left to finish the board");
+    }
+}
+
+// The number of boards in each block of a Monte Carlo run. Every block gets its own stream of random numbers,
+// so the boards dealt depend only on the seed and never on which thread deals them
+static const long BOARDS_PER_BLOCK = 65536;
+
+// Deal every "numThreads"th block of boards starting from block "threadIndex", adding each block to its own tally.
+// Block b always uses the seed's generator jumped ahead b times, and starts from the deck in its starting order
+static void RunMonteCarloBlocks(const EquitySpot &spot, long numBoards, uint64_t seed, int threadIndex, int numThreads,
+                                std::vector<EquityTally> &blockTallies) {
+    int cardsNeeded = BOARD_SIZE - CountCards(spot.board);
+    CardMask known = KnownCards(spot);
+    Deck deck;
+
+    Xoshiro256 blockStart(seed);
+    for (int i = 0; i < threadIndex; i++) {
+        blockStart.Jump();
+    }
+
+    for (size_t block = threadIndex; block < blockTallies.size(); block += numThreads) {
+        Xoshiro256 generator = blockStart;
+        long blockBoards = std::min(BOARDS_PER_BLOCK, numBoards - (long) block * BOARDS_PER_BLOCK);
+
+        // Put the deck back in order so the shuffles do not depend on the blocks this thread dealt before
+        deck.FillDeck();
+        deck.RemoveCards(known);
+
+        // Only the board cards still to come are drawn at random, rather than shuffling every card left
+        for (long i = 0; i < blockBoards; i++) {
+            deck.CollectCards();
+
+            CardMask board = spot.board;
+            for (int card = 0; card < cardsNeeded; card++) {
+                board |= deck.DrawCard(generator).GetCardMask();
+            }
+
+            blockTallies[block].AddBoard(spot, board);
+        }
+
+        // Skip over the streams of the blocks the other threads are dealing
+        for (int i = 0; i < numThreads; i++) {
+            blockStart.Jump();
+        }
+    }
+}
+
+// Estimate each player's equity by dealing random boards over several threads
+EquityResult CalculateEquityMonteCarlo(const EquitySpot &spot, long numBoards, int numThreads, uint64_t seed) {
+    CheckEquitySpot(spot);
+
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    int numPlayers = spot.holeCards.size();
+    long numBlocks = (numBoards + BOARDS_PER_BLOCK - 1) / BOARDS_PER_BLOCK;
+    std::vector<EquityTally> blockTallies(numBlocks, EquityTally(numPlayers));
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back(RunMonteCarloBlocks, std::cref(spot), numBoards, seed, i, numThreads, std::ref(blockTallies));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    // Add the blocks up in order, so even the rounding of the totals is the same with any number of threads
+    EquityTally total(numPlayers);
+    for (const EquityTally &tally : blockTallies) {
+        total.Merge(tally);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EquityResult result = total.GetResult(elapsed.count());
+    result.seed = seed;
+    return result;
+}
+
+// Add every board that completes "board" with "cardsLeft" more cards taken from cards[start] onwards
+static void EnumerateBoards(const EquitySpot &spot, const std::vector<CardMask> &cards, size_t start, int cardsLeft,
+                            CardMask board, EquityTally &tally) {
+    if (cardsLeft == 0) {
+        tally.AddBoard(spot, board);
+        return;
+    }
+
+    // Stop early enough that there are always enough cards after this one to finish the board
+    for (size_t i = start; i + cardsLeft <= cards.size(); i++) {
+        EnumerateBoards(spot, cards, i + 1, cardsLeft - 1, board | cards[i], tally);
+    }
+}
+
+// Work out each player's exact equity by dealing every possible board, as tasks on the given thread pool
+EquityResult CalculateEquityExact(const EquitySpot &spot, ThreadPool &pool) {
+    CheckEquitySpot(spot);
+
+    int numPlayers = spot.holeCards.size();
+    int cardsNeeded = BOARD_SIZE - CountCards(spot.board);
+
+    // The cards still to come, one mask per card
+    std::vector<CardMask> cards;
+    CardMask known = KnownCards(spot);
+    for (int suit = 0; suit < 4; suit++) {
+        for (int rank = 0; rank < 13; rank++) {
+            CardMask mask = (CardMask) 1 << (suit * 16 + rank);
+            if (!(known & mask)) {
+                cards.push_back(mask);
+            }
+        }
+    }
+
+    // One tally per worker, so tasks running on the same thread can add to it without locking
+    std::vector<EquityTally> tallies(pool.GetNumThreads(), EquityTally(numPlayers));
+
+    auto start = std::chrono::steady_clock::now();
+    if (cardsNeeded < 2) {
+        // With at most one card to come there are too few boards to be worth splitting up
+        EnumerateBoards(spot, cards, 0, cardsNeeded, spot.board, tallies.at(0));
+    }
+    else {
+        // One task per choice of the board's two lowest new cards. The chunks shrink as those cards get higher,
+        // which is exactly the kind of uneven work that stealing evens out
+        for (size_t first = 0; first + cardsNeeded <= cards.size(); first++) {
+            for (size_t second = first + 1; second + cardsNeeded - 1 <= cards.size(); second++) {
+                pool.Submit([&spot, &cards, &tallies, &pool, first, second, cardsNeeded] {
+                    EnumerateBoards(spot, cards, second + 1, cardsNeeded - 2, spot.board | cards[first] | cards[second],
+                                    tallies.at(pool.CurrentWorker()));
+                });
+            }
+        }
+        pool.Wait();
+    }
+
+    EquityTally total(numPlayers);
+    for (const EquityTally &tally : tallies) {
+        total.Merge(tally);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Every board was counted, so the answer is exact rather than an estimate
+    EquityResult result = total.GetResult(elapsed.count());
+    for (PlayerEquity &player : result.players) {
+        player.standardError = 0;
+    }
+
+    return result;
+}
+
+// Work out each player's exact equity on a thread pool made just for this calculation
+EquityResult CalculateEquityExact(const EquitySpot &spot, int numThreads) {
+    ThreadPool pool(numThreads);
+    return CalculateEquityExact(spot, pool);
+}
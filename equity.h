@@ -0,0 +1,95 @@
+#ifndef EQUITY_H
+#define EQUITY_H
+
+#include <vector>
+
+#include "card.h"
+#include "random_generator.h"
+
+class ThreadPool;
+
+// The number of players an equity calculation can compare, and the number of community cards on a full board
+const int MIN_EQUITY_PLAYERS = 2;
+const int MAX_EQUITY_PLAYERS = 10;
+const int BOARD_SIZE = 5;
+
+/* The cards known in a hand being analyzed: the two hole cards of each player, any community cards
+   already dealt, and any cards known to be out of play (folded or burned cards that were seen).
+   The rest of the board is dealt from whatever cards are left.
+*/
+struct EquitySpot {
+    std::vector<CardMask> holeCards;
+    CardMask board = 0;
+    CardMask deadCards = 0;
+};
+
+// How one player fared over every board dealt. Each value is a fraction between 0 and 1
+struct PlayerEquity {
+    // The share of boards won outright
+    double win = 0;
+    // The share of boards where the pot was split with at least one other player
+    double tie = 0;
+    // The average share of the pot won: 1 for each win and 1/n for each n-way split
+    double equity = 0;
+    // The standard error of the equity, showing how far it could be from the exact answer (0 when every board was dealt)
+    double standardError = 0;
+};
+
+// The result of an equity calculation, along with how quickly it ran
+struct EquityResult {
+    std::vector<PlayerEquity> players;
+    long boards = 0;
+    double seconds = 0;
+    // Each board evaluates one hand per player, so this is boards per second times the number of players
+    double handsPerSecond = 0;
+    // The seed a Monte Carlo calculation used, so it can be run again with exactly the same boards (0 for exact results)
+    uint64_t seed = 0;
+};
+
+/* Running totals for an equity calculation. Each block of boards (or each worker thread) keeps its own tally
+   while boards are dealt, and the tallies are added together once every thread is done.
+*/
+class EquityTally {
+    public:
+        EquityTally(int numPlayers = 0);
+        void AddBoard(const EquitySpot &spot, CardMask board, long count = 1);
+        void Merge(const EquityTally &other);
+        EquityResult GetResult(double seconds);
+
+    private:
+        long boards;
+        std::vector<long> wins;
+        std::vector<long> ties;
+        // The sum of each player's pot shares, and of their squares for the standard error
+        std::vector<double> shares;
+        std::vector<double> shareSquares;
+};
+
+// Check that a spot can be analyzed: 2-10 players with exactly 2 hole cards each, a board of at most 5 cards,
+// and no card used twice. Throws std::invalid_argument describing the problem otherwise
+void CheckEquitySpot(const EquitySpot &spot);
+// Return every card that is already known in a spot: the hole cards, the board and the dead cards
+CardMask KnownCards(const EquitySpot &spot);
+
+/* Estimate each player's equity by dealing "numBoards" random completions of the board over "numThreads" threads
+   (0 uses one thread per core). The boards are dealt in fixed-size blocks, and each block gets its own stream of
+   random numbers by jumping the seed's Xoshiro256 generator ahead once per block. The threads share out the blocks and
+   share nothing else, and the block tallies are added up in order at the end, so the same seed gives exactly the same
+   result with any number of threads. Without a seed a new random one is used, and either way it is returned in the result.
+   Throws std::invalid_argument if the spot cannot be analyzed.
+*/
+EquityResult CalculateEquityMonteCarlo(const EquitySpot &spot, long numBoards, int numThreads = 0, uint64_t seed = RandomSeed());
+
+/* Work out each player's exact equity by dealing every possible completion of the board
+   (1,712,304 boards for two players before the flop). The boards are split into chunks by their first
+   two cards, and the chunks are run as tasks on "pool" so idle threads steal work from busy ones.
+   Passing the same pool to many calls avoids starting new threads each time, for example when building a table
+   of matchups. The call waits until the pool has no tasks left at all, so calls sharing one pool from several threads
+   wait for each other's boards too, and it must not be called from a task running on the same pool (a task on another pool is fine).
+   The second version makes a pool of "numThreads" threads (0 uses one thread per core) just for this call.
+   Throws std::invalid_argument if the spot cannot be analyzed.
+*/
+EquityResult CalculateEquityExact(const EquitySpot &spot, ThreadPool &pool);
+EquityResult CalculateEquityExact(const EquitySpot &spot, int numThreads = 0);
+
+#endif
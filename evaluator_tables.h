@@ -0,0 +1,47 @@
+#ifndef EVALUATOR_TABLES_H
+#define EVALUATOR_TABLES_H
+
+// The lookup tables shared by the scalar and batch hand evaluators.
+// Only the evaluator source files include this; everything else goes through hand_evaluator.h
+
+// Number of distinct card numbers, and the fewest and most cards evaluated at a time
+const int NUM_RANKS = 13;
+const int NUM_SUITS = 4;
+const int MIN_HAND_SIZE = 5;
+const int HAND_SIZE = 7;
+// The number of 13-bit sets of card numbers
+const int NUM_RANK_MASKS = 1 << NUM_RANKS;
+// The number of ways to hold 7, 6 or 5 cards when only the card numbers matter
+// (13 numbers, each held between 0 and 4 times): 49205 + 18395 + 6175
+const int NUM_RANK_PATTERNS = 73775;
+
+/* All the lookup tables used by EvaluateHand. Every table is worked out by the compiler (the constructor is constexpr),
+   so the finished tables are part of the program file itself: there is nothing to build when the program starts,
+   and every process running the program shares the same read-only copy.
+*/
+struct EvaluatorTables {
+    // The number of card numbers in every 13-bit set of card numbers
+    unsigned char rankCounts[NUM_RANK_MASKS] = {};
+    // The top card number (5-14) of the highest straight in every 13-bit set of card numbers, or 0 if there is none
+    unsigned char straightHighs[NUM_RANK_MASKS] = {};
+    // The five highest card numbers in every 13-bit set of card numbers, packed highest first into the
+    // five value fields of a hand key, so picking the kickers of a hand is a single lookup
+    unsigned int highCards[NUM_RANK_MASKS] = {};
+    // hashOffsets[rank][cardsLeft][count] is how far the perfect hash moves when "count" cards
+    // of this rank are found while "cardsLeft" cards have not been hashed yet
+    unsigned int hashOffsets[NUM_RANKS][HAND_SIZE + 1][5] = {};
+    // The best hand key for every 13-bit set of card numbers found within one suit
+    unsigned int flushKeys[NUM_RANK_MASKS] = {};
+    // The best hand key for every pattern of card numbers, indexed by the perfect hash.
+    // The 7-card patterns come first (so a 7-card hash is used as is), followed by the 6-card and 5-card patterns
+    unsigned int rankKeys[NUM_RANK_PATTERNS] = {};
+    // Where the patterns for each number of cards start within rankKeys
+    unsigned int rankKeyStart[HAND_SIZE + 1] = {};
+
+    constexpr EvaluatorTables();
+};
+
+// Return the tables worked out when the program was compiled
+const EvaluatorTables &GetEvaluatorTables();
+
+#endif
@@ -0,0 +1,103 @@
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "round.h"
+
+// Create a player for each name, in seat order, with startingChips each, and mark the last player as the dealer
+// so that when the dealer changes at the beginning of the first round, the new dealer will become the player at the 0 index
+void SeatPlayers(std::vector<Player> &players, const std::vector<std::string> &names, int startingChips) {
+    for (size_t i = 0; i < names.size(); i++) {
+        players.push_back(Player(names.at(i), startingChips));
+    }
+
+    players.at(players.size() - 1).FlipDealerStat();
+}
+
+// Return a boolean value for whether the size of the players vector is greater than 1
+bool noWinner(std::vector<Player> &players) {
+    return players.size() > 1;
+}
+
+// A function that takes in the current round of the game (based on number of hands played), the players vector,
+// the table's deck and whoever makes the players' decisions, and runs through an entire round of gameplay,
+// changing the players vector in place
+void PlayRound(std::vector<Player> &players, int roundNumber, Deck &tableDeck, ActionProvider &actions, bool exportStats,
+               Blinds blinds, HandHistoryGame history) {
+    Round currentRound(players, tableDeck, actions, exportStats, blinds, history);
+    std::vector<int> cardAmounts = {3, 1, 1};
+    bool winnerByFolding = false;
+
+    // Then call the AssignDealer function, changing the dealer to the "next" player
+    // which is 1 higher in the players vector, going back to 0 once the end of the vector is reached
+    currentRound.AssignDealer();
+    // Then using the dealer's placement, collect the small and big blinds from the players to the "left"
+    // or 1 and 2 higher in the players vector, respectively
+    currentRound.CollectAnte();
+    // Then deal cards to every player in the players vector
+    currentRound.DealCards();
+    // Then run through a betting phase, asking for each player's decision and altering the totalBet and chip total of all players 
+    // who have not folded
+    currentRound.PlaceBet(roundNumber);
+    // Then deal cards to the community hand and follow it with betting until all the community cards are dealt
+    // or everyone but one player has folded
+    for (size_t i = 0; i < cardAmounts.size(); i++) {
+        // If everyone but 1 player has folded, mark winnerByFolding as true
+        // and break out of the loop as no more cards are needed to be dealt
+        if (currentRound.CountFolded() == players.size() - 1) {
+            winnerByFolding = true;
+            break;
+        }
+
+        currentRound.DealCommunityCards(cardAmounts.at(i));
+
+        // If everyone has NOT either gone all in or folded, then run another betting round,
+        // Otherwise skip this step and deal the rest of the cards
+        if (currentRound.CountAllInAndFolded() < players.size() - 1) {
+            currentRound.PlaceBet();
+        }
+        // If everyone but 1 player has folded, mark winnerByFolding as true
+        // and break out of the loop as no more cards are needed to be dealt
+        if (currentRound.CountFolded() == players.size() - 1) {
+            winnerByFolding = true;
+            break;
+        }
+    }
+    // If more than one player has not folded
+    if (!winnerByFolding) {
+        // Then calculate the hand key of each player's hand who is still currently not folded
+        currentRound.ScoreHands();
+    }
+    
+    // Then use those calculated stats, or the winnerByFolding boolean, to divide up the winnings of the hand appropriately
+    // DivvyPots also resets the players' hands and removes players who have run out of chips, straight from the players vector
+    currentRound.DivvyPots(roundNumber, winnerByFolding);
+}
+
+// Play rounds with the same table until one player has won every chip, or until maxRounds rounds have been played
+// (0 means no limit), and return the number of rounds played (counting any played before the snapshot a game was carried on from).
+// Every round is played with the same blinds and, if there is a hand history writer, recorded as part of one game
+int PlayGame(std::vector<Player> &players, Deck &tableDeck, ActionProvider &actions, int maxRounds, bool exportStats, Blinds blinds,
+             HandHistoryWriter *history, int roundsPlayed, const std::function<void(int)> &afterRound) {
+    int roundNumber = roundsPlayed;
+
+    // The deck is in the state its seed gives it only until the first card is drawn, so the game is given its id (and its seed is written) now
+    HandHistoryGame game;
+    if (history) {
+        game.writer = history;
+        game.gameId = history->StartGame(tableDeck.GetSeed());
+    }
+
+    // While there is more than 1 player in the players vector
+    while (noWinner(players) && (maxRounds == 0 || roundNumber < maxRounds)) {
+        // Increment the start of a new round and then run the PlayRound function
+        roundNumber++;
+        PlayRound(players, roundNumber, tableDeck, actions, exportStats, blinds, game);
+
+        if (afterRound) {
+            afterRound(roundNumber);
+        }
+    }
+
+    return roundNumber;
+}
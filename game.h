@@ -0,0 +1,38 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include "player.h"
+#include "deck.h"
+#include "action.h"
+#include "round.h"
+
+// A function that takes in an empty players vector and seats a new player for each name, in order, each with startingChips,
+// marking the last one as the dealer so the player at the 0 index deals the first round
+void SeatPlayers(std::vector<Player> &players, const std::vector<std::string> &names, int startingChips = STARTING_CHIPS);
+// A function to return if there is still no winner based on the size of the players vector
+bool noWinner(std::vector<Player> &players);
+/* A function that takes in the current round of the game (based on number of hands played), the players vector,
+   the table's deck and whoever makes the players' decisions, and runs through an entire round of gameplay,
+   changing the players vector in place. If exportStats is false, the round's results are not written to the txt file.
+   The blinds are 1 and 2 chips unless others are given, and the round is written to the hand history file if history has a writer
+*/
+void PlayRound(std::vector<Player> &players, int roundNumber, Deck &tableDeck, ActionProvider &actions, bool exportStats = true,
+               Blinds blinds = Blinds(), HandHistoryGame history = HandHistoryGame());
+/* A function that plays rounds with the same players and deck until noWinner fails, or until maxRounds rounds
+   have been played (0 for no limit), and returns how many rounds were played. It does no console input or output
+   of its own, so with an ActionProvider that does not show the table a whole game runs without touching the console.
+   If a HandHistoryWriter is given, the game and every round played are written to its hand history file, starting with the
+   seed the deck is in at the start of the game, so the game can be dealt again card for card.
+   A game carried on from a snapshot (see snapshot.h) is given the number of rounds it had already played as roundsPlayed, and
+   the round numbers (and maxRounds) carry on from there. Such a game should not be written to a hand history file, as its deck
+   is no longer in the state its seed gives. If afterRound is given, it is called with the round number after every round played
+*/
+int PlayGame(std::vector<Player> &players, Deck &tableDeck, ActionProvider &actions, int maxRounds = 0, bool exportStats = true,
+             Blinds blinds = Blinds(), HandHistoryWriter *history = nullptr, int roundsPlayed = 0,
+             const std::function<void(int)> &afterRound = nullptr);
+
+#endif
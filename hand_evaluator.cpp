@@ -0,0 +1,346 @@
+#include "hand_evaluator.h"
+#include "evaluator_tables.h"
+
+// Build a hand key out of the hand type and up to five deciding card numbers
+unsigned int MakeHandKey(int category, const int values[5]) {
+    unsigned int handKey = category << HAND_KEY_CATEGORY_SHIFT;
+
+    for (int i = 0; i < 5; i++) {
+        handKey |= values[i] << (HAND_KEY_VALUE_BITS * (4 - i));
+    }
+
+    return handKey;
+}
+
+// Read the type of hand out of a hand key
+int HandKeyCategory(unsigned int handKey) {
+    return handKey >> HAND_KEY_CATEGORY_SHIFT;
+}
+
+// Read one of the five deciding card numbers out of a hand key
+// Position 1 is the most important number, just like handStats.at(1)
+int HandKeyValue(unsigned int handKey, int position) {
+    return (handKey >> (HAND_KEY_VALUE_BITS * (5 - position))) & 0xF;
+}
+
+// Return the card number (2-14) of the highest straight found in a 13-bit set of card numbers,
+// or 0 if there is no straight. Bit 0 is the Deuce and bit 12 is the Ace
+static constexpr int FindStraightHigh(unsigned int rankMask) {
+    // Shift everything up one place and copy the Ace into the bottom place,
+    // so that the Ace can also be used as the low card of A, 2, 3, 4, 5
+    unsigned int extended = (rankMask << 1) | ((rankMask >> 12) & 1);
+    // A bit survives only if it and the four bits above it are all present
+    unsigned int runs = extended & (extended >> 1) & (extended >> 2) & (extended >> 3) & (extended >> 4);
+
+    // Find the highest surviving bit; the straight's top card sits four places above it
+    for (int lowestPlace = NUM_RANKS - 4; lowestPlace >= 0; lowestPlace--) {
+        if (runs & (1u << lowestPlace)) {
+            return lowestPlace + 5;
+        }
+    }
+
+    return 0;
+}
+
+// Pack up to five of the highest card numbers in rankMask into the value fields of a hand key, highest first
+static constexpr unsigned int FindHighCards(unsigned int rankMask) {
+    unsigned int highCards = 0;
+    int field = 4;
+
+    for (int rank = NUM_RANKS - 1; rank >= 0 && field >= 0; rank--) {
+        if (rankMask & (1u << rank)) {
+            highCards |= (rank + 2) << (HAND_KEY_VALUE_BITS * field);
+            field--;
+        }
+    }
+
+    return highCards;
+}
+
+// Return the "count" highest card numbers in rankMask, already shifted into the value fields of a hand key
+// starting at "position" (1-5, the same numbering as HandKeyValue). Fields past the end of the set are 0
+static constexpr unsigned int HighCardFields(const EvaluatorTables &tables, unsigned int rankMask, int count, int position) {
+    unsigned int fieldMask = ((1u << (HAND_KEY_VALUE_BITS * count)) - 1) << (HAND_KEY_VALUE_BITS * (6 - count - position));
+
+    return (tables.highCards[rankMask] >> (HAND_KEY_VALUE_BITS * (position - 1))) & fieldMask;
+}
+
+// Work out the hand key of a set of card numbers that is all of one suit
+static constexpr unsigned int KeyForFlush(const EvaluatorTables &tables, unsigned int rankMask) {
+    unsigned int straightHigh = tables.straightHighs[rankMask];
+
+    // A straight flush with the Ace on top is a Royal flush
+    if (straightHigh == 14) {
+        return (10u << HAND_KEY_CATEGORY_SHIFT) | (14u << (HAND_KEY_VALUE_BITS * 4));
+    }
+    else if (straightHigh) {
+        return (9u << HAND_KEY_CATEGORY_SHIFT) | (straightHigh << (HAND_KEY_VALUE_BITS * 4));
+    }
+
+    return (6u << HAND_KEY_CATEGORY_SHIFT) | HighCardFields(tables, rankMask, 5, 1);
+}
+
+// Work out the hand key when only the count of each card number matters (no flush is possible).
+// The sets hold the card numbers found at least once, exactly twice, exactly three times and four times
+static constexpr unsigned int KeyForRankSets(const EvaluatorTables &tables, unsigned int present, unsigned int pairs, unsigned int trips, unsigned int quads) {
+    // Four-of-a-kind, with the highest other card as the kicker
+    if (quads) {
+        return (8u << HAND_KEY_CATEGORY_SHIFT) | HighCardFields(tables, quads, 1, 1) | HighCardFields(tables, present & ~quads, 1, 2);
+    }
+
+    // Full house, using the higher of a second three-of-a-kind or the highest pair as the pair
+    unsigned int topTrips = tables.highCards[trips] >> (HAND_KEY_VALUE_BITS * 4);
+    unsigned int secondTrips = (tables.highCards[trips] >> (HAND_KEY_VALUE_BITS * 3)) & 0xF;
+    unsigned int topPair = tables.highCards[pairs] >> (HAND_KEY_VALUE_BITS * 4);
+    if (topTrips && (secondTrips || topPair)) {
+        unsigned int pairValue = secondTrips > topPair ? secondTrips : topPair;
+        return (7u << HAND_KEY_CATEGORY_SHIFT) | (topTrips << (HAND_KEY_VALUE_BITS * 4)) | (pairValue << (HAND_KEY_VALUE_BITS * 3));
+    }
+
+    unsigned int straightHigh = tables.straightHighs[present];
+    if (straightHigh) {
+        return (5u << HAND_KEY_CATEGORY_SHIFT) | (straightHigh << (HAND_KEY_VALUE_BITS * 4));
+    }
+
+    if (trips) {
+        return (4u << HAND_KEY_CATEGORY_SHIFT) | HighCardFields(tables, trips, 1, 1) | HighCardFields(tables, present & ~trips, 2, 2);
+    }
+
+    // Two pair, where a third pair can still be used as the kicker
+    unsigned int thirdPair = (tables.highCards[pairs] >> (HAND_KEY_VALUE_BITS * 2)) & 0xF;
+    if (thirdPair) {
+        pairs &= ~(1u << (thirdPair - 2));
+    }
+    if (tables.rankCounts[pairs] >= 2) {
+        return (3u << HAND_KEY_CATEGORY_SHIFT) | HighCardFields(tables, pairs, 2, 1) | HighCardFields(tables, present & ~pairs, 1, 3);
+    }
+
+    if (pairs) {
+        return (2u << HAND_KEY_CATEGORY_SHIFT) | HighCardFields(tables, pairs, 1, 1) | HighCardFields(tables, present & ~pairs, 3, 2);
+    }
+
+    return (1u << HAND_KEY_CATEGORY_SHIFT) | HighCardFields(tables, present, 5, 1);
+}
+
+// Turn the count of each card number into its position in the rank table.
+// Patterns with the same number of cards are numbered in order, so each one gets its own slot with no gaps
+static constexpr unsigned int HashRankCounts(const EvaluatorTables &tables, const unsigned char counts[NUM_RANKS], int numCards) {
+    unsigned int index = tables.rankKeyStart[numCards];
+    int cardsLeft = numCards;
+
+    for (int rank = 0; rank < NUM_RANKS && cardsLeft > 0; rank++) {
+        index += tables.hashOffsets[rank][cardsLeft][counts[rank]];
+        cardsLeft -= counts[rank];
+    }
+
+    return index;
+}
+
+// Look up the rank table for a hand whose card number counts are spread over three bit planes:
+// bit "rank" of ones, twos and fours together make up the count of that card number
+static unsigned int LookupRankKey(const EvaluatorTables &tables, unsigned int ones, unsigned int twos, unsigned int fours, int numCards) {
+    unsigned char counts[NUM_RANKS];
+
+    for (int rank = 0; rank < NUM_RANKS; rank++) {
+        counts[rank] = ((ones >> rank) & 1) | (((twos >> rank) & 1) << 1) | (((fours >> rank) & 1) << 2);
+    }
+
+    return tables.rankKeys[HashRankCounts(tables, counts, numCards)];
+}
+
+// Recursively place between 0 and 4 cards of each card number, from the Deuce up, until all of the hand's cards are placed,
+// storing the hand key of every finished pattern at "nextIndex". Patterns are reached in exactly the order HashRankCounts
+// numbers them, so the rank table fills from front to back without hashing anything
+static constexpr void FillRankKeys(EvaluatorTables &tables, unsigned int &nextIndex, int rank, int cardsLeft,
+                                   unsigned int present, unsigned int pairs, unsigned int trips, unsigned int quads) {
+    // Once every card is placed, the remaining card numbers can only be held 0 times
+    if (cardsLeft == 0) {
+        tables.rankKeys[nextIndex++] = KeyForRankSets(tables, present, pairs, trips, quads);
+        return;
+    }
+    // Skip any start that cannot place all of its cards in the card numbers left
+    if (cardsLeft > 4 * (NUM_RANKS - rank)) {
+        return;
+    }
+
+    unsigned int rankBit = 1u << rank;
+    FillRankKeys(tables, nextIndex, rank + 1, cardsLeft, present, pairs, trips, quads);
+    FillRankKeys(tables, nextIndex, rank + 1, cardsLeft - 1, present | rankBit, pairs, trips, quads);
+    if (cardsLeft >= 2) {
+        FillRankKeys(tables, nextIndex, rank + 1, cardsLeft - 2, present | rankBit, pairs | rankBit, trips, quads);
+    }
+    if (cardsLeft >= 3) {
+        FillRankKeys(tables, nextIndex, rank + 1, cardsLeft - 3, present | rankBit, pairs, trips | rankBit, quads);
+    }
+    if (cardsLeft >= 4) {
+        FillRankKeys(tables, nextIndex, rank + 1, cardsLeft - 4, present | rankBit, pairs, trips, quads | rankBit);
+    }
+}
+
+// Work out all of the lookup tables. This only ever runs inside the compiler, for EVALUATOR_TABLES below
+constexpr EvaluatorTables::EvaluatorTables() {
+    // The small per-set tables come first, since the hand keys below are worked out with them
+    for (unsigned int rankMask = 0; rankMask < NUM_RANK_MASKS; rankMask++) {
+        rankCounts[rankMask] = rankMask ? rankCounts[rankMask & (rankMask - 1)] + 1 : 0;
+        straightHighs[rankMask] = FindStraightHigh(rankMask);
+        highCards[rankMask] = FindHighCards(rankMask);
+    }
+
+    // patterns[places][cards] is the number of ways to spread "cards" cards over "places" card numbers
+    // with at most 4 of each
+    unsigned int patterns[NUM_RANKS + 1][HAND_SIZE + 1] = {};
+    patterns[0][0] = 1;
+    for (int places = 1; places <= NUM_RANKS; places++) {
+        for (int cards = 0; cards <= HAND_SIZE; cards++) {
+            for (int count = 0; count <= 4 && count <= cards; count++) {
+                patterns[places][cards] += patterns[places - 1][cards - count];
+            }
+        }
+    }
+
+    // Holding "count" cards of a rank skips past every pattern that held fewer of that rank
+    for (int rank = 0; rank < NUM_RANKS; rank++) {
+        int placesAfter = NUM_RANKS - rank - 1;
+        for (int cardsLeft = 0; cardsLeft <= HAND_SIZE; cardsLeft++) {
+            unsigned int skipped = 0;
+            for (int count = 0; count <= 4; count++) {
+                hashOffsets[rank][cardsLeft][count] = skipped;
+                if (count <= cardsLeft) {
+                    skipped += patterns[placesAfter][cardsLeft - count];
+                }
+            }
+        }
+    }
+
+    // Only sets with at least 5 cards of the suit are ever looked up
+    for (unsigned int rankMask = 0; rankMask < NUM_RANK_MASKS; rankMask++) {
+        flushKeys[rankMask] = rankCounts[rankMask] >= 5 ? KeyForFlush(*this, rankMask) : 0;
+    }
+
+    // Lay out the patterns for 7 cards first, then 6, then 5
+    unsigned int nextStart = 0;
+    for (int numCards = HAND_SIZE; numCards >= MIN_HAND_SIZE; numCards--) {
+        rankKeyStart[numCards] = nextStart;
+        nextStart += patterns[NUM_RANKS][numCards];
+    }
+
+    for (int numCards = MIN_HAND_SIZE; numCards <= HAND_SIZE; numCards++) {
+        unsigned int nextIndex = rankKeyStart[numCards];
+        FillRankKeys(*this, nextIndex, 0, numCards, 0, 0, 0, 0);
+    }
+}
+
+// The tables themselves. Being constexpr, they are filled in at compile time and stored in the
+// program's read-only data, ready the moment the program starts
+static constexpr EvaluatorTables EVALUATOR_TABLES;
+
+// Since the tables are known at compile time, a broken table fails the build instead of a game:
+// 10 through Ace of one suit must be a Royal flush
+static_assert(EVALUATOR_TABLES.flushKeys[0x1F00] == ((10u << HAND_KEY_CATEGORY_SHIFT) | (14u << (HAND_KEY_VALUE_BITS * 4))),
+              "the flush table does not recognise a Royal flush");
+
+// Return the tables worked out when the program was compiled
+const EvaluatorTables &GetEvaluatorTables() {
+    return EVALUATOR_TABLES;
+}
+
+// Evaluate the best 5-card hand out of a set of 5 to 7 cards
+unsigned int EvaluateHand(CardMask cards) {
+    const EvaluatorTables &tables = GetEvaluatorTables();
+    unsigned int suits[NUM_SUITS];
+
+    // With 7 cards or fewer, a flush rules out every better hand except a straight flush,
+    // and the flush table already accounts for straight flushes
+    for (int suit = 0; suit < NUM_SUITS; suit++) {
+        suits[suit] = SuitRanks(cards, suit);
+        if (tables.rankCounts[suits[suit]] >= 5) {
+            return tables.flushKeys[suits[suit]];
+        }
+    }
+
+    // Add the four suit lanes together bit by bit, giving the count of each card number
+    // spread over three bit planes (1s, 2s and 4s)
+    unsigned int pairSum = suits[0] ^ suits[1];
+    unsigned int pairCarry = suits[0] & suits[1];
+    unsigned int otherSum = suits[2] ^ suits[3];
+    unsigned int otherCarry = suits[2] & suits[3];
+    unsigned int ones = pairSum ^ otherSum;
+    unsigned int sumCarry = pairSum & otherSum;
+    unsigned int twos = pairCarry ^ otherCarry ^ sumCarry;
+    unsigned int fours = pairCarry & otherCarry;
+
+    return LookupRankKey(tables, ones, twos, fours, CountCards(cards));
+}
+
+// Evaluate 7 separate cards by collecting them into a set first
+unsigned int EvaluateHand(const Card cards[7]) {
+    CardMask mask = 0;
+
+    for (int i = 0; i < HAND_SIZE; i++) {
+        mask |= cards[i].GetCardMask();
+    }
+
+    return EvaluateHand(mask);
+}
+
+// Start an empty incremental hand
+IncrementalHand::IncrementalHand() {
+    Reset();
+}
+
+// Empty the hand so it can be reused for the next round
+void IncrementalHand::Reset() {
+    cards = 0;
+    ones = 0;
+    twos = 0;
+    fours = 0;
+    handKey = 0;
+}
+
+// Add newly dealt cards to the hand and bring the hand key up to date
+void IncrementalHand::AddCards(CardMask newCards) {
+    // Ignore cards the hand already holds, so the counts never go out of step with the set
+    newCards &= ~cards;
+    cards |= newCards;
+
+    // Add each card's rank to the bit-plane counts, carrying from the 1s plane to the 2s and then the 4s
+    while (newCards) {
+        unsigned int rankBit = 1u << (__builtin_ctzll(newCards) % MASK_LANE_BITS);
+        unsigned int carryToTwos = ones & rankBit;
+        unsigned int carryToFours = twos & carryToTwos;
+
+        ones ^= rankBit;
+        twos ^= carryToTwos;
+        fours |= carryToFours;
+
+        newCards &= newCards - 1;
+    }
+
+    int numCards = CountCards(cards);
+    if (numCards < MIN_HAND_SIZE) {
+        handKey = 0;
+        return;
+    }
+
+    // Any flush is read straight from the suit lanes; otherwise the counts kept so far go straight to the rank table
+    const EvaluatorTables &tables = GetEvaluatorTables();
+    for (int suit = 0; suit < NUM_SUITS; suit++) {
+        unsigned int suitRanks = SuitRanks(cards, suit);
+        if (tables.rankCounts[suitRanks] >= 5) {
+            handKey = tables.flushKeys[suitRanks];
+            return;
+        }
+    }
+
+    handKey = LookupRankKey(tables, ones, twos, fours, numCards);
+}
+
+// Getter for the cards held so far
+CardMask IncrementalHand::GetCards() {
+    return cards;
+}
+
+// Getter for the best hand key made by the cards so far
+unsigned int IncrementalHand::GetHandKey() {
+    return handKey;
+}
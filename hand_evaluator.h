@@ -0,0 +1,76 @@
+#ifndef HAND_EVALUATOR_H
+#define HAND_EVALUATOR_H
+
+#include "card.h"
+
+/* A hand key packs the same information as the player's handStats vector into one integer.
+   Bits 20-23 hold the type of hand (1 for high card up to 10 for a Royal flush), and the
+   five 4-bit fields below it hold the deciding card numbers from most to least important
+   (2 through 14, with the Ace as 14). Unused fields are 0, exactly like the unused handStats entries,
+   so comparing two keys as integers gives the same answer as comparing the two handStats vectors.
+*/
+const int HAND_KEY_CATEGORY_SHIFT = 20;
+const int HAND_KEY_VALUE_BITS = 4;
+
+// Build a hand key out of the hand type and up to five deciding card numbers
+unsigned int MakeHandKey(int category, const int values[5]);
+// Read the type of hand (1-10) out of a hand key
+int HandKeyCategory(unsigned int handKey);
+// Read one of the five deciding card numbers (position 1-5, matching handStats indices) out of a hand key
+int HandKeyValue(unsigned int handKey, int position);
+
+/* Evaluate the best 5-card hand out of a set of 5, 6 or 7 cards and return its hand key.
+   The evaluation only reads from lookup tables worked out by the compiler: a flush table indexed by the
+   13-bit set of card numbers held in the flush suit, and a rank table indexed by a perfect hash of how many
+   of each card number the hand holds. Nothing is allocated and nothing outside the function is changed,
+   so it is safe to call from any number of threads at once.
+*/
+unsigned int EvaluateHand(CardMask cards);
+// The same evaluation for 7 separate Card objects
+unsigned int EvaluateHand(const Card cards[7]);
+
+// The different ways EvaluateHandBatch can work through its hands: one hand at a time, 4 hands at a time
+// with SSE4.1 instructions, or 8 hands at a time with AVX2 instructions
+enum BatchKernel {
+    SCALAR_KERNEL,
+    SSE4_KERNEL,
+    AVX2_KERNEL
+};
+
+/* Evaluate "numHands" sets of exactly 7 cards and write each hand key to the matching place in handKeys.
+   The keys are identical to calling EvaluateHand on each set, but the vector kernels count the card numbers
+   and look up the tables for several hands with each instruction. The fastest kernel this processor supports
+   is picked the first time it is needed, and the scalar kernel is used on processors without either instruction set.
+*/
+void EvaluateHandBatch(const CardMask hands[], unsigned int handKeys[], int numHands);
+// The same batch evaluation with a specific kernel, mainly for benchmarking.
+// If the processor does not support the kernel asked for, the best supported kernel below it is used instead
+void EvaluateHandBatch(const CardMask hands[], unsigned int handKeys[], int numHands, BatchKernel kernel);
+// Return the fastest kernel this processor supports
+BatchKernel BestBatchKernel();
+// Return the printable name of a kernel ("scalar", "sse4.1" or "avx2")
+const char *BatchKernelName(BatchKernel kernel);
+
+/* Class created for following one player's hand as the streets are dealt. It keeps the cards held so far
+   along with how many of each card number they include, so adding the flop, turn or river only updates
+   those counts and does one table lookup, rather than evaluating the whole hand again from scratch.
+   The hand key is 0 until at least 5 cards are held.
+*/
+class IncrementalHand {
+    public:
+        IncrementalHand();
+        void Reset();
+        void AddCards(CardMask newCards);
+        CardMask GetCards();
+        unsigned int GetHandKey();
+
+    private:
+        CardMask cards;
+        // The count of each card number, spread over three bit planes (bit "rank" of each plane)
+        unsigned int ones;
+        unsigned int twos;
+        unsigned int fours;
+        unsigned int handKey;
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "hand_evaluator.h"
+#include "evaluator_tables.h"
+
+// The vector kernels rely on x86 intrinsics and on the compiler building individual functions
+// for newer instruction sets than the rest of the program, so other platforms only get the scalar kernel
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HAS_X86_BATCH_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// Evaluate each hand in turn with the ordinary single-hand evaluator
+static void EvaluateBatchScalar(const CardMask hands[], unsigned int handKeys[], int numHands) {
+    for (int i = 0; i < numHands; i++) {
+        handKeys[i] = EvaluateHand(hands[i]);
+    }
+}
+
+#ifdef HAS_X86_BATCH_KERNELS
+
+// Count the set bits in each 32-bit lane, looking up 4 bits at a time in a 16-entry table
+__attribute__((target("sse4.1")))
+static __m128i PopCount32Sse4(__m128i value) {
+    const __m128i bitCounts = _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m128i lowNibbles = _mm_set1_epi8(0x0F);
+
+    __m128i low = _mm_and_si128(value, lowNibbles);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(value, 4), lowNibbles);
+    __m128i byteCounts = _mm_add_epi8(_mm_shuffle_epi8(bitCounts, low), _mm_shuffle_epi8(bitCounts, high));
+
+    // Add the 4 byte counts of each lane together
+    __m128i wordCounts = _mm_maddubs_epi16(byteCounts, _mm_set1_epi8(1));
+    return _mm_madd_epi16(wordCounts, _mm_set1_epi16(1));
+}
+
+// Evaluate 4 hands at a time. The card counting and flush checks are done for all 4 hands at once,
+// and since SSE4.1 has no way to load from 4 different table positions in one go, the table lookups
+// are done one lane at a time from the positions the vector code worked out
+__attribute__((target("sse4.1")))
+static void EvaluateBatchSse4(const CardMask hands[], unsigned int handKeys[], int numHands) {
+    const EvaluatorTables &tables = GetEvaluatorTables();
+    const unsigned int *hashOffsets = &tables.hashOffsets[0][0][0];
+    const __m128i laneRanks = _mm_set1_epi32(MASK_LANE_RANKS);
+    const __m128i lowBit = _mm_set1_epi32(1);
+    const __m128i four = _mm_set1_epi32(4);
+    int i = 0;
+
+    for (; i + 4 <= numHands; i += 4) {
+        // Split the 4 masks into their low halves (Diamonds and Hearts) and high halves (Spades and Clubs)
+        __m128 firstPair = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (hands + i)));
+        __m128 secondPair = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (hands + i + 2)));
+        __m128i low = _mm_castps_si128(_mm_shuffle_ps(firstPair, secondPair, _MM_SHUFFLE(2, 0, 2, 0)));
+        __m128i high = _mm_castps_si128(_mm_shuffle_ps(firstPair, secondPair, _MM_SHUFFLE(3, 1, 3, 1)));
+
+        __m128i suits[NUM_SUITS] = {
+            _mm_and_si128(low, laneRanks),
+            _mm_and_si128(_mm_srli_epi32(low, MASK_LANE_BITS), laneRanks),
+            _mm_and_si128(high, laneRanks),
+            _mm_and_si128(_mm_srli_epi32(high, MASK_LANE_BITS), laneRanks)
+        };
+
+        // At most one suit can hold 5 or more of the 7 cards, so its card numbers can simply be OR'd in
+        __m128i flushRanks = _mm_setzero_si128();
+        __m128i isFlush = _mm_setzero_si128();
+        for (int suit = 0; suit < NUM_SUITS; suit++) {
+            __m128i hasFlush = _mm_cmpgt_epi32(PopCount32Sse4(suits[suit]), four);
+            flushRanks = _mm_or_si128(flushRanks, _mm_and_si128(hasFlush, suits[suit]));
+            isFlush = _mm_or_si128(isFlush, hasFlush);
+        }
+
+        // Add the four suit lanes together bit by bit, the same way the single-hand evaluator does
+        __m128i pairSum = _mm_xor_si128(suits[0], suits[1]);
+        __m128i pairCarry = _mm_and_si128(suits[0], suits[1]);
+        __m128i otherSum = _mm_xor_si128(suits[2], suits[3]);
+        __m128i otherCarry = _mm_and_si128(suits[2], suits[3]);
+        __m128i ones = _mm_xor_si128(pairSum, otherSum);
+        __m128i twos = _mm_xor_si128(_mm_xor_si128(pairCarry, otherCarry), _mm_and_si128(pairSum, otherSum));
+        __m128i fours = _mm_and_si128(pairCarry, otherCarry);
+
+        // Work out where each rank's hash offset sits, then add the offsets up one lane at a time
+        unsigned int index[4] = {0, 0, 0, 0};
+        __m128i cardsLeft = _mm_set1_epi32(HAND_SIZE);
+        for (int rank = 0; rank < NUM_RANKS; rank++) {
+            __m128i count = _mm_or_si128(_mm_and_si128(ones, lowBit),
+                _mm_or_si128(_mm_slli_epi32(_mm_and_si128(twos, lowBit), 1), _mm_slli_epi32(_mm_and_si128(fours, lowBit), 2)));
+            // The table is laid out as [rank][cardsLeft][count], so the position is rank * 40 + cardsLeft * 5 + count
+            __m128i position = _mm_add_epi32(_mm_set1_epi32(rank * (HAND_SIZE + 1) * 5),
+                _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(cardsLeft, 2), cardsLeft), count));
+
+            index[0] += hashOffsets[_mm_extract_epi32(position, 0)];
+            index[1] += hashOffsets[_mm_extract_epi32(position, 1)];
+            index[2] += hashOffsets[_mm_extract_epi32(position, 2)];
+            index[3] += hashOffsets[_mm_extract_epi32(position, 3)];
+
+            cardsLeft = _mm_sub_epi32(cardsLeft, count);
+            ones = _mm_srli_epi32(ones, 1);
+            twos = _mm_srli_epi32(twos, 1);
+            fours = _mm_srli_epi32(fours, 1);
+        }
+
+        // Pick the flush key for hands with a flush and the rank key for everything else
+        unsigned int flushIndex[4];
+        _mm_storeu_si128((__m128i *) flushIndex, flushRanks);
+        int flushLanes = _mm_movemask_ps(_mm_castsi128_ps(isFlush));
+        for (int lane = 0; lane < 4; lane++) {
+            if (flushLanes & (1 << lane)) {
+                handKeys[i + lane] = tables.flushKeys[flushIndex[lane]];
+            }
+            else {
+                handKeys[i + lane] = tables.rankKeys[index[lane]];
+            }
+        }
+    }
+
+    // Finish any hands left over after the last full group of 4
+    EvaluateBatchScalar(hands + i, handKeys + i, numHands - i);
+}
+
+// Count the set bits in each 32-bit lane, the same way as PopCount32Sse4 but 8 lanes at a time
+__attribute__((target("avx2")))
+static __m256i PopCount32Avx2(__m256i value) {
+    const __m256i bitCounts = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+
+    __m256i low = _mm256_and_si256(value, lowNibbles);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi16(value, 4), lowNibbles);
+    __m256i byteCounts = _mm256_add_epi8(_mm256_shuffle_epi8(bitCounts, low), _mm256_shuffle_epi8(bitCounts, high));
+
+    __m256i wordCounts = _mm256_maddubs_epi16(byteCounts, _mm256_set1_epi8(1));
+    return _mm256_madd_epi16(wordCounts, _mm256_set1_epi16(1));
+}
+
+// Evaluate 8 hands at a time. Everything, including every table lookup, is done for all 8 hands at once,
+// using AVX2 gathers to load from 8 different table positions with one instruction
+__attribute__((target("avx2")))
+static void EvaluateBatchAvx2(const CardMask hands[], unsigned int handKeys[], int numHands) {
+    const EvaluatorTables &tables = GetEvaluatorTables();
+    const int *hashOffsets = (const int *) &tables.hashOffsets[0][0][0];
+    const int *flushKeys = (const int *) tables.flushKeys;
+    const int *rankKeys = (const int *) tables.rankKeys;
+    // Moves the low half of every mask into the first 4 lanes and the high half into the last 4
+    const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256i laneRanks = _mm256_set1_epi32(MASK_LANE_RANKS);
+    const __m256i lowBit = _mm256_set1_epi32(1);
+    const __m256i four = _mm256_set1_epi32(4);
+    int i = 0;
+
+    for (; i + 8 <= numHands; i += 8) {
+        // Split the 8 masks into their low halves (Diamonds and Hearts) and high halves (Spades and Clubs)
+        __m256i firstFour = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) (hands + i)), deinterleave);
+        __m256i secondFour = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *) (hands + i + 4)), deinterleave);
+        __m256i low = _mm256_permute2x128_si256(firstFour, secondFour, 0x20);
+        __m256i high = _mm256_permute2x128_si256(firstFour, secondFour, 0x31);
+
+        __m256i suits[NUM_SUITS] = {
+            _mm256_and_si256(low, laneRanks),
+            _mm256_and_si256(_mm256_srli_epi32(low, MASK_LANE_BITS), laneRanks),
+            _mm256_and_si256(high, laneRanks),
+            _mm256_and_si256(_mm256_srli_epi32(high, MASK_LANE_BITS), laneRanks)
+        };
+
+        // At most one suit can hold 5 or more of the 7 cards, so its card numbers can simply be OR'd in
+        __m256i flushRanks = _mm256_setzero_si256();
+        __m256i isFlush = _mm256_setzero_si256();
+        for (int suit = 0; suit < NUM_SUITS; suit++) {
+            __m256i hasFlush = _mm256_cmpgt_epi32(PopCount32Avx2(suits[suit]), four);
+            flushRanks = _mm256_or_si256(flushRanks, _mm256_and_si256(hasFlush, suits[suit]));
+            isFlush = _mm256_or_si256(isFlush, hasFlush);
+        }
+
+        // Add the four suit lanes together bit by bit, the same way the single-hand evaluator does
+        __m256i pairSum = _mm256_xor_si256(suits[0], suits[1]);
+        __m256i pairCarry = _mm256_and_si256(suits[0], suits[1]);
+        __m256i otherSum = _mm256_xor_si256(suits[2], suits[3]);
+        __m256i otherCarry = _mm256_and_si256(suits[2], suits[3]);
+        __m256i ones = _mm256_xor_si256(pairSum, otherSum);
+        __m256i twos = _mm256_xor_si256(_mm256_xor_si256(pairCarry, otherCarry), _mm256_and_si256(pairSum, otherSum));
+        __m256i fours = _mm256_and_si256(pairCarry, otherCarry);
+
+        // Walk the perfect hash one rank at a time for all 8 hands. Once a hand runs out of cards,
+        // every remaining offset it looks up is 0, so no hand needs to stop early
+        __m256i index = _mm256_setzero_si256();
+        __m256i cardsLeft = _mm256_set1_epi32(HAND_SIZE);
+        for (int rank = 0; rank < NUM_RANKS; rank++) {
+            __m256i count = _mm256_or_si256(_mm256_and_si256(ones, lowBit),
+                _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(twos, lowBit), 1), _mm256_slli_epi32(_mm256_and_si256(fours, lowBit), 2)));
+            __m256i position = _mm256_add_epi32(_mm256_set1_epi32(rank * (HAND_SIZE + 1) * 5),
+                _mm256_add_epi32(_mm256_add_epi32(_mm256_slli_epi32(cardsLeft, 2), cardsLeft), count));
+
+            index = _mm256_add_epi32(index, _mm256_i32gather_epi32(hashOffsets, position, 4));
+
+            cardsLeft = _mm256_sub_epi32(cardsLeft, count);
+            ones = _mm256_srli_epi32(ones, 1);
+            twos = _mm256_srli_epi32(twos, 1);
+            fours = _mm256_srli_epi32(fours, 1);
+        }
+
+        // Non-flush hands look up flush entry 0, and flush hands still hash to a valid rank entry,
+        // so both lookups are safe for every lane before picking the right one
+        __m256i rankKey = _mm256_i32gather_epi32(rankKeys, index, 4);
+        __m256i flushKey = _mm256_i32gather_epi32(flushKeys, flushRanks, 4);
+        _mm256_storeu_si256((__m256i *) (handKeys + i), _mm256_blendv_epi8(rankKey, flushKey, isFlush));
+    }
+
+    // Finish any hands left over after the last full group of 8
+    EvaluateBatchScalar(hands + i, handKeys + i, numHands - i);
+}
+
+#endif
+
+// Return the fastest kernel this processor supports, checking the processor only once
+BatchKernel BestBatchKernel() {
+#ifdef HAS_X86_BATCH_KERNELS
+    static const BatchKernel bestKernel = __builtin_cpu_supports("avx2") ? AVX2_KERNEL :
+                                          __builtin_cpu_supports("sse4.1") ? SSE4_KERNEL : SCALAR_KERNEL;
+    return bestKernel;
+#else
+    return SCALAR_KERNEL;
+#endif
+}
+
+// Return the printable name of a kernel
+const char *BatchKernelName(BatchKernel kernel) {
+    switch(kernel) {
+        case AVX2_KERNEL:
+            return "avx2";
+        case SSE4_KERNEL:
+            return "sse4.1";
+        default:
+            return "scalar";
+    }
+}
+
+// Evaluate the hands with the fastest kernel available
+void EvaluateHandBatch(const CardMask hands[], unsigned int handKeys[], int numHands) {
+    EvaluateHandBatch(hands, handKeys, numHands, BestBatchKernel());
+}
+
+// Evaluate the hands with the kernel asked for, stepping down to one the processor supports if needed
+void EvaluateHandBatch(const CardMask hands[], unsigned int handKeys[], int numHands, BatchKernel kernel) {
+    if (kernel > BestBatchKernel()) {
+        kernel = BestBatchKernel();
+    }
+
+    switch(kernel) {
+#ifdef HAS_X86_BATCH_KERNELS
+        case AVX2_KERNEL:
+            EvaluateBatchAvx2(hands, handKeys, numHands);
+            break;
+        case SSE4_KERNEL:
+            EvaluateBatchSse4(hands, handKeys, numHands);
+            break;
+#endif
+        default:
+            EvaluateBatchScalar(hands, handKeys, numHands);
+            break;
+    }
+}
@@ -0,0 +1,509 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+
+#include "hand_history.h"
+#include "hand_history_index.h"
+
+// The most bytes a 64-bit varint can take
+static const int MAX_VARINT_BYTES = 10;
+// Actions hold the seat in the low 4 bits of their first byte and the ActionType in the 3 bits above
+static const int ACTION_TYPE_SHIFT = 4;
+// No record comes close to this size (a hand is well under a kilobyte), so a longer length means the file is damaged
+static const uint64_t MAX_RECORD_BYTES = 1 << 24;
+
+// Write 7 bits at a time, lowest first, marking every byte but the last with the top bit
+void AppendVarint(std::string &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((char) ((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back((char) value);
+}
+
+// Read 7 bits at a time until a byte without the top bit
+bool ReadVarint(const unsigned char *&data, const unsigned char *end, uint64_t &value) {
+    value = 0;
+    for (int i = 0; i < MAX_VARINT_BYTES && data < end; i++) {
+        unsigned char byte = *data++;
+        value |= (uint64_t) (byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Read a varint that must be there and must fit in an int, throwing std::invalid_argument otherwise
+static int ReadInt(const unsigned char *&data, const unsigned char *end) {
+    uint64_t value;
+    if (!ReadVarint(data, end, value) || value > 0x7FFFFFFF) {
+        throw std::invalid_argument("HandHistoryParser: a record is cut short or damaged");
+    }
+    return (int) value;
+}
+
+// Read one byte that must be there
+static unsigned char ReadByte(const unsigned char *&data, const unsigned char *end) {
+    if (data >= end) {
+        throw std::invalid_argument("HandHistoryParser: a record is cut short");
+    }
+    return *data++;
+}
+
+// Check the magic bytes and the version at the start of a file
+size_t ReadHandHistoryHeader(const unsigned char *data, size_t size) {
+    if (size < HAND_HISTORY_MAGIC.size() || std::string(data, data + HAND_HISTORY_MAGIC.size()) != HAND_HISTORY_MAGIC) {
+        throw std::invalid_argument("ReadHandHistoryHeader: this is not a hand history file");
+    }
+
+    const unsigned char *position = data + HAND_HISTORY_MAGIC.size();
+    uint64_t version;
+    if (!ReadVarint(position, data + size, version) || version != HAND_HISTORY_VERSION) {
+        throw std::invalid_argument("ReadHandHistoryHeader: the hand history file is not version " + std::to_string(HAND_HISTORY_VERSION));
+    }
+    return position - data;
+}
+
+// Read just the magic bytes and the varint after them, byte by byte, and check them
+size_t ReadHandHistoryHeader(std::istream &in) {
+    std::vector<unsigned char> header;
+    char byte;
+    while (header.size() < HAND_HISTORY_MAGIC.size() + MAX_VARINT_BYTES && in.get(byte)) {
+        header.push_back((unsigned char) byte);
+        if (header.size() > HAND_HISTORY_MAGIC.size() && !(byte & 0x80)) {
+            break;
+        }
+    }
+    return ReadHandHistoryHeader(header.data(), header.size());
+}
+
+// Read a record's length a byte at a time, then the record itself
+bool ReadHandHistoryRecord(std::istream &in, std::vector<unsigned char> &payload) {
+    uint64_t length = 0;
+    char byte;
+    int lengthBytes = 0;
+    do {
+        if (!in.get(byte)) {
+            return false;
+        }
+        length |= (uint64_t) (byte & 0x7F) << (7 * lengthBytes);
+        lengthBytes++;
+    } while ((byte & 0x80) && lengthBytes < MAX_VARINT_BYTES);
+
+    if (length == 0 || length > MAX_RECORD_BYTES || (byte & 0x80)) {
+        throw std::invalid_argument("ReadHandHistoryRecord: a record's length is damaged");
+    }
+    payload.resize(length);
+    return (bool) in.read((char *) payload.data(), length);
+}
+
+// Parse one record, remembering the names and seeds given by PLAYER and GAME records
+bool HandHistoryParser::ParseRecord(const unsigned char *payload, size_t size, HandRecord &hand) {
+    const unsigned char *data = payload;
+    const unsigned char *end = payload + size;
+    int type = ReadByte(data, end);
+
+    if (type == GAME_RECORD) {
+        int gameId = ReadInt(data, end);
+        uint64_t seed;
+        if (!ReadVarint(data, end, seed)) {
+            throw std::invalid_argument("HandHistoryParser: a game record is cut short");
+        }
+        SetGameSeed(gameId, seed);
+        return false;
+    }
+
+    if (type == PLAYER_RECORD) {
+        int playerId = ReadInt(data, end);
+        int length = ReadInt(data, end);
+        if (length > end - data) {
+            throw std::invalid_argument("HandHistoryParser: a player record is cut short");
+        }
+        SetPlayerName(playerId, std::string((const char *) data, length));
+        return false;
+    }
+
+    // Skip any kind of record this version does not know about
+    if (type != HAND_RECORD) {
+        return false;
+    }
+
+    hand.gameId = ReadInt(data, end);
+    if (hand.gameId >= HAND_HISTORY_MAX_ID) {
+        throw std::invalid_argument("HandHistoryParser: a hand's game id is out of range");
+    }
+    hand.seed = GameSeed(hand.gameId);
+    hand.handNumber = ReadInt(data, end);
+    hand.smallBlind = ReadInt(data, end);
+    hand.bigBlind = ReadInt(data, end);
+
+    int numSeats = ReadInt(data, end);
+    if (numSeats > HAND_HISTORY_MAX_SEATS) {
+        throw std::invalid_argument("HandHistoryParser: a hand has more seats than the format allows");
+    }
+    if (numSeats < 2) {
+        throw std::invalid_argument("HandHistoryParser: a hand has fewer than 2 seats");
+    }
+    hand.dealer = ReadInt(data, end);
+    if (hand.dealer >= numSeats) {
+        throw std::invalid_argument("HandHistoryParser: a hand's dealer is not one of its seats");
+    }
+    hand.seats.resize(numSeats);
+    for (SeatRecord &seat : hand.seats) {
+        seat.playerId = ReadInt(data, end);
+        if (seat.playerId >= HAND_HISTORY_MAX_ID) {
+            throw std::invalid_argument("HandHistoryParser: a hand's player id is out of range");
+        }
+        seat.name = PlayerName(seat.playerId);
+        seat.chips = ReadInt(data, end);
+        seat.holeCards[0] = ReadByte(data, end);
+        seat.holeCards[1] = ReadByte(data, end);
+
+        // A seat either has no cards at all or two real ones
+        for (unsigned char card : seat.holeCards) {
+            if (card != NO_CARD && !IsValidCardCode(card)) {
+                throw std::invalid_argument("HandHistoryParser: a hand has a hole card that is not a card");
+            }
+        }
+    }
+
+    int numBoardCards = ReadInt(data, end);
+    if (numBoardCards > 5) {
+        throw std::invalid_argument("HandHistoryParser: a hand has more than 5 board cards");
+    }
+    if (numBoardCards > end - data) {
+        throw std::invalid_argument("HandHistoryParser: a hand's board is cut short");
+    }
+    hand.board.assign(data, data + numBoardCards);
+    data += numBoardCards;
+    for (unsigned char card : hand.board) {
+        if (!IsValidCardCode(card)) {
+            throw std::invalid_argument("HandHistoryParser: a hand has a board card that is not a card");
+        }
+    }
+
+    int streetActions[NUM_STREETS];
+    int numActions = 0;
+    for (int street = 0; street < NUM_STREETS; street++) {
+        streetActions[street] = ReadInt(data, end);
+        numActions += streetActions[street];
+    }
+    // Every action takes at least a byte, which stops a damaged count from asking for a huge vector
+    if (numActions > end - data) {
+        throw std::invalid_argument("HandHistoryParser: a hand's actions are cut short");
+    }
+
+    hand.actions.resize(numActions);
+    int actionIndex = 0;
+    for (int street = 0; street < NUM_STREETS; street++) {
+        for (int i = 0; i < streetActions[street]; i++) {
+            ActionRecord &action = hand.actions[actionIndex++];
+            unsigned char seatAndType = ReadByte(data, end);
+            action.street = street;
+            action.seat = seatAndType & (HAND_HISTORY_MAX_SEATS - 1);
+            action.amount = 0;
+
+            // The type is checked before it is made an ActionType, which cannot hold any other value
+            int type = seatAndType >> ACTION_TYPE_SHIFT;
+            if (action.seat >= numSeats || type > ALL_IN) {
+                throw std::invalid_argument("HandHistoryParser: a hand has an action that does not make sense");
+            }
+            action.type = (ActionType) type;
+            if (action.type == CALL || action.type == RAISE || action.type == ALL_IN) {
+                action.amount = ReadInt(data, end);
+            }
+        }
+    }
+
+    hand.chipsWon.resize(numSeats);
+    for (int seat = 0; seat < numSeats; seat++) {
+        hand.chipsWon[seat] = ReadInt(data, end);
+    }
+
+    // Hands written before the blind seats were recorded had the two seats after the dealer post the blinds
+    if (data == end) {
+        hand.smallBlindSeat = (hand.dealer + 1) % numSeats;
+        hand.bigBlindSeat = (hand.dealer + 2) % numSeats;
+    }
+    else {
+        hand.smallBlindSeat = ReadInt(data, end);
+        hand.bigBlindSeat = ReadInt(data, end);
+        if (hand.smallBlindSeat >= numSeats || hand.bigBlindSeat >= numSeats) {
+            throw std::invalid_argument("HandHistoryParser: a hand's blind is not one of its seats");
+        }
+    }
+
+    return true;
+}
+
+// Return the latest name given to a player id
+std::string HandHistoryParser::PlayerName(int playerId) {
+    if (playerId < 0 || playerId >= (int) playerNames.size()) {
+        return "";
+    }
+    return playerNames[playerId];
+}
+
+// Return the latest seed given to a game id
+uint64_t HandHistoryParser::GameSeed(int gameId) {
+    if (gameId < 0 || gameId >= (int) gameSeeds.size()) {
+        return 0;
+    }
+    return gameSeeds[gameId];
+}
+
+// Give a player id a name without a PLAYER record
+void HandHistoryParser::SetPlayerName(int playerId, const std::string &name) {
+    if (playerId < 0 || playerId >= HAND_HISTORY_MAX_ID) {
+        throw std::invalid_argument("HandHistoryParser: player id " + std::to_string(playerId) + " is out of range");
+    }
+    if (playerId >= (int) playerNames.size()) {
+        playerNames.resize(playerId + 1);
+    }
+    playerNames[playerId] = name;
+}
+
+// Give a game id a seed without a GAME record
+void HandHistoryParser::SetGameSeed(int gameId, uint64_t seed) {
+    if (gameId < 0 || gameId >= HAND_HISTORY_MAX_ID) {
+        throw std::invalid_argument("HandHistoryParser: game id " + std::to_string(gameId) + " is out of range");
+    }
+    if (gameId >= (int) gameSeeds.size()) {
+        gameSeeds.resize(gameId + 1, 0);
+    }
+    gameSeeds[gameId] = seed;
+}
+
+// Create the file with its magic bytes and version if it is new (or empty), and return its name for the LogWriter to open
+static std::string PrepareHandHistoryFile(const std::string &fileName) {
+    std::ifstream existing(fileName, std::ios_base::binary | std::ios_base::ate);
+    if (existing.is_open() && existing.tellg() > 0) {
+        return fileName;
+    }
+    existing.close();
+
+    std::ofstream file(fileName, std::ios_base::binary | std::ios_base::app);
+    std::string header = HAND_HISTORY_MAGIC;
+    AppendVarint(header, HAND_HISTORY_VERSION);
+    file.write(header.data(), header.size());
+    return fileName;
+}
+
+// Indexing stops at the end of the last whole record, so anything after "end" is either a record cut short (by the program
+// stopping while writing it) or a damaged one. A record cut short is removed so new records follow straight on from the last
+// whole one, as the file is opened for appending. Returns false if the file has a damaged record there, which is left alone
+static bool DropPartialRecord(const std::string &fileName, uint64_t end) {
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(fileName, error);
+    if (error || size <= end) {
+        return !error;
+    }
+
+    std::ifstream file(fileName, std::ios_base::binary);
+    file.seekg(end);
+    std::vector<unsigned char> payload;
+    try {
+        if (ReadHandHistoryRecord(file, payload)) {
+            return false;
+        }
+    }
+    catch (const std::invalid_argument &) {
+        return false;
+    }
+    file.close();
+
+    std::filesystem::resize_file(fileName, end, error);
+    return !error;
+}
+
+// Initialization of a writer, creating the file with its header if it is new, and bringing its index up to date
+HandHistoryWriter::HandHistoryWriter(std::string fileName, size_t bufferSize, bool writeIndex) : log(PrepareHandHistoryFile(fileName), bufferSize) {
+    nextGameId = 0;
+    fileBytes = 0;
+
+    // Hands are still recorded without an index if the index cannot be opened (or is not an index at all)
+    if (writeIndex && log.IsOpen()) {
+        try {
+            index.reset(new HandHistoryIndexWriter(fileName));
+        }
+        catch (const std::invalid_argument &) {
+            index.reset();
+        }
+
+        if (index && index->IsOpen()) {
+            fileBytes = index->GetHistoryEnd();
+        }
+        if (index && !DropPartialRecord(fileName, fileBytes)) {
+            index.reset();
+        }
+    }
+}
+
+// Make sure the last hands reach the file and the index before the writer goes
+HandHistoryWriter::~HandHistoryWriter() {
+    Flush();
+}
+
+// Return whether the file opened successfully
+bool HandHistoryWriter::IsOpen() {
+    return log.IsOpen();
+}
+
+// Write a record as its length followed by its bytes, in one piece so records from different tables never mix
+uint64_t HandHistoryWriter::WriteRecord(const std::string &payload) {
+    std::string record;
+    record.reserve(payload.size() + MAX_VARINT_BYTES);
+    AppendVarint(record, payload.size());
+    record += payload;
+
+    if (!log.Write(record)) {
+        return 0;
+    }
+    fileBytes += record.size();
+    return record.size();
+}
+
+// Give the game the next id and write down the seed its deck started from
+int HandHistoryWriter::StartGame(uint64_t seed) {
+    std::lock_guard<std::mutex> guard(lock);
+    // Readers keep the latest seed for each id, so once every id has been used, starting again from 0 is safe
+    int gameId = nextGameId;
+    nextGameId = (nextGameId + 1) % HAND_HISTORY_MAX_ID;
+
+    std::string payload(1, (char) GAME_RECORD);
+    AppendVarint(payload, gameId);
+    AppendVarint(payload, seed);
+    uint64_t size = WriteRecord(payload);
+    if (index && size > 0) {
+        index->AddGame(gameId, seed, size);
+    }
+
+    return gameId;
+}
+
+// Encode a hand, giving ids to (and writing the names of) any players not seen before
+void HandHistoryWriter::WriteHand(HandRecord &hand) {
+    {
+        // The PLAYER record is written while still holding the lock, so it always comes before any hand using its id
+        std::lock_guard<std::mutex> guard(lock);
+        // Readers keep the latest name for each id, so once the ids are about to run out they start again from 0
+        // (and any name seen before gets a new PLAYER record the next time it is seated)
+        if (playerIds.size() + hand.seats.size() > (size_t) HAND_HISTORY_MAX_ID) {
+            playerIds.clear();
+        }
+        for (SeatRecord &seat : hand.seats) {
+            auto found = playerIds.find(seat.name);
+            if (found != playerIds.end()) {
+                seat.playerId = found->second;
+                continue;
+            }
+
+            seat.playerId = playerIds.size();
+            playerIds[seat.name] = seat.playerId;
+
+            std::string payload(1, (char) PLAYER_RECORD);
+            AppendVarint(payload, seat.playerId);
+            AppendVarint(payload, seat.name.size());
+            payload += seat.name;
+            uint64_t size = WriteRecord(payload);
+            if (index && size > 0) {
+                index->AddPlayer(seat.playerId, seat.name, size);
+            }
+        }
+    }
+
+    std::string payload(1, (char) HAND_RECORD);
+    AppendVarint(payload, hand.gameId);
+    AppendVarint(payload, hand.handNumber);
+    AppendVarint(payload, hand.smallBlind);
+    AppendVarint(payload, hand.bigBlind);
+    AppendVarint(payload, hand.seats.size());
+    AppendVarint(payload, hand.dealer);
+
+    for (const SeatRecord &seat : hand.seats) {
+        AppendVarint(payload, seat.playerId);
+        AppendVarint(payload, seat.chips);
+        payload.push_back((char) seat.holeCards[0]);
+        payload.push_back((char) seat.holeCards[1]);
+    }
+
+    AppendVarint(payload, hand.board.size());
+    payload.append(hand.board.begin(), hand.board.end());
+
+    // The actions are already in street order, so counting them per street is all it takes to mark where each street starts
+    int streetActions[NUM_STREETS] = {0, 0, 0, 0};
+    for (const ActionRecord &action : hand.actions) {
+        streetActions[action.street]++;
+    }
+    for (int street = 0; street < NUM_STREETS; street++) {
+        AppendVarint(payload, streetActions[street]);
+    }
+    for (const ActionRecord &action : hand.actions) {
+        payload.push_back((char) (action.seat | (action.type << ACTION_TYPE_SHIFT)));
+        if (action.type == CALL || action.type == RAISE || action.type == ALL_IN) {
+            AppendVarint(payload, action.amount);
+        }
+    }
+
+    for (int chips : hand.chipsWon) {
+        AppendVarint(payload, chips);
+    }
+    AppendVarint(payload, hand.smallBlindSeat);
+    AppendVarint(payload, hand.bigBlindSeat);
+
+    // The hand is encoded without the lock, but written with it, so the index knows exactly where in the file it starts
+    std::lock_guard<std::mutex> guard(lock);
+    uint64_t offset = fileBytes;
+    uint64_t size = WriteRecord(payload);
+    if (index && size > 0) {
+        index->AddHand(hand, offset, size);
+
+        // A block of the index must only point at hands already in the file
+        if (index->BlockFull()) {
+            log.Flush();
+            index->WriteBlock();
+        }
+    }
+}
+
+// Wait until every record written so far is in the file, then add the hands waiting to the index
+void HandHistoryWriter::Flush() {
+    std::lock_guard<std::mutex> guard(lock);
+    log.Flush();
+    if (index) {
+        index->WriteBlock();
+    }
+}
+
+// Open the file and check that it is a hand history file
+HandHistoryReader::HandHistoryReader(std::string fileName) {
+    file.open(fileName, std::ios_base::binary);
+    if (!file.is_open()) {
+        return;
+    }
+
+    ReadHandHistoryHeader(file);
+}
+
+// Return whether the file opened successfully
+bool HandHistoryReader::IsOpen() {
+    return file.is_open();
+}
+
+// Read records until one of them is a hand
+bool HandHistoryReader::NextHand(HandRecord &hand) {
+    while (ReadHandHistoryRecord(file, payload)) {
+        if (parser.ParseRecord(payload.data(), payload.size(), hand)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Return the latest name given to a player id
+std::string HandHistoryReader::PlayerName(int playerId) {
+    return parser.PlayerName(playerId);
+}
@@ -0,0 +1,209 @@
+#ifndef HAND_HISTORY_H
+#define HAND_HISTORY_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+
+#include "card.h"
+#include "action.h"
+#include "log_writer.h"
+
+/* A compact binary record of every hand played, which can be read back completely and quickly, unlike game_stats.txt.
+
+   A hand history file starts with the 4 bytes "THHB" and the format version (as a varint), followed by records.
+   Every record is its length in bytes (as a varint) followed by that many bytes, the first of which is the record type,
+   so a reader can skip any record it does not need (or does not understand) without decoding it.
+   All numbers are unsigned LEB128 varints: 7 bits per byte, lowest bits first, with the top bit set on every byte but the last,
+   so most numbers in a hand take a single byte. Cards are single bytes, using the Card code (see card.h).
+
+   GAME record:    type, game id, deck seed (the seed the table's Deck started from, see Deck::GetSeed)
+   PLAYER record:  type, player id, name length, name bytes
+   HAND record:    type, game id, hand number, small blind, big blind, number of seats, dealer seat,
+                   then for each seat: player id, chips before the blinds, 2 hole cards,
+                   then the number of board cards and the cards in the order dealt,
+                   then the number of actions on each of the 4 streets, followed by every action in order:
+                   one byte holding the seat (low 4 bits) and the ActionType (next 3 bits), then for calls, raises
+                   and going all-in, the chips put in,
+                   then for each seat the chips won (or handed back) when the pot was settled,
+                   then the seats that posted the small blind and the big blind.
+                   Hands written before the blind seats were added end after the chips won, and a reader takes the two seats
+                   after the dealer as the blinds for them, the seats the game has always had post them.
+
+   GAME and PLAYER records give the ids used by the HAND records after them. A reader keeps the latest name for each
+   player id and the latest seed for each game id, so later runs can keep appending to the same file, even though each run
+   gives out ids from 0 again.
+*/
+
+// The first bytes of every hand history file, and the version of the format written
+const std::string HAND_HISTORY_MAGIC = "THHB";
+const int HAND_HISTORY_VERSION = 1;
+// The most seats a hand can have, since an action keeps the seat in 4 bits
+const int HAND_HISTORY_MAX_SEATS = 16;
+// Player and game ids are below this (a writer that runs out starts again from 0), so a damaged id can never make a reader
+// set aside room for billions of them
+const int HAND_HISTORY_MAX_ID = 1 << 24;
+// The file games played at the console are recorded in
+const std::string HAND_HISTORY_FILE = "hand_history.thhb";
+
+// The first byte of each record
+enum HandHistoryRecordType {
+    GAME_RECORD = 1,
+    PLAYER_RECORD = 2,
+    HAND_RECORD = 3
+};
+
+// The betting rounds of a hand, in order
+enum Street {
+    PREFLOP = 0,
+    FLOP_STREET = 1,
+    TURN_STREET = 2,
+    RIVER_STREET = 3
+};
+const int NUM_STREETS = 4;
+
+// One seat at the table when a hand started
+struct SeatRecord {
+    int playerId = 0;
+    std::string name;
+    // The chips the player had before posting any blind
+    int chips = 0;
+    // Card codes (see Card::GetCardCode), in the order MaskToCards lists them
+    unsigned char holeCards[2] = {NO_CARD, NO_CARD};
+};
+
+// One betting decision, as it was actually applied to the table
+struct ActionRecord {
+    int street = PREFLOP;
+    int seat = 0;
+    // FOLD, CHECK, CALL, RAISE (the highest bet went up) or ALL_IN (every chip the player had left went in)
+    ActionType type = CHECK;
+    // The chips the player put in with this action (0 for folding and checking)
+    int amount = 0;
+};
+
+// Everything about one hand: who sat where with what, the cards, every action and how the pot was settled
+struct HandRecord {
+    int gameId = 0;
+    uint64_t seed = 0;
+    int handNumber = 0;
+    int smallBlind = 0;
+    int bigBlind = 0;
+    int dealer = 0;
+    // The seats that posted the small and big blind
+    int smallBlindSeat = 0;
+    int bigBlindSeat = 0;
+    std::vector<SeatRecord> seats;
+    // Card codes of the community cards, in the order they were dealt
+    std::vector<unsigned char> board;
+    std::vector<ActionRecord> actions;
+    // The chips each seat got back when the pot was settled (the same order as seats)
+    std::vector<int> chipsWon;
+};
+
+// Append a number as a varint
+void AppendVarint(std::string &out, uint64_t value);
+// Read a varint and move "data" past it. Returns false if the bytes run out (or the varint is too long) before it ends
+bool ReadVarint(const unsigned char *&data, const unsigned char *end, uint64_t &value);
+
+/* Turns record payloads (the bytes after each record's length) back into hands. It remembers the player names and seeds
+   given by PLAYER and GAME records, and fills them into every HAND record it parses. Works on bytes from anywhere,
+   such as a file read in pieces or a whole file mapped into memory.
+*/
+class HandHistoryParser {
+    public:
+        // Parse one record. Returns true and fills in "hand" for a HAND record, and returns false for any other record.
+        // Throws std::invalid_argument if the record is cut short or does not make sense: a game or player id that is
+        // not below HAND_HISTORY_MAX_ID, fewer than 2 seats, a dealer or blind who is not one of the seats, more than 5 board cards,
+        // or a card code that is not a card (a seat's hole cards can also be NO_CARD)
+        bool ParseRecord(const unsigned char *payload, size_t size, HandRecord &hand);
+        // Return the latest name given to a player id, or an empty string if there is none
+        std::string PlayerName(int playerId);
+        // Return the latest seed given to a game id, or 0 if there is none
+        uint64_t GameSeed(int gameId);
+        // Give a player id a name, or a game id a seed, as a PLAYER or GAME record would.
+        // Used to start parsing partway through a file, with the names and seeds from before that point (such as from the index).
+        // Throws std::invalid_argument for an id that is negative or not below HAND_HISTORY_MAX_ID
+        void SetPlayerName(int playerId, const std::string &name);
+        void SetGameSeed(int gameId, uint64_t seed);
+
+    private:
+        std::vector<std::string> playerNames;
+        std::vector<uint64_t> gameSeeds;
+};
+
+// Check the start of a hand history file and return how many bytes the magic and version take.
+// Throws std::invalid_argument if the bytes are not the start of a hand history file this code can read
+size_t ReadHandHistoryHeader(const unsigned char *data, size_t size);
+// The same check, reading the header from a stream positioned at the start of the file
+size_t ReadHandHistoryHeader(std::istream &in);
+// Read the record at the stream's position into "payload" (without its length). Returns false if the stream ends before a whole record
+bool ReadHandHistoryRecord(std::istream &in, std::vector<unsigned char> &payload);
+
+class HandHistoryIndexWriter;
+
+/* Writes hands to a hand history file through a LogWriter, so it can be shared by every table in the program, from any thread.
+   Each game gets its own id from StartGame, and each player's name is written once, the first time they appear in a hand.
+   The file is created with its header if it does not exist yet, and appended to otherwise.
+   Unless writeIndex is false, the file's index (see hand_history_index.h) is kept up to date as hands are written,
+   after first indexing anything already in the file that the index does not cover yet.
+   Only one writer should append to a file at a time, since the index records where in the file each hand starts.
+*/
+class HandHistoryWriter {
+    public:
+        HandHistoryWriter(std::string fileName, size_t bufferSize = DEFAULT_LOG_BUFFER_SIZE, bool writeIndex = true);
+        // Write out everything still waiting, including the last block of the index
+        ~HandHistoryWriter();
+        bool IsOpen();
+        // Write a GAME record for a table whose Deck started from "seed", and return the game's id
+        int StartGame(uint64_t seed);
+        // Write a HAND record, and a PLAYER record first for anyone not seen before (the hand's player ids are filled in from the names)
+        void WriteHand(HandRecord &hand);
+        // Wait until every record written so far is in the file, and every hand written so far is in the index
+        void Flush();
+
+    private:
+        // Add a record to the log as its length followed by its bytes, returning its size in bytes (0 if the log is not open)
+        uint64_t WriteRecord(const std::string &payload);
+
+        LogWriter log;
+        std::unique_ptr<HandHistoryIndexWriter> index;
+        // Guards the ids given out so far, the size of the file and the index
+        std::mutex lock;
+        std::unordered_map<std::string, int> playerIds;
+        int nextGameId;
+        // The size the file will be once every record written so far is in it
+        uint64_t fileBytes;
+};
+
+// What a Round needs to record its hand: the writer (none means nothing is written) and the id of the game the hand belongs to.
+// If "played" is set, the finished record is also copied there, such as to check a replayed hand against the original (see replay.h)
+struct HandHistoryGame {
+    HandHistoryWriter *writer = nullptr;
+    int gameId = 0;
+    HandRecord *played = nullptr;
+};
+
+/* Reads a hand history file from start to end, one record at a time, never holding more than one record in memory.
+   Throws std::invalid_argument if the file does not start like a hand history file, or if a record is damaged.
+*/
+class HandHistoryReader {
+    public:
+        HandHistoryReader(std::string fileName);
+        bool IsOpen();
+        // Read on to the next hand, returning false once the file has no more whole hands
+        // (the last record may be cut short while another program is still writing to the file)
+        bool NextHand(HandRecord &hand);
+        std::string PlayerName(int playerId);
+
+    private:
+        std::ifstream file;
+        std::vector<unsigned char> payload;
+        HandHistoryParser parser;
+};
+
+#endif
@@ -0,0 +1,565 @@
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+#include "hand_history_index.h"
+
+// The most bytes a 64-bit varint can take
+static const int MAX_VARINT_BYTES = 10;
+// How many hand entries are read at once when going through a range of rounds
+static const uint32_t ENTRIES_PER_READ = 1024;
+
+// Check the magic bytes and version at the start of an index, and return how many bytes they take
+static size_t ReadIndexHeader(std::istream &in) {
+    std::string magic(HAND_HISTORY_INDEX_MAGIC.size(), ' ');
+    in.read(&magic[0], magic.size());
+    if (!in || magic != HAND_HISTORY_INDEX_MAGIC) {
+        throw std::invalid_argument("HandHistoryIndex: this is not a hand history index");
+    }
+
+    std::vector<unsigned char> version;
+    char byte;
+    while (version.size() < MAX_VARINT_BYTES && in.get(byte)) {
+        version.push_back((unsigned char) byte);
+        if (!(byte & 0x80)) {
+            break;
+        }
+    }
+    const unsigned char *data = version.data();
+    uint64_t value;
+    if (!ReadVarint(data, data + version.size(), value) || value != HAND_HISTORY_INDEX_VERSION) {
+        throw std::invalid_argument("HandHistoryIndex: the index is not version " + std::to_string(HAND_HISTORY_INDEX_VERSION));
+    }
+    return magic.size() + version.size();
+}
+
+// Read a varint from a block's directory, throwing if the directory is cut short
+static uint64_t ReadDirectoryNumber(const unsigned char *&data, const unsigned char *end) {
+    uint64_t value;
+    if (!ReadVarint(data, end, value)) {
+        throw std::invalid_argument("HandHistoryIndex: a block's directory is damaged");
+    }
+    return value;
+}
+
+// Read the players and games out of a block's directory
+static void ReadDirectory(const std::vector<unsigned char> &directory, std::vector<IndexPlayer> &players,
+                          std::vector<std::pair<int, uint64_t>> &games) {
+    const unsigned char *data = directory.data();
+    const unsigned char *end = data + directory.size();
+
+    players.resize(ReadDirectoryNumber(data, end));
+    for (IndexPlayer &player : players) {
+        player.playerId = ReadDirectoryNumber(data, end);
+        uint64_t length = ReadDirectoryNumber(data, end);
+        if (length > (uint64_t) (end - data)) {
+            throw std::invalid_argument("HandHistoryIndex: a block's directory is damaged");
+        }
+        player.name.assign((const char *) data, length);
+        data += length;
+        player.seatsStart = ReadDirectoryNumber(data, end);
+        player.seatBytes = ReadDirectoryNumber(data, end);
+        player.numSeats = ReadDirectoryNumber(data, end);
+    }
+
+    games.resize(ReadDirectoryNumber(data, end));
+    for (std::pair<int, uint64_t> &game : games) {
+        game.first = ReadDirectoryNumber(data, end);
+        game.second = ReadDirectoryNumber(data, end);
+    }
+}
+
+// Read the header of the block at the stream's position and its directory, skipping the entries in between.
+// Returns false if the index ends before the whole block (which happens while a block is still being written)
+static bool ReadBlock(std::istream &in, IndexBlockHeader &header, uint64_t &handsStart, std::vector<IndexPlayer> &players,
+                      std::vector<std::pair<int, uint64_t>> &games) {
+    if (!in.read((char *) &header, sizeof(header))) {
+        return false;
+    }
+
+    handsStart = in.tellg();
+    in.seekg((uint64_t) header.numHands * sizeof(IndexEntry) + header.seatBytes, std::ios_base::cur);
+
+    std::vector<unsigned char> directory(header.directoryBytes);
+    if (!in.read((char *) directory.data(), directory.size())) {
+        return false;
+    }
+
+    ReadDirectory(directory, players, games);
+    for (const IndexPlayer &player : players) {
+        if ((uint64_t) player.seatsStart + player.seatBytes > header.seatBytes) {
+            throw std::invalid_argument("HandHistoryIndex: a block's directory is damaged");
+        }
+    }
+    return true;
+}
+
+// Initialization of an index writer: open the index (creating it if needed), read the names and seeds from its blocks,
+// cut off any block left half written, and index whatever the hand history file holds beyond the last block
+HandHistoryIndexWriter::HandHistoryIndexWriter(std::string historyFile) {
+    std::string indexFile = historyFile + HAND_HISTORY_INDEX_EXTENSION;
+    blockStart = 0;
+    historyEnd = 0;
+
+    // Start the index with its header if it is new (or empty)
+    {
+        std::ifstream existing(indexFile, std::ios_base::binary | std::ios_base::ate);
+        if (!existing.is_open() || existing.tellg() == 0) {
+            existing.close();
+            std::ofstream created(indexFile, std::ios_base::binary | std::ios_base::trunc);
+            std::string header = HAND_HISTORY_INDEX_MAGIC;
+            AppendVarint(header, HAND_HISTORY_INDEX_VERSION);
+            created.write(header.data(), header.size());
+        }
+    }
+
+    std::ifstream existing(indexFile, std::ios_base::binary);
+    if (!existing.is_open()) {
+        return;
+    }
+
+    // Go through the blocks, keeping the names and seeds they give, up to the end of the last whole block
+    uint64_t headerBytes = ReadIndexHeader(existing);
+    uint64_t wholeBlocksEnd = headerBytes;
+    IndexBlockHeader header;
+    uint64_t handsStart;
+    std::vector<IndexPlayer> players;
+    std::vector<std::pair<int, uint64_t>> games;
+    while (ReadBlock(existing, header, handsStart, players, games)) {
+        for (const IndexPlayer &player : players) {
+            if (player.playerId >= (int) playerNames.size()) {
+                playerNames.resize(player.playerId + 1);
+            }
+            playerNames[player.playerId] = player.name;
+        }
+        for (const std::pair<int, uint64_t> &game : games) {
+            if (game.first >= (int) gameSeeds.size()) {
+                gameSeeds.resize(game.first + 1, 0);
+            }
+            gameSeeds[game.first] = game.second;
+        }
+        wholeBlocksEnd = existing.tellg();
+        historyEnd = header.historyEnd;
+    }
+    existing.close();
+
+    // If the hand history is shorter than the index says, it is not the file the index was made for, so the index starts again
+    std::error_code error;
+    uint64_t historyBytes = std::filesystem::file_size(historyFile, error);
+    if (error || historyBytes < historyEnd) {
+        wholeBlocksEnd = headerBytes;
+        historyEnd = 0;
+        playerNames.clear();
+        gameSeeds.clear();
+    }
+
+    // Cut off anything after the last whole block
+    std::filesystem::resize_file(indexFile, wholeBlocksEnd, error);
+    if (error) {
+        return;
+    }
+
+    file.open(indexFile, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    if (!file.is_open()) {
+        return;
+    }
+
+    blockStart = historyEnd;
+    CatchUp(historyFile);
+}
+
+// Return whether the index opened successfully
+bool HandHistoryIndexWriter::IsOpen() {
+    return file.is_open();
+}
+
+// Return where the indexed part of the hand history file ends
+uint64_t HandHistoryIndexWriter::GetHistoryEnd() {
+    return historyEnd;
+}
+
+// Read through the hand history file from the end of the last block, adding every record to the index as if it had just been written.
+// Indexing stops at the last whole record, or at a damaged one
+void HandHistoryIndexWriter::CatchUp(const std::string &historyFile) {
+    std::ifstream history(historyFile, std::ios_base::binary);
+    if (!history.is_open()) {
+        return;
+    }
+
+    try {
+        if (historyEnd == 0) {
+            historyEnd = ReadHandHistoryHeader(history);
+            blockStart = historyEnd;
+        }
+        history.seekg(historyEnd);
+
+        // The parser starts with every name and seed given before this point
+        HandHistoryParser parser;
+        for (size_t i = 0; i < playerNames.size(); i++) {
+            parser.SetPlayerName(i, playerNames[i]);
+        }
+        for (size_t i = 0; i < gameSeeds.size(); i++) {
+            parser.SetGameSeed(i, gameSeeds[i]);
+        }
+
+        HandRecord hand;
+        std::vector<unsigned char> payload;
+        uint64_t offset = historyEnd;
+        while (ReadHandHistoryRecord(history, payload)) {
+            uint64_t size = (uint64_t) history.tellg() - offset;
+            const unsigned char *idBytes = payload.data() + 1;
+            const unsigned char *end = payload.data() + payload.size();
+            uint64_t id = 0;
+
+            if (parser.ParseRecord(payload.data(), payload.size(), hand)) {
+                AddHand(hand, offset, size);
+            }
+            else if (payload[0] == PLAYER_RECORD && ReadVarint(idBytes, end, id)) {
+                AddPlayer(id, parser.PlayerName(id), size);
+            }
+            else if (payload[0] == GAME_RECORD && ReadVarint(idBytes, end, id)) {
+                AddGame(id, parser.GameSeed(id), size);
+            }
+            else {
+                historyEnd += size;
+            }
+
+            if (BlockFull()) {
+                WriteBlock();
+            }
+            offset += size;
+        }
+    }
+    catch (const std::invalid_argument &) {
+        // Everything before the damaged record is indexed, which is as far as any reader could get too
+    }
+
+    WriteBlock();
+}
+
+// Add a player to the block's directory, if they are not there already
+void HandHistoryIndexWriter::UsePlayer(int playerId) {
+    if (playerId >= (int) playerInBlock.size()) {
+        playerInBlock.resize(playerId + 1, false);
+    }
+    if (!playerInBlock[playerId]) {
+        playerInBlock[playerId] = true;
+        blockPlayers.push_back(playerId);
+    }
+}
+
+// Add a game to the block's directory, if it is not there already
+void HandHistoryIndexWriter::UseGame(int gameId) {
+    if (gameId >= (int) gameInBlock.size()) {
+        gameInBlock.resize(gameId + 1, false);
+    }
+    if (!gameInBlock[gameId]) {
+        gameInBlock[gameId] = true;
+        blockGames.push_back(gameId);
+    }
+}
+
+// Note down a player's name. A block holds one name for each id, so if the id already means someone else in this block
+// (which only happens where a new run of the program starts giving out ids again), the block is finished first
+void HandHistoryIndexWriter::AddPlayer(int playerId, const std::string &name, uint64_t size) {
+    if (playerId < (int) playerInBlock.size() && playerInBlock[playerId] && playerNames[playerId] != name) {
+        WriteBlock();
+    }
+
+    if (playerId >= (int) playerNames.size()) {
+        playerNames.resize(playerId + 1);
+    }
+    playerNames[playerId] = name;
+    UsePlayer(playerId);
+    historyEnd += size;
+}
+
+// Note down a game's seed, finishing the block first if the id already means another game in this block
+void HandHistoryIndexWriter::AddGame(int gameId, uint64_t seed, uint64_t size) {
+    if (gameId < (int) gameInBlock.size() && gameInBlock[gameId] && gameSeeds[gameId] != seed) {
+        WriteBlock();
+    }
+
+    if (gameId >= (int) gameSeeds.size()) {
+        gameSeeds.resize(gameId + 1, 0);
+    }
+    gameSeeds[gameId] = seed;
+    UseGame(gameId);
+    historyEnd += size;
+}
+
+// Note down a hand, with an entry for the hand and one for each of its seats
+void HandHistoryIndexWriter::AddHand(const HandRecord &hand, uint64_t offset, uint64_t size) {
+    IndexEntry entry;
+    entry.offset = offset - blockStart;
+    entry.handNumber = hand.handNumber;
+
+    hands.push_back(entry);
+    UseGame(hand.gameId);
+    for (const SeatRecord &seat : hand.seats) {
+        seats.push_back(std::make_pair(seat.playerId, entry));
+        UsePlayer(seat.playerId);
+    }
+    historyEnd = offset + size;
+}
+
+// Return whether enough hands are waiting for a block
+bool HandHistoryIndexWriter::BlockFull() {
+    return hands.size() >= INDEX_BLOCK_HANDS || historyEnd - blockStart >= INDEX_BLOCK_MAX_BYTES;
+}
+
+// Sort the waiting entries, write them with their directory to the end of the index, and start a new block
+void HandHistoryIndexWriter::WriteBlock() {
+    if (!file.is_open() || historyEnd == blockStart) {
+        return;
+    }
+
+    std::sort(hands.begin(), hands.end(), [](const IndexEntry &a, const IndexEntry &b) {
+        return a.handNumber != b.handNumber ? a.handNumber < b.handNumber : a.offset < b.offset;
+    });
+    std::sort(seats.begin(), seats.end(), [](const std::pair<int, IndexEntry> &a, const std::pair<int, IndexEntry> &b) {
+        return a.first != b.first ? a.first < b.first : a.second.offset < b.second.offset;
+    });
+    std::sort(blockPlayers.begin(), blockPlayers.end());
+    std::sort(blockGames.begin(), blockGames.end());
+
+    // Each player's list of seats follows on from the previous player's, since the seats are sorted by player id.
+    // The hands in a list only ever move forward through the file, so each is given by how far it is from the one before
+    std::string seatLists;
+    std::string directory;
+    AppendVarint(directory, blockPlayers.size());
+    size_t nextSeat = 0;
+    for (int playerId : blockPlayers) {
+        size_t listStart = seatLists.size();
+        size_t firstSeat = nextSeat;
+        uint32_t previousOffset = 0;
+        while (nextSeat < seats.size() && seats[nextSeat].first == playerId) {
+            AppendVarint(seatLists, seats[nextSeat].second.offset - previousOffset);
+            AppendVarint(seatLists, seats[nextSeat].second.handNumber);
+            previousOffset = seats[nextSeat].second.offset;
+            nextSeat++;
+        }
+
+        AppendVarint(directory, playerId);
+        AppendVarint(directory, playerNames[playerId].size());
+        directory += playerNames[playerId];
+        AppendVarint(directory, listStart);
+        AppendVarint(directory, seatLists.size() - listStart);
+        AppendVarint(directory, nextSeat - firstSeat);
+    }
+    AppendVarint(directory, blockGames.size());
+    for (int gameId : blockGames) {
+        AppendVarint(directory, gameId);
+        AppendVarint(directory, gameSeeds[gameId]);
+    }
+
+    IndexBlockHeader header;
+    header.numHands = hands.size();
+    header.seatBytes = seatLists.size();
+    header.directoryBytes = directory.size();
+    header.reserved = 0;
+    header.historyStart = blockStart;
+    header.historyEnd = historyEnd;
+
+    file.seekp(0, std::ios_base::end);
+    file.write((const char *) &header, sizeof(header));
+    file.write((const char *) hands.data(), hands.size() * sizeof(IndexEntry));
+    file.write(seatLists.data(), seatLists.size());
+    file.write(directory.data(), directory.size());
+    file.flush();
+
+    hands.clear();
+    seats.clear();
+    for (int playerId : blockPlayers) {
+        playerInBlock[playerId] = false;
+    }
+    for (int gameId : blockGames) {
+        gameInBlock[gameId] = false;
+    }
+    blockPlayers.clear();
+    blockGames.clear();
+    blockStart = historyEnd;
+}
+
+// Bring the index of a hand history file up to date, by opening (and then closing) a writer for it
+bool UpdateHandHistoryIndex(const std::string &historyFile) {
+    if (!std::ifstream(historyFile).is_open()) {
+        return false;
+    }
+
+    HandHistoryIndexWriter index(historyFile);
+    return index.IsOpen();
+}
+
+// Open an index and its hand history file, and read the header and directory of every whole block
+HandHistoryIndex::HandHistoryIndex(std::string historyFile) {
+    numHands = 0;
+    historyEnd = 0;
+    parserBlock = -1;
+
+    file.open(historyFile + HAND_HISTORY_INDEX_EXTENSION, std::ios_base::binary);
+    history.open(historyFile, std::ios_base::binary);
+    if (!file.is_open() || !history.is_open()) {
+        return;
+    }
+
+    ReadIndexHeader(file);
+    IndexBlockHeader header;
+    IndexBlock block;
+    while (ReadBlock(file, header, block.handsStart, block.players, block.games)) {
+        block.seatsStart = block.handsStart + (uint64_t) header.numHands * sizeof(IndexEntry);
+        block.numHands = header.numHands;
+        block.historyStart = header.historyStart;
+
+        for (size_t i = 0; i < block.players.size(); i++) {
+            playerBlocks[block.players[i].name].push_back(std::make_pair(blocks.size(), i));
+        }
+        blocks.push_back(block);
+        numHands += header.numHands;
+        historyEnd = header.historyEnd;
+    }
+    file.clear();
+
+    history.seekg(0, std::ios_base::end);
+    if ((uint64_t) history.tellg() < historyEnd) {
+        throw std::invalid_argument("HandHistoryIndex: the index does not belong to '" + historyFile + "'");
+    }
+}
+
+// Return whether both files opened successfully
+bool HandHistoryIndex::IsOpen() {
+    return file.is_open() && history.is_open();
+}
+
+// Return how many hands the index covers
+long HandHistoryIndex::GetNumHands() {
+    return numHands;
+}
+
+// Return where in the hand history file the last block ends
+uint64_t HandHistoryIndex::GetHistoryEnd() {
+    return historyEnd;
+}
+
+// Read bytes from the index file, throwing if it ends too soon
+void HandHistoryIndex::ReadIndexBytes(uint64_t position, uint64_t count, void *bytes) {
+    file.seekg(position);
+    if (!file.read((char *) bytes, count)) {
+        file.clear();
+        throw std::invalid_argument("HandHistoryIndex: the index is cut short");
+    }
+}
+
+// Put the hands found back into the order they are in the hand history file
+static void SortByOffset(std::vector<HandLocation> &locations) {
+    std::sort(locations.begin(), locations.end(), [](const HandLocation &a, const HandLocation &b) {
+        return a.offset < b.offset;
+    });
+}
+
+// Read the player's list of seats from every block they are in, keeping the hands in the range of rounds
+std::vector<HandLocation> HandHistoryIndex::FindPlayerHands(const std::string &name, int firstRound, int lastRound) {
+    std::vector<HandLocation> locations;
+    auto found = playerBlocks.find(name);
+    if (found == playerBlocks.end()) {
+        return locations;
+    }
+
+    for (const std::pair<int, int> &place : found->second) {
+        const IndexBlock &block = blocks[place.first];
+        const IndexPlayer &player = block.players[place.second];
+        seatList.resize(player.seatBytes);
+        ReadIndexBytes(block.seatsStart + player.seatsStart, seatList.size(), seatList.data());
+
+        const unsigned char *data = seatList.data();
+        const unsigned char *end = data + seatList.size();
+        uint64_t offset = block.historyStart;
+        for (uint32_t i = 0; i < player.numSeats; i++) {
+            offset += ReadDirectoryNumber(data, end);
+            int handNumber = ReadDirectoryNumber(data, end);
+
+            if (handNumber >= firstRound && handNumber <= lastRound) {
+                HandLocation location;
+                location.offset = offset;
+                location.handNumber = handNumber;
+                location.block = place.first;
+                locations.push_back(location);
+            }
+        }
+    }
+
+    SortByOffset(locations);
+    return locations;
+}
+
+// In each block, find the first hand of the range with a binary search over the hand entries, then read on to the end of the range
+std::vector<HandLocation> HandHistoryIndex::FindRoundHands(int firstRound, int lastRound) {
+    std::vector<HandLocation> locations;
+    std::vector<IndexEntry> entries(ENTRIES_PER_READ);
+
+    for (size_t b = 0; b < blocks.size(); b++) {
+        const IndexBlock &block = blocks[b];
+        uint32_t low = 0;
+        uint32_t high = block.numHands;
+        while (low < high) {
+            uint32_t middle = low + (high - low) / 2;
+            IndexEntry entry;
+            ReadIndexBytes(block.handsStart + (uint64_t) middle * sizeof(IndexEntry), sizeof(IndexEntry), &entry);
+            if ((int) entry.handNumber < firstRound) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+
+        bool pastRange = false;
+        for (uint32_t start = low; start < block.numHands && !pastRange; start += ENTRIES_PER_READ) {
+            uint32_t count = std::min(ENTRIES_PER_READ, block.numHands - start);
+            ReadIndexBytes(block.handsStart + (uint64_t) start * sizeof(IndexEntry), count * sizeof(IndexEntry), entries.data());
+            for (uint32_t i = 0; i < count; i++) {
+                if ((int) entries[i].handNumber > lastRound) {
+                    pastRange = true;
+                    break;
+                }
+
+                HandLocation location;
+                location.offset = block.historyStart + entries[i].offset;
+                location.handNumber = entries[i].handNumber;
+                location.block = b;
+                locations.push_back(location);
+            }
+        }
+    }
+
+    SortByOffset(locations);
+    return locations;
+}
+
+// Read the hand's record straight from where it starts, parsing it with the names and seeds of its block
+void HandHistoryIndex::ReadHand(const HandLocation &location, HandRecord &hand) {
+    if (location.block < 0 || location.block >= (int) blocks.size()) {
+        throw std::out_of_range("HandHistoryIndex::ReadHand: there is no block " + std::to_string(location.block));
+    }
+
+    if (location.block != parserBlock) {
+        parser = HandHistoryParser();
+        for (const IndexPlayer &player : blocks[location.block].players) {
+            parser.SetPlayerName(player.playerId, player.name);
+        }
+        for (const std::pair<int, uint64_t> &game : blocks[location.block].games) {
+            parser.SetGameSeed(game.first, game.second);
+        }
+        parserBlock = location.block;
+    }
+
+    history.clear();
+    history.seekg(location.offset);
+    if (!ReadHandHistoryRecord(history, payload) || !parser.ParseRecord(payload.data(), payload.size(), hand)) {
+        throw std::invalid_argument("HandHistoryIndex::ReadHand: there is no hand at byte " + std::to_string(location.offset) +
+                                    " of the hand history file");
+    }
+}
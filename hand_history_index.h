@@ -0,0 +1,166 @@
+#ifndef HAND_HISTORY_INDEX_H
+#define HAND_HISTORY_INDEX_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+#include <climits>
+#include <cstdint>
+
+#include "hand_history.h"
+
+/* An index of a hand history file (see hand_history.h), kept next to it in a file with ".idx" added to its name, which finds
+   every hand a player played, or every hand within a range of round numbers, without reading the whole hand history.
+   Round numbers are the ones PlayRound was given, so they start again from 1 in every game.
+
+   The index starts with the 4 bytes "THHI" and the format version (as a varint), followed by blocks. Each block covers
+   the records written to the hand history file between two points, and is never changed once written, so keeping the index
+   up to date as hands are played only ever means adding a block to the end of it. A block is:
+     - an IndexBlockHeader
+     - an IndexEntry for each hand, sorted by round number
+     - each player's seats, as a list of varint pairs in the order the hands were written: how far the hand starts after
+       the previous one in the list (or after the start of the block, for the first), and the hand's round number
+     - a directory of varints: the number of players, and for each one its id, name length, name bytes, and where its list
+       of seats starts and how many bytes and seats it has, followed by the number of games, and for each one its id and seed.
+   The directory holds every player and game used by the block's hands or given by PLAYER and GAME records within the block,
+   so any hand can be read on its own from its block, and indexing can carry on from the end of the last block.
+   All in all the index takes around a third as many bytes as the hand history it covers.
+
+   Opening an index only reads the headers and directories of its blocks. Looking up a player reads just that player's
+   list of seats from each block, and looking up rounds does a binary search through each block's hand entries.
+*/
+
+// The first bytes of every index file, the version of the format written, and what is added to the hand history file's name
+const std::string HAND_HISTORY_INDEX_MAGIC = "THHI";
+const int HAND_HISTORY_INDEX_VERSION = 1;
+const std::string HAND_HISTORY_INDEX_EXTENSION = ".idx";
+// A block is written once this many hands are waiting, or once it covers this many bytes of the hand history
+// (and whenever the hand history is flushed)
+const int INDEX_BLOCK_HANDS = 16384;
+const uint64_t INDEX_BLOCK_MAX_BYTES = 1 << 30;
+
+// The start of each block, giving the sizes of the parts after it and the part of the hand history file it covers
+struct IndexBlockHeader {
+    uint32_t numHands;
+    uint32_t seatBytes;
+    uint32_t directoryBytes;
+    uint32_t reserved;
+    uint64_t historyStart;
+    uint64_t historyEnd;
+};
+
+// Where one hand starts in the hand history file (counted from the start of the part its block covers), and its round number
+struct IndexEntry {
+    uint32_t offset;
+    uint32_t handNumber;
+};
+
+// A player in a block's directory, with where their list of seats is among the block's lists
+struct IndexPlayer {
+    int playerId = 0;
+    std::string name;
+    uint32_t seatsStart = 0;
+    uint32_t seatBytes = 0;
+    uint32_t numSeats = 0;
+};
+
+// A hand found in the index: where it starts in the hand history file, its round number, and the block of the index it was found in
+struct HandLocation {
+    uint64_t offset = 0;
+    int handNumber = 0;
+    int block = 0;
+};
+
+/* Adds hands to the end of an index as they are written to the hand history file. It is created (or has any block left
+   half written removed) when the writer is opened, and anything in the hand history file after the end of the last block
+   is indexed straight away. Used by HandHistoryWriter, which calls it in the order the records go into the file.
+*/
+class HandHistoryIndexWriter {
+    public:
+        HandHistoryIndexWriter(std::string historyFile);
+        bool IsOpen();
+        // Return where the hand history file ends, as far as the index knows: every record before this point has been indexed
+        uint64_t GetHistoryEnd();
+        // Note down a PLAYER or GAME record, or a HAND record that starts at "offset", each "size" bytes long
+        void AddPlayer(int playerId, const std::string &name, uint64_t size);
+        void AddGame(int gameId, uint64_t seed, uint64_t size);
+        void AddHand(const HandRecord &hand, uint64_t offset, uint64_t size);
+        // Return whether enough hands are waiting for a block to be written
+        bool BlockFull();
+        // Write everything waiting as a block. The records it covers must already be in the hand history file
+        void WriteBlock();
+
+    private:
+        // Index any records in the hand history file after the end of the last block
+        void CatchUp(const std::string &historyFile);
+        // Add a player or game to the block being put together
+        void UsePlayer(int playerId);
+        void UseGame(int gameId);
+
+        std::fstream file;
+        // The latest name of every player id and seed of every game id, over the whole hand history
+        std::vector<std::string> playerNames;
+        std::vector<uint64_t> gameSeeds;
+        // The block being put together: its hands, its seats (as a player id and a hand), and the players and games it uses
+        std::vector<IndexEntry> hands;
+        std::vector<std::pair<int, IndexEntry>> seats;
+        std::vector<int> blockPlayers;
+        std::vector<int> blockGames;
+        std::vector<bool> playerInBlock;
+        std::vector<bool> gameInBlock;
+        uint64_t blockStart;
+        uint64_t historyEnd;
+};
+
+// Index any part of a hand history file not indexed yet, creating the index if there is none. Returns false if either file cannot be opened
+bool UpdateHandHistoryIndex(const std::string &historyFile);
+
+/* Looks up hands in a hand history file through its index, and reads them straight from where they start in the file.
+   Hands added to the file after the index was opened are not found.
+   Throws std::invalid_argument if the index is damaged, or does not belong to the hand history file.
+*/
+class HandHistoryIndex {
+    public:
+        HandHistoryIndex(std::string historyFile);
+        bool IsOpen();
+        // Return how many hands the index covers, and where in the hand history file the last block ends
+        long GetNumHands();
+        uint64_t GetHistoryEnd();
+        // Return every hand the player played with a round number from firstRound to lastRound, in the order they were written.
+        // Players are found by name, so a name used in more than one run of the program finds the hands from all of them
+        std::vector<HandLocation> FindPlayerHands(const std::string &name, int firstRound = 1, int lastRound = INT_MAX);
+        // Return every hand with a round number from firstRound to lastRound, in the order they were written
+        std::vector<HandLocation> FindRoundHands(int firstRound, int lastRound = INT_MAX);
+        // Read one hand found by the index from the hand history file, with its players' names and its game's seed
+        void ReadHand(const HandLocation &location, HandRecord &hand);
+
+    private:
+        // What is kept in memory for each block: where its entries are in the index file, and its directory
+        struct IndexBlock {
+            uint64_t handsStart;
+            uint64_t seatsStart;
+            uint32_t numHands;
+            uint64_t historyStart;
+            std::vector<IndexPlayer> players;
+            std::vector<std::pair<int, uint64_t>> games;
+        };
+
+        // Read "count" bytes from "position" in the index file
+        void ReadIndexBytes(uint64_t position, uint64_t count, void *bytes);
+
+        std::ifstream file;
+        std::ifstream history;
+        std::vector<IndexBlock> blocks;
+        // The players each name was found as in each block, as (block, place in the block's directory)
+        std::unordered_map<std::string, std::vector<std::pair<int, int>>> playerBlocks;
+        long numHands;
+        uint64_t historyEnd;
+        // A parser holding the names and seeds of the block the last hand was read from
+        HandHistoryParser parser;
+        int parserBlock;
+        std::vector<unsigned char> payload;
+        std::vector<unsigned char> seatList;
+};
+
+#endif
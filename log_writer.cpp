@@ -0,0 +1,142 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#include "log_writer.h"
+
+// Initialization of a log, opening the file for appending and starting the background thread that writes to it
+LogWriter::LogWriter(std::string fileName, size_t bufferSize, LogFullPolicy fullPolicy) : buffer(std::max(bufferSize, (size_t) 1)) {
+    this->fullPolicy = fullPolicy;
+    start = 0;
+    used = 0;
+    batchSize = std::max(buffer.size() / 4, (size_t) 1);
+    bytesAdded = 0;
+    bytesWritten = 0;
+    droppedRecords = 0;
+    flushRequested = false;
+    stopping = false;
+
+    file.open(fileName, std::ios_base::app | std::ios_base::binary);
+    if (file.is_open()) {
+        writer = std::thread(&LogWriter::WriterLoop, this);
+    }
+}
+
+// Stop the background thread once it has written out everything left in the buffer, then close the file
+LogWriter::~LogWriter() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        dataReady.notify_one();
+        writer.join();
+    }
+    file.close();
+}
+
+// Return whether the file opened successfully
+bool LogWriter::IsOpen() {
+    return writer.joinable();
+}
+
+// Copy a whole record into the buffer in one go, so records from different threads never mix
+bool LogWriter::Write(const std::string &record) {
+    if (!IsOpen()) {
+        return false;
+    }
+    if (record.size() > buffer.size()) {
+        throw std::invalid_argument("LogWriter::Write: a record of " + std::to_string(record.size()) + " bytes does not fit in the buffer");
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    if (buffer.size() - used < record.size()) {
+        if (fullPolicy == DROP_RECORDS) {
+            droppedRecords++;
+            return false;
+        }
+
+        // Make sure the background thread is writing, then wait until it has made room
+        dataReady.notify_one();
+        spaceFree.wait(guard, [this, &record] { return buffer.size() - used >= record.size(); });
+    }
+
+    // The free space starts just after the waiting bytes, and may wrap round to the beginning of the buffer
+    size_t end = (start + used) % buffer.size();
+    size_t firstPiece = std::min(record.size(), buffer.size() - end);
+    memcpy(buffer.data() + end, record.data(), firstPiece);
+    memcpy(buffer.data(), record.data() + firstPiece, record.size() - firstPiece);
+    used += record.size();
+    bytesAdded += record.size();
+
+    if (used >= batchSize) {
+        dataReady.notify_one();
+    }
+    return true;
+}
+
+// Ask the background thread to write out the buffer now, and wait until it has
+void LogWriter::Flush() {
+    if (!IsOpen()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    uint64_t target = bytesAdded;
+    flushRequested = true;
+    dataReady.notify_one();
+    written.wait(guard, [this, target] { return bytesWritten >= target; });
+}
+
+// Return how many records were thrown away because the buffer was full
+long LogWriter::GetDroppedRecords() {
+    std::lock_guard<std::mutex> guard(lock);
+    return droppedRecords;
+}
+
+// The background thread: sleep until there is a batch to write (or the interval runs out), then write the waiting bytes
+// straight from the buffer. The lock is not held while writing, since Write only ever fills the free part of the buffer
+void LogWriter::WriterLoop() {
+    std::unique_lock<std::mutex> guard(lock);
+
+    while (true) {
+        dataReady.wait_for(guard, std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS), [this] {
+            return stopping || flushRequested || used >= batchSize;
+        });
+
+        if (used == 0) {
+            flushRequested = false;
+            written.notify_all();
+            if (stopping) {
+                break;
+            }
+            continue;
+        }
+
+        size_t batchStart = start;
+        size_t batchLength = used;
+        flushRequested = false;
+        guard.unlock();
+
+        size_t firstPiece = std::min(batchLength, buffer.size() - batchStart);
+        file.write(buffer.data() + batchStart, firstPiece);
+        file.write(buffer.data(), batchLength - firstPiece);
+        file.flush();
+
+        guard.lock();
+        start = (start + batchLength) % buffer.size();
+        used -= batchLength;
+        bytesWritten += batchLength;
+        spaceFree.notify_all();
+        written.notify_all();
+    }
+}
+
+// The program's one log for the game_stats.txt file
+LogWriter &GameStatsLog() {
+    static LogWriter log(GAME_STATS_FILE);
+    return log;
+}
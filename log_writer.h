@@ -0,0 +1,74 @@
+#ifndef LOG_WRITER_H
+#define LOG_WRITER_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+// The txt file every round's results are written to
+const std::string GAME_STATS_FILE = "game_stats.txt";
+// The default size of a log's buffer in bytes: it never holds more than this, however fast records come in
+const size_t DEFAULT_LOG_BUFFER_SIZE = 1 << 20;
+// How long a record can sit in the buffer before it is written out, even if the buffer is nearly empty
+const int LOG_FLUSH_INTERVAL_MS = 100;
+
+// What Write does with a record when the buffer is too full to take it
+enum LogFullPolicy {
+    // Wait for the background thread to write out enough of the buffer (nothing is ever lost, but tables slow down to the disk's speed)
+    WAIT_FOR_SPACE,
+    // Throw the record away and count it (tables never wait, but records are lost while the disk is behind)
+    DROP_RECORDS
+};
+
+/* Class created for appending records (such as each round's results) to a txt file without slowing down the tables writing them.
+   The file is opened once and kept open. Write copies a whole record into a fixed-size ring buffer, which any number of threads
+   can do at once, and a background thread writes the buffer out to the file in large batches: whenever it is a quarter full,
+   every LOG_FLUSH_INTERVAL_MS milliseconds, or when Flush is called. Records are never split up or mixed together in the file.
+   When the log is destroyed, everything still in the buffer is written out before the file is closed.
+*/
+class LogWriter {
+    public:
+        LogWriter(std::string fileName, size_t bufferSize = DEFAULT_LOG_BUFFER_SIZE, LogFullPolicy fullPolicy = WAIT_FOR_SPACE);
+        ~LogWriter();
+        bool IsOpen();
+        // Add a record to the buffer. Returns false if the file is not open or the record was dropped because the buffer was full.
+        // Throws std::invalid_argument if the record is larger than the whole buffer
+        bool Write(const std::string &record);
+        // Wait until every record written so far is in the file
+        void Flush();
+        long GetDroppedRecords();
+
+    private:
+        void WriterLoop();
+
+        std::ofstream file;
+        LogFullPolicy fullPolicy;
+        // The ring buffer: "used" bytes waiting to be written, starting at "start" and wrapping round to the beginning
+        std::vector<char> buffer;
+        size_t start;
+        size_t used;
+        // The background thread is woken early once this many bytes are waiting
+        size_t batchSize;
+        // Every byte ever added to the buffer, and every byte written out to the file, so Flush knows when it is done
+        uint64_t bytesAdded;
+        uint64_t bytesWritten;
+        long droppedRecords;
+        bool flushRequested;
+        bool stopping;
+        // Everything above is guarded by lock. The writer sleeps on dataReady, Write waits on spaceFree and Flush waits on written
+        std::mutex lock;
+        std::condition_variable dataReady;
+        std::condition_variable spaceFree;
+        std::condition_variable written;
+        std::thread writer;
+};
+
+// Return the log for GAME_STATS_FILE shared by the whole program, opening the file the first time it is needed.
+// It is closed, with everything written out, when the program exits
+LogWriter &GameStatsLog();
+
+#endif
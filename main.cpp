@@ -1,34 +1,78 @@
 #include <iostream>
-#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
 
 #include "player.h"
 #include "deck.h"
 #include "round.h"
+#include "game.h"
+#include "action.h"
+#include "log_writer.h"
+#include "screen_renderer.h"
+#include "hand_history.h"
+#include "simulation.h"
+#include "tournament.h"
+#include "replay.h"
+#include "strategy.h"
 
 // Function to take in an empty players vector, and populate it with a user-specified
 // number of players, each given a unique name. 
 void SetupTable(std::vector<Player> &players);
-// A function to return if there is still no winner based on the size of the players vector
-bool noWinner(std::vector<Player> &players);
-// A function that takes in the current round of the game (based on number of hands played)
-// and the players vector, and runs through an entire round of gameplay, returning the altered players vector accordingly
-std::vector<Player> PlayRound(std::vector<Player> &players, int roundNumber);
 // A function that takes in the players vector and exports the results of the finished game to a txt file
 int ExportWinnerInfo(std::vector<Player> &players);
+// A function that reads the options after "--simulate" from the command line, plays that many games between
+// the built-in strategies with no console input, and prints the results. Returns the program's exit code
+int RunSimulationMode(int argc, char *argv[]);
+// A function that reads the options after "--tournament" from the command line, plays multi-table tournaments between
+// the built-in strategies with no console input, and prints the results. Returns the program's exit code
+int RunTournamentMode(int argc, char *argv[]);
+// A function that plays every hand in the hand history file given after "--replay" again from its record,
+// checks each one comes out the same, and prints the results. Returns the program's exit code
+int RunReplayMode(int argc, char *argv[]);
+// Split a command line value such as "tight,call" at its commas
+std::vector<std::string> SplitList(const std::string &list);
 
-int main() {
+int main(int argc, char *argv[]) {
     std::vector<Player> players;
-    int roundNumber = 0;
+    // One deck for the whole game, reshuffled in place at the start of each round
+    Deck tableDeck;
+    // Every decision is typed in by the people playing at the console
+    ConsoleActionProvider consoleActions;
+
+    // Started as "game --simulate GAMES ...", play computer strategies against each other instead of a game at the console
+    if (argc > 1 && std::string(argv[1]) == "--simulate") {
+        return RunSimulationMode(argc, argv);
+    }
+    // Started as "game --tournament PLAYERS ...", play multi-table tournaments between computer strategies
+    if (argc > 1 && std::string(argv[1]) == "--tournament") {
+        return RunTournamentMode(argc, argv);
+    }
+    // Started as "game --replay FILE", play the hands recorded in a hand history file again and check they come out the same
+    if (argc > 1 && std::string(argv[1]) == "--replay") {
+        return RunReplayMode(argc, argv);
+    }
+    // Started as "game --quiet", play the console game without showing anything but the end of the game,
+    // reading the setup and every decision from the input (such as a file of answers piped in for a batch run)
+    if (argc > 1 && std::string(argv[1]) == "--quiet") {
+        ConsoleScreen().SetQuiet(true);
+    }
     
-    // Set up the table with a user specified number of players and has the user give each
-    // player a unique name
-    SetupTable(players);
+    // The game stops if the input ends before it does, keeping every hand finished so far in the hand history
+    try {
+        // Set up the table with a user specified number of players and has the user give each
+        // player a unique name
+        SetupTable(players);
+
+        // Every hand played at the console is also recorded in the hand history file, alongside the txt file
+        HandHistoryWriter history(HAND_HISTORY_FILE);
 
-    // While there is more than 1 player in the players vector
-    while (noWinner(players)) {
-        // Increment the start of a new round and then run the PlayRound function
-        roundNumber++;
-        players = PlayRound(players, roundNumber);
+        // Play rounds until only 1 player is left with chips
+        PlayGame(players, tableDeck, consoleActions, 0, true, Blinds(), history.IsOpen() ? &history : nullptr);
+    }
+    catch (const std::runtime_error &error) {
+        std::cout << "ERROR: " << error.what() << "\n";
+        return 1;
     }
 
     // Upon completion of the game, export the results to a txt file
@@ -42,125 +86,239 @@ int main() {
 // Function to take in an empty players vector, and populate it with a user-specified
 // number of players, each given a unique name.
 void SetupTable(std::vector<Player> &players) {
+    ScreenRenderer &screen = ConsoleScreen();
     std::string numPlayers;
     int chips;
 
     // Ask for the number of players, capping the number at 10 for deck-size reasons
-    std::cout << "Enter the number of players (max 10): ";
-    getline(std::cin, numPlayers);
+    screen << "Enter the number of players (max 10): ";
+    ReadConsoleAnswer(numPlayers);
     
     // While the answer is not within appropriate parameters (a number between 2 and 10)
-    while (!isdigit(numPlayers[0]) || (stoi(numPlayers) > 10 || stoi(numPlayers) < 2)) {
+    while (!isdigit(numPlayers[0]) || numPlayers.size() > 2 || (stoi(numPlayers) > 10 || stoi(numPlayers) < 2)) {
         // Keep asking until an acceptable answer is provided
-        std::cout << "Enter a number of players between 2 and 10: ";
-        getline(std::cin, numPlayers);
+        screen << "Enter a number of players between 2 and 10: ";
+        ReadConsoleAnswer(numPlayers);
     }
 
     int intNumPlayers = stoi(numPlayers);
+    std::vector<std::string> names;
 
     // Once the number of players is decided, ask for names of each player
     for (int i = 0; i < intNumPlayers; i++) {
         std::string name;
 
-        std::cout << "Enter the name of Player " << i + 1 << ": ";
-        std::cin >> name;
-
-        // Then create a new player with that name and insert it into the players vector
-        Player newPlayer = Player(name);
-        players.push_back(newPlayer);
+        screen << "Enter the name of Player " << i + 1 << ": ";
+        screen.Present();
+        if (!(std::cin >> name)) {
+            throw std::runtime_error("the input ended before every player was named");
+        }
+        names.push_back(name);
     }
 
-    // The last player inserted will be marked as the dealer so that when the dealer changes
-    // at the beginning of the first round, the new dealer will become the player at the 0 index
-    players.at(players.size() - 1).FlipDealerStat();
-}
+    // Reading the names leaves the end of the last line behind, so clear it before the game reads whole lines again
+    std::cin.ignore();
 
-// Return a boolean value for whether the size of the players vector is greater than 1
-bool noWinner(std::vector<Player> &players) {
-    return players.size() > 1;
+    // Then create a new player with each name, with the last player inserted marked as the dealer
+    SeatPlayers(players, names);
 }
 
-// A function that takes in the current round of the game (based on number of hands played)
-// and the players vector, and runs through an entire round of gameplay, returning the altered players vector accordingly
-std::vector<Player> PlayRound(std::vector<Player> &players, int roundNumber) {
-    Round currentRound = Round(players);
-    std::vector<int> cardAmounts = {3, 1, 1};
-    bool winnerByFolding = false;
+// A function that takes in the players vector and exports the results of the finished game to a txt file
+int ExportWinnerInfo(std::vector<Player> &players) {
+    // Check to make sure the game's log opened the file successfully
+    if (!GameStatsLog().IsOpen()) {
+        std::cout << "Could not open file: '" << GAME_STATS_FILE << "'\n";
 
-    // If it is the first round played, due to user input, clear the cin
-    if (roundNumber == 1) {
-        std::cin.ignore();
+        return 1;
     }
-    
-    // Then call the AssignDealer function, changing the dealer to the "next" player
-    // which is 1 higher in the players vector, going back to 0 once the end of the vector is reached
-    currentRound.AssignDealer();
-    // Then using the dealer's placement, collect the small and big blinds from the players to the "left"
-    // or 1 and 2 higher in the players vector, respectively
-    currentRound.CollectAnte();
-    // Then deal cards to every player in the players vector
-    currentRound.DealCards();
-    // Then run through a betting phase, requiring user input and altering the totalBet and chip total of all players 
-    // who have not folded
-    currentRound.PlaceBet(roundNumber);
-    // Then deal cards to the community hand and follow it with betting until all the community cards are dealt
-    // or everyone but one player has folded
-    for (size_t i = 0; i < cardAmounts.size(); i++) {
-        // If everyone but 1 player has folded, mark winnerByFolding as true
-        // and break out of the loop as no more cards are needed to be dealt
-        if (currentRound.CountFolded() == players.size() - 1) {
-            winnerByFolding = true;
-            break;
+
+    const Player &winner = players.at(0);
+
+    // Then export the name of the winner and that they won the game
+    // and export the amount the winning player managed to win over the course of the game
+    std::ostringstream record;
+    record << winner.GetName() << " won won the game!\n";
+    record << winner.GetName() << " managed to win a total of " << winner.GetChips() << " chips. Congratulations!\n";
+    GameStatsLog().Write(record.str());
+
+    // Finally, make sure the whole game is in the file before the program ends
+    GameStatsLog().Flush();
+
+    return 0;
+}
+
+// Read the simulation options from the command line, run the simulation and print its results
+int RunSimulationMode(int argc, char *argv[]) {
+    SimulationOptions options;
+    bool seedGiven = false;
+
+    try {
+        if (argc < 3) {
+            throw std::invalid_argument("--simulate needs the number of games to play");
         }
+        options.numGames = std::stol(argv[2]);
+
+        for (int i = 3; i < argc; i++) {
+            std::string argument = argv[i];
 
-        currentRound.DealCommunityCards(cardAmounts.at(i));
+            // Every option is followed by its value
+            if (i + 1 >= argc) {
+                throw std::invalid_argument(argument + " needs a value");
+            }
 
-        // If everyone has NOT either gone all in or folded, then run another betting round,
-        // Otherwise skip this step and deal the rest of the cards
-        if (currentRound.CountAllInAndFolded() < players.size() - 1) {
-            currentRound.PlaceBet();
+            if (argument == "--players") {
+                options.numPlayers = std::stoi(argv[++i]);
+            }
+            else if (argument == "--strategies") {
+                options.strategies = SplitList(argv[++i]);
+            }
+            else if (argument == "--threads") {
+                options.numThreads = std::stoi(argv[++i]);
+            }
+            else if (argument == "--seed") {
+                options.seed = std::stoull(argv[++i]);
+                seedGiven = true;
+            }
+            else if (argument == "--max-rounds") {
+                options.maxRounds = std::stoi(argv[++i]);
+            }
+            else if (argument == "--history") {
+                options.historyFile = argv[++i];
+            }
+            else if (argument == "--checkpoint") {
+                options.checkpointFile = argv[++i];
+            }
+            else if (argument == "--checkpoint-hands") {
+                options.checkpointHands = std::stol(argv[++i]);
+            }
+            else {
+                throw std::invalid_argument("unknown option " + argument);
+            }
         }
-        // If everyone but 1 player has folded, mark winnerByFolding as true
-        // and break out of the loop as no more cards are needed to be dealt
-        if (currentRound.CountFolded() == players.size() - 1) {
-            winnerByFolding = true;
-            break;
+        // Carrying on from a checkpoint means running the same simulation again, which needs the seed
+        if (!options.checkpointFile.empty() && !seedGiven) {
+            throw std::invalid_argument("--checkpoint needs --seed, so the same simulation can be run again to carry on from it");
         }
+
+        PrintSimulationResult(RunSimulation(options), options.numPlayers);
     }
-    // If more than one player has not folded
-    if (!winnerByFolding) {
-        // Then calculate handStats of each player's hand who is still currently not folded
-        currentRound.ScoreHands();
+    catch (const std::exception &error) {
+        std::cout << "ERROR: " << error.what() << "\n";
+        std::cout << "Usage: game --simulate GAMES [--players N] [--strategies NAME,NAME,...] [--threads N] [--seed N] [--max-rounds N]\n"
+                  << "                       [--history FILE] [--checkpoint FILE] [--checkpoint-hands N]\n";
+        std::cout << "Strategies:";
+        for (const std::string &name : StrategyNames()) {
+            std::cout << " " << name;
+        }
+        std::cout << "\n";
+        return 1;
     }
-    
-    // Then use those calculated stats, or the winnerByFolding boolean, to divide up the winnings of the hand appropriately
-    // DivvyPots also resets the players' hands and removes players who have run out of chips, returning the resultant players vector
-    return currentRound.DivvyPots(roundNumber, winnerByFolding);
+
+    return 0;
 }
 
-// A function that takes in the players vector and exports the results of the finished game to a txt file
-int ExportWinnerInfo(std::vector<Player> &players) {
-    std::ofstream dataFile;
+// Read the tournament options from the command line, play the tournaments and print their results
+int RunTournamentMode(int argc, char *argv[]) {
+    TournamentOptions options;
+    bool seedGiven = false;
 
-    // Open the file for appending and check itt make sure it opened successfully
-    dataFile.open("game_stats.txt", std::ios_base::app);
+    try {
+        if (argc < 3) {
+            throw std::invalid_argument("--tournament needs the number of players in each tournament");
+        }
+        options.numPlayers = std::stoi(argv[2]);
+
+        for (int i = 3; i < argc; i++) {
+            std::string argument = argv[i];
+
+            // Every option is followed by its value
+            if (i + 1 >= argc) {
+                throw std::invalid_argument(argument + " needs a value");
+            }
 
-    if (!dataFile.is_open()) {
-        std::cout << "Could not open file: 'game_stats.txt'\n";
+            if (argument == "--tournaments") {
+                options.numTournaments = std::stoi(argv[++i]);
+            }
+            else if (argument == "--table-size") {
+                options.tableSize = std::stoi(argv[++i]);
+            }
+            else if (argument == "--chips") {
+                options.startingChips = std::stoi(argv[++i]);
+            }
+            else if (argument == "--strategies") {
+                options.strategies = SplitList(argv[++i]);
+            }
+            else if (argument == "--hands-per-step") {
+                options.handsPerStep = std::stoi(argv[++i]);
+            }
+            else if (argument == "--hands-per-level") {
+                options.handsPerLevel = std::stoi(argv[++i]);
+            }
+            else if (argument == "--threads") {
+                options.numThreads = std::stoi(argv[++i]);
+            }
+            else if (argument == "--seed") {
+                options.seed = std::stoull(argv[++i]);
+                seedGiven = true;
+            }
+            else if (argument == "--checkpoint") {
+                options.checkpointFile = argv[++i];
+            }
+            else if (argument == "--checkpoint-hands") {
+                options.checkpointHands = std::stol(argv[++i]);
+            }
+            else {
+                throw std::invalid_argument("unknown option " + argument);
+            }
+        }
+        // Carrying on from a checkpoint means running the same tournaments again, which needs the seed
+        if (!options.checkpointFile.empty() && !seedGiven) {
+            throw std::invalid_argument("--checkpoint needs --seed, so the same tournaments can be run again to carry on from them");
+        }
 
+        PrintTournamentResult(RunTournaments(options), options);
+    }
+    catch (const std::exception &error) {
+        std::cout << "ERROR: " << error.what() << "\n";
+        std::cout << "Usage: game --tournament PLAYERS [--tournaments N] [--table-size N] [--chips N] [--strategies NAME,NAME,...]\n"
+                  << "                         [--hands-per-step N] [--hands-per-level N] [--threads N] [--seed N]\n"
+                  << "                         [--checkpoint FILE] [--checkpoint-hands N]\n";
+        std::cout << "Strategies:";
+        for (const std::string &name : StrategyNames()) {
+            std::cout << " " << name;
+        }
+        std::cout << "\n";
         return 1;
     }
 
-    Player winner = players.at(0);
+    return 0;
+}
 
-    // Then export the name of the winner and that they won the game
-    // and export the amount the winning player managed to win over the course of the game
-    dataFile << winner.GetName() << " won won the game!\n";
-    dataFile << winner.GetName() << " managed to win a total of " << winner.GetChips() << " chips. Congratulations!";
-    dataFile << std::endl;
+// Replay the hand history file named on the command line and print the results
+int RunReplayMode(int argc, char *argv[]) {
+    try {
+        if (argc != 3) {
+            throw std::invalid_argument("--replay needs the hand history file to replay");
+        }
 
-    // Finally, close the file when exporting is complete
-    dataFile.close();
+        ReplayResult result = ReplayHandHistory(argv[2]);
+        PrintReplayResult(result);
+        return result.mismatchedGames == 0 ? 0 : 1;
+    }
+    catch (const std::exception &error) {
+        std::cout << "ERROR: " << error.what() << "\n";
+        std::cout << "Usage: game --replay FILE\n";
+        return 1;
+    }
+}
 
-    return 0;
-}
\ No newline at end of file
+// Split a list such as "tight,call" into its names
+std::vector<std::string> SplitList(const std::string &list) {
+    std::istringstream names(list);
+    std::string name;
+    std::vector<std::string> result;
+    while (getline(names, name, ',')) {
+        result.push_back(name);
+    }
+    return result;
+}
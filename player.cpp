@@ -1,60 +1,88 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <stdexcept>
 
 #include "player.h"
+#include "hand_evaluator.h"
 
-// Initializer, creating a new player with 50 chips and no starting bet
+// Initializer, creating a new player with the given chips (50 unless told otherwise) and no starting bet
 // Also assigning the player with the input name
-Player::Player(std::string name) {
+Player::Player(std::string name, int chips) {
     this->name = name;
-    this->chips = 50;
+    this->chips = chips;
+    hand = 0;
     totalBet = 0;
+    handKey = 0;
     dealer = false;
     folded = false;
 }
 
 // A testing function to check to make sure hand analyzing functions are correct
 void Player::PrintHandStats() {
-    for (size_t i = 0; i < handStats.size(); i++) {
-        std::cout << handStats.at(i) << " ";
+    for (int i = 0; i < NUM_HAND_STATS; i++) {
+        std::cout << GetHandStat(i) << " ";
     }
     // Print the hand to compare with the handStats that the computer assesses
     PrintHand();
 }
 
 // A getter for chips
-int Player::GetChips() {
+int Player::GetChips() const {
     return chips;
 }
 
 // A getter for the player's name
-std::string Player::GetName() {
+const std::string &Player::GetName() const {
     return name;
 }
 
 // A getter for the total amount bet within a hand
-int Player::GetTotalBet() {
+int Player::GetTotalBet() const {
     return totalBet;
 }
 
-// A getter for the determined quality of the hand (more detail below)
-std::vector<int> Player::GetHandStats() {
-    return handStats;
+// A getter for the determined quality of the hand, packed into a single hand key
+// Comparing two players' keys as integers tells which hand is better (more detail in hand_evaluator.h)
+unsigned int Player::GetHandKey() const {
+    return handKey;
 }
 
-// A getter for the hand itself
-std::vector<Card> Player::GetHand() {
+// Read one of the six handStats values out of the packed handKey
+// Index 0 is the type of hand and indices 1-5 are the deciding card numbers
+int Player::GetHandStat(int index) const {
+    if (index < 0 || index >= NUM_HAND_STATS) {
+        throw std::out_of_range("Player::GetHandStat: no handStats value at index " + std::to_string(index));
+    }
+
+    if (index == 0) {
+        return HandKeyCategory(handKey);
+    }
+    return HandKeyValue(handKey, index);
+}
+
+// Write one of the six handStats values into its 4-bit field of the packed handKey
+void Player::SetHandStat(int index, int value) {
+    if (index < 0 || index >= NUM_HAND_STATS) {
+        throw std::out_of_range("Player::SetHandStat: no handStats value at index " + std::to_string(index));
+    }
+
+    int shift = index == 0 ? HAND_KEY_CATEGORY_SHIFT : HAND_KEY_VALUE_BITS * (5 - index);
+    handKey = (handKey & ~(0xFu << shift)) | (value << shift);
+}
+
+// A getter for the hand itself, as the set of cards the player holds
+CardMask Player::GetHand() const {
     return hand;
 }
 
 // A getter for whether the player has folded
-bool Player::GetFoldedStat() {
+bool Player::GetFoldedStat() const {
     return folded;
 }
 
 // A getter for whether the player is all-in
-bool Player::GetAllInStat() {
+bool Player::GetAllInStat() const {
     // If the player doesn't have chips, the player is all-in
     if (!chips) {
         return true;
@@ -103,16 +131,18 @@ void Player::SubtractTotalBet(int lostAmount) {
 
 // Delete all the cards in the player's hand before starting a new round
 void Player::EmptyHand() {
-    hand.clear();
+    hand = 0;
+    sortedHand.clear();
+    streetHand.Reset();
 }
 
 // Delete the previous hand's stats before starting a new round
 void Player::EmptyHandStats() {
-    handStats = {0, 0, 0, 0, 0, 0};
+    handKey = 0;
 }
 
 // A getter for determing if the current player is marked as the dealer
-bool Player::isDealer() {
+bool Player::isDealer() const {
     return dealer;
 }
 
@@ -128,98 +158,57 @@ void Player::FlipDealerStat() {
 }
 
 // Receive the ante amount and subtract the chips necessary and add it to the totalBet
+// A player with fewer chips than the ante puts in all they have and is all-in
 void Player::Ante(int amount) {
+    if (amount > chips) {
+        amount = chips;
+    }
     chips -= amount;
     totalBet += amount;
 }
 
-// Receive a card, place it in "hand", and then sort the cards as necessary
+// Receive a card and add it to the set of cards in "hand"
+// The set keeps itself in order, so no sorting is needed
 void Player::TakeCard(Card dealtCard) {
-    // If the hand will have more than one card when taking the given card, 
-    // start sorting cards
-    if (hand.size() >= 1) {
-        SortHand(dealtCard);
-    }
-    // Otherwise, just add the card to the "hand" vector
-    else {
-        hand.push_back(dealtCard);
-    }
+    hand |= dealtCard.GetCardMask();
+    streetHand.AddCards(dealtCard.GetCardMask());
 }
 
-// Order the cards from lowest to highest
+// Receive the community cards dealt on the latest street (flop, turn or river)
+// and bring the player's best hand so far up to date, so handKey (and GetBestHand)
+// always describes the best hand the player can currently make
+void Player::AddCommunityCards(CardMask newCards) {
+    streetHand.AddCards(newCards);
+    handKey = streetHand.GetHandKey();
+}
+
+// Order the cards in sortedHand from lowest to highest, with Aces counted high, for the reference hand checks
 void Player::SortHand(Card dealtCard) {
     // Go through the hand until the dealt card finds a card that is bigger than (or equal to) it
     // If it finds a bigger card, insert the dealt card just before the bigger card and end the function
-    for (size_t i = 0; i < hand.size(); i++) {
-        if (dealtCard.GetCardNumber() <= hand.at(i).GetCardNumber()) {
-            hand.insert(hand.begin() + i, dealtCard);
+    for (size_t i = 0; i < sortedHand.size(); i++) {
+        if (dealtCard.GetHighCardNumber() <= sortedHand.at(i).GetHighCardNumber()) {
+            sortedHand.insert(sortedHand.begin() + i, dealtCard);
             return;
         }
     }
 
     // If it doesn't find a bigger card, just put the dealt card at the back of the hand
-    hand.push_back(dealtCard);
+    sortedHand.push_back(dealtCard);
 }
 
-// A function to interact with the human player when betting chips
-int Player::BetChips(int highestBet) {
-    std::string bet;
+// Raise the bet: match the current highestBet and then put "raiseAmount" more chips on top of it.
+// The amount must be between 1 and the chips left after calling; Round makes sure of that before calling this
+int Player::RaiseBet(int highestBet, int raiseAmount) {
     int callingCost = highestBet - totalBet;
 
-    // Check if the amount to call the current bet is too high for the current player to raise it
-    // For example, if the current highest bet is 5, but the player only has 5 (or less),
-    // the player cannot raise and bet 6. They are then limited to going all-in or folding
-    if (callingCost >= chips) {
-        // Explain their situation and offer a new choice
-        std::string choice;
-        std::cout << "You do not have enough chips to raise the current max bet. Would you like to go (a)ll-in or (f)old?\n";
-        getline(std::cin, choice);
-
-        // Loop to make sure the player inputs a readable response
-        while (choice != "a" && choice != "a") {
-            std::cout << "Select either 'a' for all-in or 'f' for fold: ";
-
-            getline(std::cin, choice);
-        }
-
-        // If the player selects "all-in" 
-        if (choice == "a") {
-            // If the player has less than the calling cost,
-            // adjust the calling cost so player only puts in what they have
-            if (chips < callingCost) {
-                callingCost = chips;
-            }
-            chips -= callingCost;
-            totalBet += callingCost;
-            return callingCost;
-        }
-        // Otherwise return 0, which will be interpreted as folding in the Round function
-        else {
-            return 0;
-        }
-    }
-
-    // Otherwise, ask how much the player would like to raise
-    std::cout << "How much would you like to raise?";
-    std::cout << " (Enter a number between 1 and " << chips - callingCost << "): ";
-    getline(std::cin, bet);
-
-    // Loop to ensure the player only raises an amount they have
-    while (!isdigit(bet[0]) || (stoi(bet) < 1 || stoi(bet) > chips - callingCost)) {
-        std::cout << "Not a valid raise amount.";
-        std::cout << " Enter a number between 1 and " << chips - callingCost << ": ";
-        getline(std::cin, bet);
-    }
+    // Subtract the raise amount and the calling cost from their chips
+    // and add that total amount to their totalBet
+    chips -= raiseAmount + callingCost;
+    totalBet += raiseAmount + callingCost;
 
-    int betInt = stoi(bet);
-
-    // Once the raise amount is determined, subtract that amount from their chips
-    // and add that total amount (including the calling cost) to their totalBet
-    chips -= betInt + callingCost;
-    totalBet += betInt + callingCost;
-
-    // Then return the total amount they are adding (just to make sure it isn't 0)
-    return betInt + callingCost;
+    // Then return the total amount they are adding
+    return raiseAmount + callingCost;
 }
 
 // Function to handle calling as opposed to raising
@@ -240,30 +229,33 @@ void Player::CallBet(int highestBet) {
 
 // A print function so that cards are printed as words and not the number vector
 // Used to show players what they have when betting for each round
-void Player::PrintHand() {
+void Player::PrintHand() const {
+    Card cards[7];
+    int numCards = MaskToCards(hand, cards);
+
     // For each card, print to the console its string version
-    for (int i = 0; i < hand.size(); i++) {
-        std::cout << hand.at(i).GetCardString();
+    for (int i = 0; i < numCards; i++) {
+        std::cout << cards[i].GetCardString();
         
         // Add ", " or ", and " depending on where it is in the sequence 
-        if ((hand.size() == 2 && i == 0) || (hand.size() > 2 && i == hand.size()- 2)) {
+        if ((numCards == 2 && i == 0) || (numCards > 2 && i == numCards - 2)) {
             std::cout << ", and ";
         }
-        else if (i != hand.size() - 1) {
+        else if (i != numCards - 1) {
             std::cout << ", ";
         }
     }
 }
 
-// Return a string represntation of the winner's handStats
+// Return a string represntation of the winner's handStats, read out of the packed handKey
 // For example, if they had {10, 14, 0, 0, 0, 0} as the handStats,
 // this function would return "a Royal flush, with Ace high"
-std::string Player::GetBestHand() {
+std::string Player::GetBestHand() const {
     // Create the string that all the words will be added to
     std::string handStat = "";
 
     // Use a switch to address the 10 different winning hand types
-    switch(handStats.at(0)) {
+    switch(GetHandStat(0)) {
         case 10:
             handStat += "a Royal flush";
             break;
@@ -272,9 +264,9 @@ std::string Player::GetBestHand() {
             break;
         case 8:
             // Incorporate the use of StringifyCardNumber to return the highest card number as a string
-            return "a four-of-a-kind of " + StringifyCardNumber(handStats.at(1)) + "s";
+            return "a four-of-a-kind of " + StringifyCardNumber(GetHandStat(1)) + "s";
         case 7:
-            return "a full house, " + StringifyCardNumber(handStats.at(1)) + "s over " + StringifyCardNumber(handStats.at(2)) + "s";
+            return "a full house, " + StringifyCardNumber(GetHandStat(1)) + "s over " + StringifyCardNumber(GetHandStat(2)) + "s";
         case 6:
             handStat += "a flush";
             break;
@@ -282,11 +274,11 @@ std::string Player::GetBestHand() {
             handStat += "a straight";
             break;
         case 4:
-            return "a three-of-a-kind of " + StringifyCardNumber(handStats.at(1)) + "s";
+            return "a three-of-a-kind of " + StringifyCardNumber(GetHandStat(1)) + "s";
         case 3:
-            return "two pair, with " + StringifyCardNumber(handStats.at(1)) + "s over " + StringifyCardNumber(handStats.at(2)) + "s";
+            return "two pair, with " + StringifyCardNumber(GetHandStat(1)) + "s over " + StringifyCardNumber(GetHandStat(2)) + "s";
         case 2:
-            return "a pair of " + StringifyCardNumber(handStats.at(1)) + "s";
+            return "a pair of " + StringifyCardNumber(GetHandStat(1)) + "s";
         case 0:
             return "No hand stats yet!";
     }
@@ -295,17 +287,17 @@ std::string Player::GetBestHand() {
     // If something has been added via the switch before this point,
     if (handStat.size() > 0) {
         // Append the high card to that existing string
-        return handStat + ", " + StringifyCardNumber(handStats.at(1)) + " high";
+        return handStat + ", " + StringifyCardNumber(GetHandStat(1)) + " high";
     }
     // Otherwise just return the high card as the best hand
     else {
-        return "a(n) " + StringifyCardNumber(handStats.at(1)) + " high";
+        return "a(n) " + StringifyCardNumber(GetHandStat(1)) + " high";
     }
 }
 
 // Address the string versions of 11(Jack), 12(Queen), 13(King), 14/1(Ace), and 2(Deuce)
 // Otherwise just return a string version of the card number
-std::string Player::StringifyCardNumber(int card) {
+std::string Player::StringifyCardNumber(int card) const {
     if (card > 2 && card < 11) {
         return std::to_string(card);
     }
@@ -327,10 +319,27 @@ std::string Player::StringifyCardNumber(int card) {
 }
 
 
-// This function looks through the entire hand and determines the best 
+// This function looks through the player's two cards and the five community cards and determines
+// the best possible combination of 5 cards according to the rules of the game, storing it as the handKey.
+// Unlike EvaluateCardsReference, the player's hand is left untouched
+int Player::EvaluateCards(CardMask communityHand) {
+    // If every community card was already passed in through AddCommunityCards, the hand key is already up to date
+    if (streetHand.GetCards() == (hand | communityHand)) {
+        handKey = streetHand.GetHandKey();
+    }
+    else {
+        handKey = EvaluateHand(hand | communityHand);
+    }
+
+    // Return the type of hand, the same value the handStats checks return
+    return HandKeyCategory(handKey);
+}
+
+// The original way of evaluating the hand, kept as a reference for checking the lookup tables
+// behind EvaluateCards. This looks through the entire hand and determines the best 
 // possible combination of 5 cards according to the rules of the game
-int Player::EvaluateCards(std::vector<Card> &communityHand) {
-    // Before evaluating the hand, add the community cards to each player's hand
+int Player::EvaluateCardsReference(CardMask communityHand) {
+    // Before evaluating the hand, lay out the player's cards along with the community cards
     // And order each card within the hand from smallest to biggest
     CombineHands(communityHand);
 
@@ -342,255 +351,128 @@ int Player::EvaluateCards(std::vector<Card> &communityHand) {
         CheckForHighCard();
 }
 
-// For each community hand card, use the TakeCard function to take each card
-// one at a time and then sort it into the player's hand
-void Player::CombineHands(std::vector<Card> &communityHand) {
-    for (size_t i = 0; i < communityHand.size(); i++) {
-        TakeCard(communityHand.at(i));
+// Lay out the player's cards and the community cards in order within sortedHand,
+// using the SortHand function to take each card one at a time and sort it in with the others
+void Player::CombineHands(CardMask communityHand) {
+    Card cards[7];
+    int numCards = MaskToCards(hand | communityHand, cards);
+
+    sortedHand.clear();
+    for (int i = 0; i < numCards; i++) {
+        SortHand(cards[i]);
     }
 }
 
 // Start the search for the best possible hand, a straight flush 
 // For example: 7, 8, 9, 10, and Jack of spades
 int Player::CheckForStraightFlush() {
-    /* Create trackers for the number of cards currently in the straight, starting at one,
-    because each card is a straight of one
-    Then create a tracker for the highest card in the straight and the highest count 
-    for if there are multiple straights of various lengths
-    for example: 2, 3, 7, 8, 9 has two straights, one of length 2 and one of length 3
-    */
-    int numForStraight = 1;
-    int highestCardIndex;
-    int highestStraightCount = 0;
-
-    // Then cycle through each suit, searching for a straight using only cards of that suit
-    for (size_t suit = 1; suit < 5; suit++) {
-        Card previousCard;
-        Card currentCard;
-        int numCardsInSuit = 1;
-
-        // For each card in the hand, check if the card is of the specified suit
-        for (size_t i = 0; i < hand.size(); i++) {
-            if (hand.at(i).GetCardSuit() == suit) {   
-                currentCard = hand.at(i);
-                
-                // If this is the first card found in the suit, ignore these steps
-                if (numCardsInSuit > 1) {
-                    // Otherwise, check if the current card is a step above the previous card found in the suit
-                    if (currentCard.GetCardNumber() - 1 != previousCard.GetCardNumber() && currentCard.GetCardNumber() != previousCard.GetCardNumber()) {
-                        numForStraight = 1;
-                    }
-                    // If the currentCard number is bigger by 1, then mark it as part of a straight
-                    else if (currentCard.GetCardNumber() - 1 == previousCard.GetCardNumber()) {
-                        numForStraight++;
-                        if (numForStraight > highestStraightCount) {
-                            highestStraightCount = numForStraight;
-                            highestCardIndex = i;
-                        }
-                    }
-                }
-                // Then mark what was the currentCard as the previousCard and increment the number of cards in the suit
-                previousCard = hand.at(i);
-                numCardsInSuit++;
-            }
+    int highestCard = 0;
+
+    // Cycle through each suit, searching for a straight using only cards of that suit,
+    // and keep the highest straight found (only one suit can hold 5 or more cards, but this keeps the check simple)
+    for (int suit = 1; suit < 5; suit++) {
+        int suitHighCard = FindHighestStraight(suit);
+        if (suitHighCard > highestCard) {
+            highestCard = suitHighCard;
         }
-
-        numForStraight = 1;
     }
 
-    // If the highest straight count is 4 or greater and the highest card in the straight is a king and the lowest card in the hand is an ace,
-    // check if the ace is of the highest straight suit. If it is, the player has a Royal flush (rated 10)
-    if (highestStraightCount >= 4 && hand.at(highestCardIndex).GetCardNumber() == 13 && hand.at(0).GetCardNumber() == 1) {
-        size_t i = 0;
-        while (hand.at(i).GetCardNumber() == 1) {
-            if (hand.at(i).GetCardSuit() == hand.at(highestCardIndex).GetCardSuit()) {
-                handStats.at(0) = 10;
-                break;
-            }
-
-            i++;
-        }
+    // If the straight runs up to the Ace, the player has a Royal flush (rated 10)
+    if (highestCard == 14) {
+        SetHandStat(0, 10);
+        SetHandStat(1, 14);
     }
-    // Otherwise, if the straight is not Royal, but is of 5 or more cards,
-    // It is a straight flush (rated 9), and the highest card is marked in the handStats vector
-    else if (highestStraightCount >= 5) {
-        handStats.at(0) = 9;
-        handStats.at(1) = hand.at(highestCardIndex).GetCardNumber();
+    // Otherwise, any other straight of one suit is a straight flush (rated 9),
+    // and the highest card is marked in the handStats
+    else if (highestCard) {
+        SetHandStat(0, 9);
+        SetHandStat(1, highestCard);
     }
 
-    // Regardless of what is found, return the first number in the handStats vector
+    // Regardless of what is found, return the first number in the handStats
     // If it is 0, then the next possible winning hand type will be checked. If it is not zero,
     // the EvaluateCards function will return the vector showing this as the winning hand type
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
 // After checking for a straight flush, if necessary, check for 4-of-a-kind
 int Player::CheckForFourOfAKind() {
     // Use the LookForSets function, specifying looking for 4 of the same card number
     int cardIndex = LookForSets(4);
-    // If LookForSets does not return zero, then a 4-of-a-kind was found and the handStats vector is marked appropriately
+    // If LookForSets does not return zero, then a 4-of-a-kind was found and the handStats is marked appropriately
     if (cardIndex != 0) {
-        handStats.at(0) = 8;
-        handStats.at(1) = hand.at(cardIndex).GetCardNumber();
+        SetHandStat(0, 8);
+        SetHandStat(1, sortedHand.at(cardIndex).GetHighCardNumber());
         // Then the remaining card that is not of the 4-of-a-kind is selected as the highest card, in case of a tie
         GrabCardsInOrder(1);
     }
 
     // Then return the handStats first value
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
 // If a 4-of-a-kind is not present, check for full house (a pair and a 3-of-a-kind)
 int Player::CheckForFullHouse() {
-    int trioIndex;
-    int pairIndex;
-
-    // Use the LookForSets function looking for higher 3-of-a-kind and then lower pair
-    trioIndex = LookForSets(3);
-    pairIndex = LookForSets(2, trioIndex);
-
-    // Do a second check in case the pair found consists of a 3-of-a-kind of Aces 
-    // that should be marked as the higher set
-    if (trioIndex && pairIndex && hand.at(pairIndex).GetCardNumber() == 1) {
-        if (LookForSets(3, 3)) {
-            handStats.at(0) = 7;
-            handStats.at(1) = 14;
-            handStats.at(2) = hand.at(trioIndex).GetCardNumber();
-        }
-    }
-    // Do a check in case there is an Ace pair that is not found
-    else if (trioIndex && pairIndex && hand.at(0).GetCardNumber() == 1) {
-        if (LookForSets(2, 2)) {
-            handStats.at(0) = 7;
-            handStats.at(1) = hand.at(trioIndex).GetCardNumber();
-            handStats.at(2) = 14;
-        }
-        else {
-            handStats.at(0) = 7;
-            handStats.at(1) = hand.at(trioIndex).GetCardNumber();
-            handStats.at(2) = hand.at(pairIndex).GetCardNumber();
-        }
+    // Use the LookForSets function looking for the highest 3-of-a-kind, and then the highest pair
+    // of any other card number. A second 3-of-a-kind also counts as the pair, since only 2 of its cards are needed
+    int trioIndex = LookForSets(3);
+    int pairIndex = 0;
+    if (trioIndex) {
+        pairIndex = LookForSets(2, trioIndex);
     }
-    // If both are found and no Aces present, mark the handStats accordingly
-    else if (trioIndex && pairIndex) {
-        handStats.at(0) = 7;
-        handStats.at(1) = hand.at(trioIndex).GetCardNumber();
-        handStats.at(2) = hand.at(pairIndex).GetCardNumber();
 
-    }
-    // If they are not found, check for a higher pair and a lower 3-of-a-kind
-    else {
-        pairIndex = LookForSets(2);
-        trioIndex = LookForSets(3, pairIndex);
-        if (trioIndex && pairIndex) {
-            handStats.at(0) = 7;
-            handStats.at(1) = hand.at(trioIndex).GetCardNumber();
-            handStats.at(2) = hand.at(pairIndex).GetCardNumber();
-        }
+    // If both are found, mark the handStats accordingly
+    if (trioIndex && pairIndex) {
+        SetHandStat(0, 7);
+        SetHandStat(1, sortedHand.at(trioIndex).GetHighCardNumber());
+        SetHandStat(2, sortedHand.at(pairIndex).GetHighCardNumber());
     }
 
     // Return the handStats first value
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
 // If there is no full house present, check for flush (5 cards of the same suit)
 int Player::CheckForFlush() {
-    int cardsInFlush = 1;
-    int suitToFind;
-
-    // Loop through the last 3 cards, starting with the highest card and going down
-    // Only the last 3 cards are necessary because the flush requires 5 cards, and if
-    // the 4th from the end is checked, only 4 cards total will be possible to be able to match that card's suit
-    for (int i = hand.size() - 1; i >= 4; i--) {
-        // Then do a second loop checking against the highest card to see if 4 other cards are of the same suit
-        for (int j = i - 1; j >= 0; j--) {
-            if (hand.at(i).GetCardSuit() == hand.at(j).GetCardSuit()) {
+    // Count the cards of each suit until one is found with 5 or more cards
+    for (int suit = 1; suit < 5; suit++) {
+        int cardsInFlush = 0;
+
+        for (size_t i = 0; i < sortedHand.size(); i++) {
+            if (sortedHand.at(i).GetCardSuit() == suit) {
                 cardsInFlush++;
-                // If a flush is found with 5 cards, mark the handStats appropriately
-                if (cardsInFlush == 5) {
-                    handStats.at(0) = 6;
-                    handStats.at(1) = hand.at(i).GetCardNumber();
-                    suitToFind = hand.at(i).GetCardSuit();
-                }
             }
         }
-        // If the next card from the back is checked, cardsInFlush returns to 1 card
-        cardsInFlush = 1;
-    }
-
-    // If a flush of 5 cards was found, 
-    // to find the other cards in decending order for the handStats vector,
-    // cycle through the cards in the hand again, looking for cards that match the suitToFind
-    if (handStats.at(0)) {
-        int grabbedCards = 0;
-        int i = 0;
-        int handStatsIndex = 2;
-
-        // Check first, though, for an Ace of that suit, to mark it as 14 (high card)
-        while (hand.at(i).GetCardNumber() == 1) {
-            if (hand.at(i).GetCardSuit() == suitToFind) {
-                handStats.at(1) = 14;
-                break;
-            }
 
-            i++;
-        }
+        // If a flush is found, mark the handStats with the 5 highest cards of that suit, going down from the highest card
+        if (cardsInFlush >= 5) {
+            int handStatsIndex = 1;
+            SetHandStat(0, 6);
 
-        // Then set the index at the highest card
-        i = hand.size() - 1;
-
-        // Until 4 other cards have been found in decending order of the appropriate suit, keep looping
-        while (grabbedCards < 4) {
-            // Check if the current card being looked at is part of the handStats vector already, and thus should be ignored
-            if (hand.at(i).GetCardNumber() != handStats.at(1) && hand.at(i).GetCardSuit() == suitToFind) {
-                // If it isn't, add it to the handStats vector and increment the grabbedCards variable
-                handStats.at(handStatsIndex) = hand.at(i).GetCardNumber();
-                handStatsIndex++;
-                grabbedCards++;
+            for (int i = sortedHand.size() - 1; i >= 0 && handStatsIndex < NUM_HAND_STATS; i--) {
+                if (sortedHand.at(i).GetCardSuit() == suit) {
+                    SetHandStat(handStatsIndex, sortedHand.at(i).GetHighCardNumber());
+                    handStatsIndex++;
+                }
             }
-
-            i--;
+            break;
         }
     }
 
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
-/* If there is no flush, check for a straight (not flush)
-   Following similar logic to the straight flush check,
-   this looks at the current card and the card after. If those two cards are only 1 apart, 
-   mark it as part of a straight
-*/
+// If there is no flush, check for a straight (not flush), using the cards of every suit
 int Player::CheckForStraight() {
-    int numForStraight = 1;
-    int highestCardIndex;
-    int highestStraightCount = 0;
-
-    for (size_t i = 0; i < hand.size() - 1; i++) {
-        if (hand.at(i).GetCardNumber() + 1 != hand.at(i + 1).GetCardNumber() && hand.at(i).GetCardNumber() != hand.at(i + 1).GetCardNumber()) {
-            numForStraight = 1;
-        }
-        else if (hand.at(i).GetCardNumber() + 1 == hand.at(i + 1).GetCardNumber()) {
-            numForStraight++;
-            if (numForStraight > highestStraightCount) {
-                highestStraightCount = numForStraight;
-                highestCardIndex = i + 1;
-            }
-        }
-    }
+    int highestCard = FindHighestStraight(0);
 
-    // Check for a straight that has ace high
-    if (highestStraightCount >= 4 && hand.at(highestCardIndex).GetCardNumber() == 13 && hand.at(0).GetCardNumber() == 1) {
-        handStats.at(0) = 5;
-        handStats.at(1) = 14;
-    }
-    // If it is not a straight with ace high, but still a straight of 5 or more cards, mark the handStats vector appropriately
-    else if (highestStraightCount >= 5) {
-        handStats.at(0) = 5;
-        handStats.at(1) = hand.at(highestCardIndex).GetCardNumber();
+    // If a straight of 5 cards was found, mark the handStats with its highest card
+    if (highestCard) {
+        SetHandStat(0, 5);
+        SetHandStat(1, highestCard);
     }
 
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
 // If there is no straight present, check for a three-of-a-kind
@@ -600,13 +482,13 @@ int Player::CheckForThreeOfAKind() {
 
     // If a 3-of-a-kind was found, mark the handStats appropriately
     if (trioIndex) {
-        handStats.at(0) = 4;
-        handStats.at(1) = hand.at(trioIndex).GetCardNumber();
+        SetHandStat(0, 4);
+        SetHandStat(1, sortedHand.at(trioIndex).GetHighCardNumber());
         // Then get the next two highest cards
         GrabCardsInOrder(2);
     }
 
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
 // If there is no 3-of-a-kind, check for 2 pair (2, 2, 5, 5)
@@ -614,26 +496,22 @@ int Player::CheckForTwoPair() {
     int firstPairIndex = 0;
     int secondPairIndex = 0;
 
-    // Use the LookForSets function to find the first pair, and then a lower pair afterwards
+    // Use the LookForSets function to find the highest pair, and then the highest pair of any other card number
     firstPairIndex = LookForSets(2);
-    secondPairIndex = LookForSets(2, firstPairIndex);
-
-    // If the two pair were found and one of those pair is an ace pair, mark it as high
-    if ((firstPairIndex && secondPairIndex) && hand.at(secondPairIndex).GetCardNumber() == 1) {
-        handStats.at(0) = 3;
-        handStats.at(1) = 14;
-        handStats.at(2) = hand.at(firstPairIndex).GetCardNumber();
-        GrabCardsInOrder(1);
+    if (firstPairIndex) {
+        secondPairIndex = LookForSets(2, firstPairIndex);
     }
-    // Otherwise just use the usual higher pair first and then lower pair.
-    else if (firstPairIndex && secondPairIndex) {
-        handStats.at(0) = 3;
-        handStats.at(1) = hand.at(firstPairIndex).GetCardNumber();
-        handStats.at(2) = hand.at(secondPairIndex).GetCardNumber();
+
+    // If the two pair were found, mark the higher pair first and then the lower pair,
+    // followed by the highest remaining card (which can come from a third pair)
+    if (firstPairIndex && secondPairIndex) {
+        SetHandStat(0, 3);
+        SetHandStat(1, sortedHand.at(firstPairIndex).GetHighCardNumber());
+        SetHandStat(2, sortedHand.at(secondPairIndex).GetHighCardNumber());
         GrabCardsInOrder(1);
     }
 
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
 // If two pair is not present, look for a pair
@@ -643,97 +521,73 @@ int Player::CheckForPair() {
     // Use the LookForSets function to find a pair
     pairIndex = LookForSets(2);
 
-    // Again, if the pair is aces, mark them as 14, not 1, as they are high
-    if (pairIndex && hand.at(pairIndex).GetCardNumber() == 1) {
-        handStats.at(0) = 2;
-        handStats.at(1) = 14;
-        GrabCardsInOrder(3);
-    }
-    // Otherwise, just mark the handStats using the number as is
-    else if (pairIndex) {
-        handStats.at(0) = 2;
-        handStats.at(1) = hand.at(pairIndex).GetCardNumber();
+    // If found, mark the handStats with the pair followed by the 3 highest other cards
+    if (pairIndex) {
+        SetHandStat(0, 2);
+        SetHandStat(1, sortedHand.at(pairIndex).GetHighCardNumber());
         GrabCardsInOrder(3);
     }
 
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
 // Finally, if nothing else is found, check for the highest cards
 int Player::CheckForHighCard() {
     // Mark it as the lowest scoring hand and then get the top 5 cards
-    handStats.at(0) = 1;
+    SetHandStat(0, 1);
     GrabCardsInOrder(5);
 
-    return handStats.at(0);
+    return GetHandStat(0);
 }
 
 // This grabs the cards from highest to lowest and inputs them into 
-// the handStats vector, making sure to ignore card numbers that are already present
+// the handStats, making sure to ignore card numbers that are already present
 void Player::GrabCardsInOrder(int numCards) {
     int grabbedCards = 0;
-    int i = hand.size() - 1;
     int handStatsIndex = 1;
-    
-    // First check for a potential ace high card
-    if (hand.at(0).GetCardNumber() == 1) {
-        size_t m = 1;
+
+    // Skip past the handStats that are already filled in, so the grabbed cards go after them
+    while (handStatsIndex < NUM_HAND_STATS && GetHandStat(handStatsIndex) != 0) {
+        handStatsIndex++;
+    }
+
+    // Go down from the highest card until the needed amount of cards has been grabbed
+    for (int i = sortedHand.size() - 1; i >= 0 && grabbedCards < numCards; i--) {
+        int cardNumber = sortedHand.at(i).GetHighCardNumber();
         bool alreadyCounted = false;
-        
-        // Cycle through the handStats vector to check if numbers have been added previously
-        // If not, and there is an ace present, mark the high card as 14
-        while (handStats.at(m) != 0) {
-            if (handStats.at(m) == 14) {
-                bool alreadyCounted = true;
+
+        // Check through the filled handStats, in case this card's number is already part of the hand (a pair, for example)
+        for (int j = 1; j < handStatsIndex; j++) {
+            if (GetHandStat(j) == cardNumber) {
+                alreadyCounted = true;
                 break;
             }
-            m++;
         }
+
+        // If it isn't, add it to the handStats and increment everything appropriately
         if (!alreadyCounted) {
-            handStats.at(m) = 14;
+            SetHandStat(handStatsIndex, cardNumber);
+            handStatsIndex++;
             grabbedCards++;
         }
     }
-
-    // While the needed amount of cards is still under the total numCards input into the function as what is needed
-    while (grabbedCards < numCards) {
-        // Check through each index of handStats, and compare against the hand card number
-        for (size_t j = 1; j < handStats.size(); j++) {
-            // If the value in the handStats vector at j is 0, then it can receive the next highest card
-            if (handStats.at(j) == 0) {
-                handStatsIndex = j;
-                break;
-            }
-
-            // However, if the handStats vector at j equals the hand at i, then move to the next hand card
-            // and check against the same handStats at j (just in case there is a pair in the hand that needs to be ignored)
-            if (hand.at(i).GetCardNumber() == handStats.at(j)) {
-                i--;
-                j--;
-            }
-        }
-
-        // Add the current card number to the handStats empty index value and increment (or decrement) everything appropriately
-        handStats.at(handStatsIndex) = hand.at(i).GetCardNumber();
-        grabbedCards++;
-        i--;
-    }
 }
 
 // Look for sets of various sizes
 // The parameter cardAmount states how many cards need to be part of the set (pair (2), 3-of-a-kind (3), 4-of-a-kind (4))
 // The parameter previousFind, is the index of a card that is part of an already found set and should be ignored (as it was already found)
+// The highest set is always found first, because the search starts at the highest card
 int Player::LookForSets(int cardAmount, int previousFind) {
-    // If the previousFind value exists (is less than 14), use it to look for cards less than the card at that index
+    // If the previousFind value exists (is not -1), use it to skip cards with the same number as the card at that index
     int totNumOfCard = 1;
-    if (previousFind < 14) {
-        previousFind = hand.at(previousFind).GetCardNumber();
+    if (previousFind >= 0) {
+        previousFind = sortedHand.at(previousFind).GetHighCardNumber();
     }
 
     // Go through each card in a double loop, checking for cards that are the same
-    for (int i = hand.size() - 1; i >= cardAmount - 1; i--) {
+    for (int i = sortedHand.size() - 1; i >= cardAmount - 1; i--) {
         for (int j = i - 1; j >= 0; j--) {
-            if (hand.at(i).GetCardNumber() == hand.at(j).GetCardNumber() && hand.at(j).GetCardNumber() < previousFind) {
+            if (sortedHand.at(i).GetHighCardNumber() == sortedHand.at(j).GetHighCardNumber() && sortedHand.at(j).GetHighCardNumber() != previousFind) {
                 totNumOfCard++;
                 // If the totNumOfCard reaches the cardAmount desired, return the index of that card
                 if (totNumOfCard == cardAmount) {
@@ -746,4 +600,34 @@ int Player::LookForSets(int cardAmount, int previousFind) {
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+// Return the highest card of the best straight in sortedHand, or 0 if there is no straight.
+// Only cards of "suit" are used (for a straight flush), unless suit is 0, in which case every card is used
+int Player::FindHighestStraight(int suit) {
+    // Mark each card number found, with the Ace counted both as 14 and as 1, so it can start A, 2, 3, 4, 5
+    bool hasNumber[15] = {};
+    for (size_t i = 0; i < sortedHand.size(); i++) {
+        if (suit == 0 || sortedHand.at(i).GetCardSuit() == suit) {
+            hasNumber[sortedHand.at(i).GetHighCardNumber()] = true;
+        }
+    }
+    hasNumber[1] = hasNumber[14];
+
+    // Go down from the Ace, counting how many card numbers in a row are found
+    // The first time 5 are found in a row, the straight's highest card is 4 places above the current number
+    int numForStraight = 0;
+    for (int number = 14; number >= 1; number--) {
+        if (hasNumber[number]) {
+            numForStraight++;
+            if (numForStraight == 5) {
+                return number + 4;
+            }
+        }
+        else {
+            numForStraight = 0;
+        }
+    }
+
+    return 0;
+}
@@ -2,32 +2,40 @@
 #define PLAYER_H
 
 #include "card.h"
+#include "hand_evaluator.h"
+
+// The number of values held in the handStats: the type of hand followed by 5 card numbers
+const int NUM_HAND_STATS = 6;
+// The number of chips each player sits down with in a normal game
+const int STARTING_CHIPS = 50;
 
 // Class created for human players, managing all the setters, getters, 
 // and helper functions relating to each player
 class Player {
     public:
         // Basic initializers, getters, setters, and resetters(emptying hand, etc.)
-        Player(std::string name = "none");
+        // The getters are const and the name is returned by reference, so reading a player never copies anything
+        Player(std::string name = "none", int chips = STARTING_CHIPS);
         void PrintHandStats(); 
-        int GetChips();
-        std::string GetName();
-        std::vector<Card> GetHand();
-        std::vector<int> GetHandStats(); 
-        int GetTotalBet();
-        bool GetFoldedStat();
-        bool GetAllInStat();
-        std::string GetBestHand();
-        std::string StringifyCardNumber(int card); 
+        int GetChips() const;
+        const std::string &GetName() const;
+        CardMask GetHand() const;
+        unsigned int GetHandKey() const;
+        int GetTotalBet() const;
+        bool GetFoldedStat() const;
+        bool GetAllInStat() const;
+        std::string GetBestHand() const;
+        std::string StringifyCardNumber(int card) const; 
         void SetFolded(bool value);
         void TakeWinnings(int playerChips, int winnerShare);
         void SubtractTotalBet(int lostAmount);
-        bool isDealer();
+        bool isDealer() const;
 
         // Interaction functions used during main game play
         void TakeCard(Card dealtCard);
+        void AddCommunityCards(CardMask newCards);
         void SortHand(Card dealtCard);
-        int BetChips(int highestBet);
+        int RaiseBet(int highestBet, int raiseAmount);
         void CallBet(int highestBet);
         void WinOrLoseHand(int chips);
         void EmptyHand();
@@ -36,9 +44,10 @@ class Player {
         void FlipDealerStat();
 
         // Functions to assess the hand given, checking for all possible win scenarios
-        void CombineHands(std::vector<Card> &communityHand);
-        int LookForSets(int cardAmount, int previousFind = 14);
-        int EvaluateCards(std::vector<Card> &communityHand);
+        void CombineHands(CardMask communityHand);
+        int LookForSets(int cardAmount, int previousFind = -1);
+        int EvaluateCards(CardMask communityHand);
+        int EvaluateCardsReference(CardMask communityHand);
         int CheckForStraightFlush();
         int CheckForFourOfAKind();
         int CheckForFullHouse();
@@ -49,18 +58,28 @@ class Player {
         int CheckForPair();
         int CheckForHighCard();
         void GrabCardsInOrder(int numCards);
+        int FindHighestStraight(int suit);
 
         // A print function to see the hand at any given time
         // Mostly for testing purposes
-        void PrintHand();
+        void PrintHand() const;
 
     private:
         int chips;
         std::string name;
-        std::vector<Card> hand;
+        CardMask hand;
+        // The player's cards plus every community card dealt so far, kept up to date street by street
+        IncrementalHand streetHand;
+        // The player's cards and the community cards in order (Aces last), only filled in by EvaluateCardsReference
+        std::vector<Card> sortedHand;
         bool dealer;
         int totalBet;
-        std::vector<int> handStats = {0, 0, 0, 0, 0, 0};
+        // The handStats (type of hand followed by the 5 deciding card numbers) packed into one comparable integer
+        unsigned int handKey;
+
+        // Read and write one of the handStats values packed inside handKey
+        int GetHandStat(int index) const;
+        void SetHandStat(int index, int value);
         bool folded;
 };
 
@@ -0,0 +1,135 @@
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "pot.h"
+
+// Return the largest bet made by a player who has not folded, which is as far as any pot can go
+static int LargestLiveBet(const std::vector<PotEntry> &entries) {
+    int largest = 0;
+    for (const PotEntry &entry : entries) {
+        if (!entry.folded) {
+            largest = std::max(largest, entry.totalBet);
+        }
+    }
+    return largest;
+}
+
+// Build the pots from the bottom up in one pass over the players sorted by totalBet, then find the winners from the top down
+std::vector<Pot> BuildPots(const std::vector<PotEntry> &entries, int firstSeat) {
+    int numPlayers = entries.size();
+    int largestLiveBet = LargestLiveBet(entries);
+
+    // Every bet counts only up to the largest live bet
+    std::vector<int> bets(numPlayers);
+    for (int i = 0; i < numPlayers; i++) {
+        bets[i] = std::min(entries[i].totalBet, largestLiveBet);
+    }
+
+    // The one sort: players from the smallest bet to the largest (and by index when bets are equal)
+    std::vector<int> order(numPlayers);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&bets](int a, int b) {
+        return bets[a] != bets[b] ? bets[a] < bets[b] : a < b;
+    });
+
+    std::vector<Pot> pots;
+    // Where each pot's eligible players start in the sorted order (everyone from there on bet at least up to its level)
+    std::vector<int> firstEligible;
+    int previousLevel = 0;
+    // Whether a player still in the hand stopped betting at previousLevel, which is what makes a new side pot start there
+    bool liveAtPreviousLevel = true;
+
+    for (int position = 0; position < numPlayers; ) {
+        int level = bets[order[position]];
+
+        // Each player betting at least this level puts (level - previousLevel) chips into this slice of the pot
+        if (level > previousLevel) {
+            int amount = (level - previousLevel) * (numPlayers - position);
+
+            // If only folded players stopped at the previous level, the same players are eligible, so it is still the same pot
+            if (!pots.empty() && !liveAtPreviousLevel) {
+                pots.back().amount += amount;
+                pots.back().level = level;
+            }
+            else {
+                Pot pot;
+                pot.amount = amount;
+                pot.level = level;
+                pots.push_back(pot);
+                firstEligible.push_back(position);
+            }
+        }
+
+        // Move past every player who bet exactly this level, noting whether any of them are still in the hand
+        liveAtPreviousLevel = false;
+        while (position < numPlayers && bets[order[position]] == level) {
+            if (!entries[order[position]].folded && level > 0) {
+                liveAtPreviousLevel = true;
+            }
+            position++;
+        }
+        previousLevel = std::max(previousLevel, level);
+    }
+
+    // Going from the top pot down, each pot's eligible players are the ones for the pot above plus those who stopped betting
+    // at this pot's level, so the best hand so far only has to be compared with the players being added
+    std::vector<int> eligible;
+    std::vector<int> winners;
+    unsigned int bestKey = 0;
+    int addedUpTo = numPlayers;
+
+    for (int p = pots.size() - 1; p >= 0; p--) {
+        for (int position = firstEligible[p]; position < addedUpTo; position++) {
+            int player = order[position];
+            if (entries[player].folded) {
+                continue;
+            }
+
+            eligible.push_back(player);
+            if (winners.empty() || entries[player].handKey > bestKey) {
+                bestKey = entries[player].handKey;
+                winners.assign(1, player);
+            }
+            else if (entries[player].handKey == bestKey) {
+                winners.push_back(player);
+            }
+        }
+        addedUpTo = firstEligible[p];
+
+        pots[p].eligible = eligible;
+        std::sort(pots[p].eligible.begin(), pots[p].eligible.end());
+
+        // Odd chips go round the table starting from firstSeat
+        pots[p].winners = winners;
+        std::sort(pots[p].winners.begin(), pots[p].winners.end(), [firstSeat, numPlayers](int a, int b) {
+            return (a - firstSeat + numPlayers) % numPlayers < (b - firstSeat + numPlayers) % numPlayers;
+        });
+    }
+
+    return pots;
+}
+
+// Share out every pot between its winners and hand back the bets nobody matched
+std::vector<int> SettlePots(const std::vector<PotEntry> &entries, int firstSeat) {
+    std::vector<int> chipsWon(entries.size(), 0);
+    int largestLiveBet = LargestLiveBet(entries);
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].totalBet > largestLiveBet) {
+            chipsWon[i] += entries[i].totalBet - largestLiveBet;
+        }
+    }
+
+    for (const Pot &pot : BuildPots(entries, firstSeat)) {
+        int numWinners = pot.winners.size();
+        int share = pot.amount / numWinners;
+        int oddChips = pot.amount % numWinners;
+
+        for (int i = 0; i < numWinners; i++) {
+            chipsWon[pot.winners[i]] += share + (i < oddChips ? 1 : 0);
+        }
+    }
+
+    return chipsWon;
+}
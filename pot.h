@@ -0,0 +1,41 @@
+#ifndef POT_H
+#define POT_H
+
+#include <vector>
+
+/* Settling the chips bet during a hand. Every player's totalBet is split into levels: the main pot holds what every player
+   still in the hand put in up to the smallest all-in, and each side pot holds the next slice, up to the next all-in,
+   from the players who bet that far. Each pot goes to the best hand among the players who did not fold and bet at least
+   up to its level, split evenly between tied hands. A whole hand is settled with one sort of the players by totalBet.
+*/
+
+// One player's part in settling a hand
+struct PotEntry {
+    int totalBet = 0;
+    // Folded players' chips go into the pots, but folded players cannot win them
+    bool folded = false;
+    // The hand key of the player's best hand (higher is better, see hand_evaluator.h)
+    unsigned int handKey = 0;
+};
+
+// A main or side pot, with the players (by their index in the entries) who could win it and the ones who did
+struct Pot {
+    int amount = 0;
+    // The totalBet a player needed to play for this pot
+    int level = 0;
+    std::vector<int> eligible;
+    // The players with the best hand among the eligible players, in the order odd chips are handed out
+    std::vector<int> winners;
+};
+
+/* Build the main pot and every side pot from the players' bets, from the main pot up, and find each pot's winners.
+   Any bet above the largest bet made by a player still in the hand was never matched, so it is left out of the pots.
+   "firstSeat" is the index of the first player to the left of the dealer: when a pot does not split evenly,
+   the odd chips go one each to the tied winners closest to that seat, going round the table
+*/
+std::vector<Pot> BuildPots(const std::vector<PotEntry> &entries, int firstSeat);
+// Return how many chips each player gets back when the hand is settled: the pots (or shares of pots) they won,
+// plus any part of their bet nobody still in the hand matched. The returned chips always add up to every totalBet
+std::vector<int> SettlePots(const std::vector<PotEntry> &entries, int firstSeat);
+
+#endif
@@ -0,0 +1,73 @@
+#include <random>
+#include <chrono>
+
+#include "random_generator.h"
+
+// Mix a 64-bit number into a well spread-out one (the splitmix64 generator), moving "value" along each call.
+// This is the recommended way of turning a single seed into xoshiro256** state, since a seed made of
+// mostly zero bits would otherwise give a poor start to the sequence
+static uint64_t SplitMix64(uint64_t &value) {
+    uint64_t mixed = (value += 0x9E3779B97F4A7C15ULL);
+    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+    return mixed ^ (mixed >> 31);
+}
+
+// Initialization of the generator from a seed
+Xoshiro256::Xoshiro256(uint64_t seed) {
+    Seed(seed);
+}
+
+// Restart the generator from a seed, giving exactly the same numbers as any other generator given that seed
+void Xoshiro256::Seed(uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        state[i] = SplitMix64(seed);
+    }
+}
+
+// Copy the generator's state out, to carry on from this point later with SetState
+void Xoshiro256::GetState(uint64_t savedState[4]) const {
+    for (int i = 0; i < 4; i++) {
+        savedState[i] = state[i];
+    }
+}
+
+// Put back a state copied out with GetState, so the generator makes the same numbers it would have made from that point
+void Xoshiro256::SetState(const uint64_t savedState[4]) {
+    for (int i = 0; i < 4; i++) {
+        state[i] = savedState[i];
+    }
+}
+
+// Move the generator 2^128 numbers ahead, as if that many numbers had been made
+void Xoshiro256::Jump() {
+    // The jump polynomial published with xoshiro256**
+    static const uint64_t JUMP[4] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+                                     0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+    uint64_t jumped[4] = {0, 0, 0, 0};
+
+    for (int word = 0; word < 4; word++) {
+        for (int bit = 0; bit < 64; bit++) {
+            if (JUMP[word] & ((uint64_t) 1 << bit)) {
+                for (int i = 0; i < 4; i++) {
+                    jumped[i] ^= state[i];
+                }
+            }
+            (*this)();
+        }
+    }
+
+    for (int i = 0; i < 4; i++) {
+        state[i] = jumped[i];
+    }
+}
+
+// Mix the operating system's random device with the current time, so seeds differ even where
+// std::random_device always gives the same numbers
+uint64_t RandomSeed() {
+    std::random_device device;
+    uint64_t seed = ((uint64_t) device() << 32) | device();
+    uint64_t time = std::chrono::steady_clock::now().time_since_epoch().count();
+
+    return SplitMix64(seed) ^ time;
+}
@@ -0,0 +1,86 @@
+#ifndef RANDOM_GENERATOR_H
+#define RANDOM_GENERATOR_H
+
+#include <cstdint>
+#include <limits>
+
+/* Class created for making random numbers quickly and reproducibly, using the xoshiro256** generator.
+   It keeps 256 bits of state, makes each 64-bit number with a handful of shifts, rotations and additions,
+   and passes the standard statistical tests that std::default_random_engine fails.
+   Seeding it with the same number always gives the same sequence of numbers, so a shuffle or simulation
+   can be repeated exactly by reusing its seed.
+
+   Jump moves the generator 2^128 numbers ahead in one go. Jumping a copy of a generator once per thread
+   gives every thread its own stream of numbers, and the streams are far too long to ever overlap.
+
+   GetState and SetState copy the 256 bits of state out and back in, so a generator can be saved partway through
+   its sequence (such as in a snapshot of a game, see snapshot.h) and carried on later from exactly the same point.
+
+   It meets the C++ "uniform random bit generator" requirements, so it also works with std::shuffle and the
+   std:: distributions.
+*/
+class Xoshiro256 {
+    public:
+        typedef uint64_t result_type;
+
+        Xoshiro256(uint64_t seed = 0);
+        void Seed(uint64_t seed);
+        void Jump();
+        void GetState(uint64_t savedState[4]) const;
+        void SetState(const uint64_t savedState[4]);
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        // Make the next random number. Defined here so the compiler can inline it into shuffling loops
+        result_type operator()() {
+            uint64_t result = RotateLeft(state[1] * 5, 7) * 9;
+            uint64_t shifted = state[1] << 17;
+
+            state[2] ^= state[0];
+            state[3] ^= state[1];
+            state[1] ^= state[2];
+            state[0] ^= state[3];
+            state[2] ^= shifted;
+            state[3] = RotateLeft(state[3], 45);
+
+            return result;
+        }
+
+    private:
+        static uint64_t RotateLeft(uint64_t value, int bits) {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        uint64_t state[4];
+};
+
+// Return a seed that is different every time it is called, for when a run does not need to be repeated
+uint64_t RandomSeed();
+
+/* Return a random number from 0 up to (but not including) "limit", using any generator that makes full
+   64-bit numbers (such as Xoshiro256 or std::mt19937_64). This multiplies instead of dividing, and only
+   draws again in the rare case that would favor some numbers over others, so every number is equally likely.
+   Unlike std::uniform_int_distribution, the answer is the same with every compiler and standard library.
+*/
+template <class Generator>
+uint64_t RandomBelow(Generator &generator, uint64_t limit) {
+    static_assert(Generator::min() == 0 && Generator::max() == std::numeric_limits<uint64_t>::max(),
+                  "RandomBelow needs a generator that makes full 64-bit numbers");
+
+    __uint128_t product = (__uint128_t) generator() * limit;
+    uint64_t low = (uint64_t) product;
+
+    if (low < limit) {
+        // The smallest low half that is not biased: 2^64 modulo limit
+        uint64_t threshold = -limit % limit;
+        while (low < threshold) {
+            product = (__uint128_t) generator() * limit;
+            low = (uint64_t) product;
+        }
+    }
+
+    return product >> 64;
+}
+
+#endif
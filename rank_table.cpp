@@ -0,0 +1,142 @@
+#include <cstring>
+
+#include "rank_table.h"
+#include "hand_evaluator.h"
+
+// Memory mapping is only available on POSIX systems; elsewhere LoadRankTable always falls back to EvaluateHand
+#if defined(__unix__) || defined(__APPLE__)
+#define HAS_RANK_TABLE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The mapped file and the entries within it, or null when no table is loaded
+static void *mappedFile = nullptr;
+static size_t mappedBytes = 0;
+static const uint32_t *rankTableEntries = nullptr;
+
+// Return the entry (1-52) that a card uses within each state: 13 entries per suit, from the Deuce up
+uint32_t RankTableEntry(unsigned char cardCode) {
+    return (cardCode >> CARD_SUIT_SHIFT) * 13 + (cardCode & 0xF) + 1;
+}
+
+// Walk the state machine one card at a time, reading the hand key at the end
+static unsigned int LookUpRankTable(const uint32_t *entries, CardMask cards) {
+    int numCards = CountCards(cards);
+    uint32_t position = 0;
+
+    while (cards) {
+        position = entries[position + RankTableEntry(__builtin_ctzll(cards))];
+        cards &= cards - 1;
+    }
+
+    // After the 7th card the entry is the hand key itself; with 5 or 6 cards it is kept in entry 0 of the state
+    return numCards == 7 ? position : entries[position];
+}
+
+// Check a handful of hands against EvaluateHand, to catch a damaged or mismatched file.
+// Only a few pages are touched, so this keeps the rest of the file unread until it is needed
+static bool SpotCheckRankTable(const uint32_t *entries) {
+    const CardMask hands[] = {
+        0x0000000000001F00ull, // 10 through Ace of Diamonds
+        0x000F000000001000ull, // 2 through 5 of Clubs with the Ace of Diamonds
+        0x0001000100011001ull, // four Deuces and the Ace of Diamonds
+        0x0404020200010030ull, // seven cards spread over every suit
+        0x00031000002000C0ull, // six cards
+        0x0100000400400006ull  // five cards
+    };
+
+    for (CardMask hand : hands) {
+        if (LookUpRankTable(entries, hand) != EvaluateHand(hand)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Map a rank table file into memory, returning false if it cannot be used
+bool LoadRankTable(std::string path) {
+    UnloadRankTable();
+
+#ifdef HAS_RANK_TABLE_MMAP
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat fileInfo;
+    if (fstat(file, &fileInfo) != 0 || (size_t) fileInfo.st_size < sizeof(RankTableHeader)) {
+        close(file);
+        return false;
+    }
+
+    // The mapping stays valid after the file is closed
+    size_t fileBytes = fileInfo.st_size;
+    void *mapping = mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    // Make sure the file is the version and layout this program expects, and that it is complete
+    const RankTableHeader *header = (const RankTableHeader *) mapping;
+    bool headerMatches = memcmp(header->magic, RANK_TABLE_MAGIC, sizeof(RANK_TABLE_MAGIC)) == 0 &&
+                         header->version == RANK_TABLE_VERSION &&
+                         header->headerBytes == sizeof(RankTableHeader) &&
+                         header->entriesPerState == RANK_TABLE_ENTRIES_PER_STATE &&
+                         header->handKeyCategoryShift == HAND_KEY_CATEGORY_SHIFT &&
+                         header->handKeyValueBits == HAND_KEY_VALUE_BITS &&
+                         fileBytes == sizeof(RankTableHeader) + (size_t) header->numStates * RANK_TABLE_ENTRIES_PER_STATE * sizeof(uint32_t);
+
+    const uint32_t *entries = (const uint32_t *) ((const char *) mapping + sizeof(RankTableHeader));
+    if (!headerMatches || !SpotCheckRankTable(entries)) {
+        munmap(mapping, fileBytes);
+        return false;
+    }
+
+    // Lookups jump all over the table, so reading ahead of each page touched would only waste memory
+    madvise(mapping, fileBytes, MADV_RANDOM);
+
+    mappedFile = mapping;
+    mappedBytes = fileBytes;
+    rankTableEntries = entries;
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Unmap the rank table, if one is loaded
+void UnloadRankTable() {
+#ifdef HAS_RANK_TABLE_MMAP
+    if (mappedFile) {
+        munmap(mappedFile, mappedBytes);
+    }
+#endif
+
+    mappedFile = nullptr;
+    mappedBytes = 0;
+    rankTableEntries = nullptr;
+}
+
+// Return whether a rank table is currently loaded
+bool RankTableLoaded() {
+    return rankTableEntries != nullptr;
+}
+
+// Getter for the loaded table's entries
+const uint32_t *GetRankTableEntries() {
+    return rankTableEntries;
+}
+
+// Evaluate a set of 5 to 7 cards with the rank table if one is loaded, otherwise with EvaluateHand
+unsigned int EvaluateHandWithRankTable(CardMask cards) {
+    if (!rankTableEntries) {
+        return EvaluateHand(cards);
+    }
+
+    return LookUpRankTable(rankTableEntries, cards);
+}
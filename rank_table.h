@@ -0,0 +1,63 @@
+#ifndef RANK_TABLE_H
+#define RANK_TABLE_H
+
+#include <string>
+#include <cstdint>
+
+#include "card.h"
+
+/* The rank table is the largest way of evaluating a hand: a state machine with one state for every
+   set of up to 6 cards that can still turn out differently, and 53 entries per state. Entry 1-52 of a state says
+   where to go after one more card is added, so evaluating a hand is just one lookup per card, and after the 7th card
+   the lookup gives the hand key itself. Entry 0 of a state holds the hand key of the 5 or 6 cards that reached it.
+   To keep the number of states down, the suit of a card is forgotten as soon as that suit can no longer make a flush.
+
+   At around 130 MB the table is far too big to build each time a program starts, so tools/generate_rank_table.cpp
+   writes it to a file once and LoadRankTable maps that file into memory read-only. Pages are only read from disk
+   when a lookup first touches them, and every process mapping the same file shares one copy in memory.
+
+   Each lookup is likely to miss the cache, so for one-off hands the table is several times slower than EvaluateHand,
+   and the game itself never uses it. It pays off when walking through many hands that share their first cards,
+   such as enumerating every hand (see tools/enumerate_hands.cpp), where the states for those cards are reused.
+*/
+
+// The first 8 bytes of every rank table file, followed by the format version
+const char RANK_TABLE_MAGIC[8] = {'H', 'O', 'L', 'D', 'E', 'M', 'R', 'T'};
+const uint32_t RANK_TABLE_VERSION = 1;
+// Entry 0 of each state, followed by one entry for each of the 52 cards
+const uint32_t RANK_TABLE_ENTRIES_PER_STATE = 53;
+// The file the tools look for when no other file is given
+const std::string DEFAULT_RANK_TABLE_FILE = "rank_table.bin";
+
+// The header at the start of a rank table file, with the 32-bit entries following straight after it.
+// The hand key layout is stored too, so a file written before the hand key changes is never used by mistake
+struct RankTableHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;
+    uint32_t numStates;
+    uint32_t entriesPerState;
+    uint32_t handKeyCategoryShift;
+    uint32_t handKeyValueBits;
+    uint32_t reserved[8];
+};
+
+// Return the entry (1-52) that a card uses within each state
+uint32_t RankTableEntry(unsigned char cardCode);
+
+// Map a rank table file into memory, returning false (and leaving the table unloaded) if the file is missing,
+// was written for a different version or hand key layout, or fails a quick check against EvaluateHand.
+// Call this before any threads start evaluating hands
+bool LoadRankTable(std::string path = DEFAULT_RANK_TABLE_FILE);
+// Unmap the rank table, if one is loaded
+void UnloadRankTable();
+// Return whether a rank table is currently loaded
+bool RankTableLoaded();
+// Return the loaded table's entries, or null when no rank table is loaded. Code that walks through many hands
+// sharing the same first cards (such as enumerating every hand) can step through the states itself and reuse them
+const uint32_t *GetRankTableEntries();
+// Evaluate a set of 5 to 7 cards with the rank table, or with EvaluateHand when no rank table is loaded.
+// Either way the hand key is the same
+unsigned int EvaluateHandWithRankTable(CardMask cards);
+
+#endif
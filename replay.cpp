@@ -0,0 +1,214 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <stdexcept>
+
+#include "replay.h"
+#include "game.h"
+
+// How many mismatches are described in a ReplayResult
+static const size_t MAX_MISMATCHES_KEPT = 10;
+
+// Initialization of a replay provider with no hand to replay yet
+ReplayActionProvider::ReplayActionProvider() {
+    nextAction = 0;
+}
+
+// Keep a copy of the hand's actions, reusing the memory from the hand before
+void ReplayActionProvider::SetHand(const HandRecord &hand) {
+    actions.assign(hand.actions.begin(), hand.actions.end());
+    nextAction = 0;
+}
+
+// Hand back the next recorded action, as long as it is for the player whose turn it is
+PlayerAction ReplayActionProvider::ChooseAction(const TurnState &turn) {
+    if (nextAction >= actions.size()) {
+        throw std::invalid_argument("ReplayActionProvider: " + turn.name + " has a decision to make, but the record has no actions left");
+    }
+
+    const ActionRecord &recorded = actions[nextAction++];
+    if (recorded.seat != turn.playerIndex) {
+        throw std::invalid_argument("ReplayActionProvider: it is seat " + std::to_string(turn.playerIndex) +
+                                    "'s turn, but the record has seat " + std::to_string(recorded.seat) + " acting");
+    }
+
+    PlayerAction action;
+    action.type = recorded.type;
+    // The record has the chips that went in, while a raise is asked for as the chips on top of calling
+    if (recorded.type == RAISE) {
+        action.amount = recorded.amount - turn.callingCost;
+    }
+    return action;
+}
+
+// Return how many recorded actions have not been handed out yet
+int ReplayActionProvider::ActionsLeft() {
+    return actions.size() - nextAction;
+}
+
+// Compare two hands field by field, in the order they happen at the table
+std::string HandDifference(const HandRecord &recorded, const HandRecord &played) {
+    if (recorded.handNumber != played.handNumber) {
+        return "the round numbers differ";
+    }
+    if (recorded.smallBlind != played.smallBlind || recorded.bigBlind != played.bigBlind) {
+        return "the blinds differ";
+    }
+    if (recorded.dealer != played.dealer) {
+        return "the dealer differs";
+    }
+    if (recorded.smallBlindSeat != played.smallBlindSeat || recorded.bigBlindSeat != played.bigBlindSeat) {
+        return "the blinds were posted by different seats";
+    }
+    if (recorded.seats.size() != played.seats.size()) {
+        return "the number of seats differs";
+    }
+    for (size_t i = 0; i < recorded.seats.size(); i++) {
+        const SeatRecord &a = recorded.seats[i];
+        const SeatRecord &b = played.seats[i];
+        if (a.name != b.name || a.chips != b.chips) {
+            return "seat " + std::to_string(i) + " has a different player or chips";
+        }
+        if (a.holeCards[0] != b.holeCards[0] || a.holeCards[1] != b.holeCards[1]) {
+            return "seat " + std::to_string(i) + " was dealt different cards";
+        }
+    }
+    if (recorded.board != played.board) {
+        return "the community cards differ";
+    }
+    for (size_t i = 0; i < recorded.actions.size() && i < played.actions.size(); i++) {
+        const ActionRecord &a = recorded.actions[i];
+        const ActionRecord &b = played.actions[i];
+        if (a.street != b.street || a.seat != b.seat || a.type != b.type || a.amount != b.amount) {
+            return "action " + std::to_string(i + 1) + " differs";
+        }
+    }
+    if (recorded.actions.size() != played.actions.size()) {
+        return "the number of actions differs";
+    }
+    if (recorded.chipsWon != played.chipsWon) {
+        return "the chips won differ";
+    }
+    return "";
+}
+
+// Everything one game being replayed needs between its hands
+struct ReplayTable {
+    std::vector<Player> players;
+    Deck tableDeck;
+    int nextHand = 1;
+    // Once a hand does not match, nothing after it in the game can be trusted, so the rest of the game is skipped
+    bool failed = false;
+};
+
+// Set a table up as the game was before its first hand: the seats and their chips from the record, the deck from the game's seed,
+// and the dealer marker on the seat before the first hand's dealer, as AssignDealer moves it on one seat at the start of each hand
+static void StartReplayTable(ReplayTable &table, const HandRecord &firstHand) {
+    table.players.clear();
+    for (const SeatRecord &seat : firstHand.seats) {
+        table.players.push_back(Player(seat.name, seat.chips));
+    }
+    int numSeats = table.players.size();
+    table.players.at((firstHand.dealer + numSeats - 1) % numSeats).FlipDealerStat();
+
+    table.tableDeck.SeedDeck(firstHand.seed);
+    table.nextHand = 1;
+    table.failed = false;
+}
+
+// Note down a hand that did not play out as recorded, describing it if not too many have been described already
+static void AddMismatch(ReplayResult &result, const HandRecord &hand, const std::string &difference) {
+    result.mismatchedGames++;
+    if (result.mismatches.size() < MAX_MISMATCHES_KEPT) {
+        result.mismatches.push_back("game " + std::to_string(hand.gameId) + " (seed " + std::to_string(hand.seed) + "), round " +
+                                    std::to_string(hand.handNumber) + ": " + difference);
+    }
+}
+
+// Read the file from start to end, replaying each hand at its game's table as soon as it is read
+ReplayResult ReplayHandHistory(const std::string &historyFile) {
+    HandHistoryReader reader(historyFile);
+    if (!reader.IsOpen()) {
+        throw std::invalid_argument("ReplayHandHistory: could not open '" + historyFile + "'");
+    }
+
+    ReplayResult result;
+    std::unordered_map<int, ReplayTable> tables;
+    ReplayActionProvider replayActions;
+    HandRecord hand;
+    HandRecord played;
+    HandHistoryGame copyPlayed;
+    copyPlayed.played = &played;
+
+    auto start = std::chrono::steady_clock::now();
+    while (reader.NextHand(hand)) {
+        // Every game starts at round 1, and a game id used again (by a later run appending to the file) starts a new game
+        if (hand.handNumber == 1) {
+            StartReplayTable(tables[hand.gameId], hand);
+            result.games++;
+        }
+
+        auto found = tables.find(hand.gameId);
+        if (found == tables.end() || found->second.failed) {
+            continue;
+        }
+        ReplayTable &table = found->second;
+        result.hands++;
+        if (hand.handNumber != table.nextHand) {
+            AddMismatch(result, hand, "the hand before it is missing");
+            table.failed = true;
+            continue;
+        }
+
+        Blinds blinds;
+        blinds.smallBlind = hand.smallBlind;
+        blinds.bigBlind = hand.bigBlind;
+        replayActions.SetHand(hand);
+
+        std::string difference;
+        try {
+            PlayRound(table.players, hand.handNumber, table.tableDeck, replayActions, false, blinds, copyPlayed);
+            difference = replayActions.ActionsLeft() > 0 ? "the hand ended with recorded actions left over" : HandDifference(hand, played);
+        }
+        catch (const std::exception &error) {
+            difference = error.what();
+        }
+
+        if (!difference.empty()) {
+            AddMismatch(result, hand, difference);
+            table.failed = true;
+            continue;
+        }
+
+        table.nextHand++;
+        // A finished game needs its table no more
+        if (table.players.size() == 1) {
+            tables.erase(found);
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    result.seconds = elapsed.count();
+    result.handsPerSecond = result.seconds > 0 ? result.hands / result.seconds : 0;
+    return result;
+}
+
+// Print the speed of the replay and whether every hand matched
+void PrintReplayResult(const ReplayResult &result) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Replayed " << result.hands << " hands from " << result.games << " games in " << result.seconds << " seconds, "
+              << std::setprecision(0) << result.handsPerSecond << " hands per second\n";
+
+    if (result.mismatchedGames == 0) {
+        std::cout << "Every hand played out exactly as recorded\n";
+        return;
+    }
+
+    std::cout << result.mismatchedGames << " games had a hand that did not play out as recorded (the rest of each was skipped):\n";
+    for (const std::string &mismatch : result.mismatches) {
+        std::cout << "  " << mismatch << "\n";
+    }
+}
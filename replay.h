@@ -0,0 +1,55 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <string>
+#include <vector>
+
+#include "action.h"
+#include "hand_history.h"
+
+/* Decisions taken from a recorded hand, so a Round plays the hand again exactly as it was played. Each recorded action
+   is handed back as the decision that puts in the same chips: a raise is given as the chips it put in less what it cost
+   to call when it was made, and everything else as it was recorded.
+   Throws std::invalid_argument if it is asked for a decision when the record has none left, or when the record has
+   a different seat acting, since the hand being played has then gone differently from the one recorded.
+*/
+class ReplayActionProvider : public ActionProvider {
+    public:
+        ReplayActionProvider();
+        // Start handing out the actions of "hand", from its first one
+        void SetHand(const HandRecord &hand);
+        PlayerAction ChooseAction(const TurnState &turn);
+        int ActionsLeft();
+
+    private:
+        std::vector<ActionRecord> actions;
+        size_t nextAction;
+};
+
+// Describe the first way two hands differ, or return an empty string if they are the same.
+// Player ids and game ids are given by whoever wrote the hand, so the seats are compared by name and the game ids are not compared
+std::string HandDifference(const HandRecord &recorded, const HandRecord &played);
+
+// The results of replaying a hand history file, along with how quickly it ran
+struct ReplayResult {
+    long games = 0;
+    long hands = 0;
+    // Games with a hand that did not play out the same as its record (no more hands of such a game are played)
+    long mismatchedGames = 0;
+    // A description of the first few mismatches
+    std::vector<std::string> mismatches;
+    double seconds = 0;
+    double handsPerSecond = 0;
+};
+
+/* Play every game in a hand history file again from its record, with no input and nothing printed, checking that each hand
+   comes out exactly as it was recorded. Each game is set up from its first hand (the seats, their chips and the dealer),
+   with its deck seeded from the game's seed, and every hand is then played with PlayRound, taking each decision from the record.
+   Games from different tables may be mixed together in the file, so every game being replayed keeps its own table.
+   Throws std::invalid_argument if the file cannot be opened or is not a hand history file.
+*/
+ReplayResult ReplayHandHistory(const std::string &historyFile);
+// Print how many hands were replayed, how quickly, and any that did not match their record
+void PrintReplayResult(const ReplayResult &result);
+
+#endif
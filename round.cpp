@@ -2,18 +2,29 @@
 #include <string>
 #include <vector>
 #include <algorithm>
-#include <fstream>
+#include <sstream>
 
 #include "round.h"
+#include "pot.h"
+#include "log_writer.h"
+#include "screen_renderer.h"
 
-// Initializer for a round, creating a deck and importing the vector of players
-// The highest bet starts at 2 for the "big blind", and the currentDealer index gets 
+// Initializer for a round, collecting the table's cards, keeping a reference to the table's vector of players
+// and keeping the ActionProvider that makes every betting decision (and whether results are exported to the txt file)
+// The highest bet starts at the "big blind" (2 unless other blinds are given), and the currentDealer index gets 
 // initialized to zero (subject to change later with the AssignDealer function)
-Round::Round(std::vector<Player> &players) {
-    this->players = players;
-    highestBet = 2;
+// If the history has a writer (or somewhere to copy the record), the round is recorded as it is played
+Round::Round(std::vector<Player> &players, Deck &tableDeck, ActionProvider &actions, bool exportStats, Blinds blinds,
+             HandHistoryGame history) : players(players), tableDeck(tableDeck), actions(actions) {
+    this->exportStats = exportStats;
+    this->blinds = blinds;
+    this->history = history;
+    recording = history.writer || history.played;
+    highestBet = blinds.bigBlind;
     currentDealer = 0;
-    this->tableDeck = Deck();
+    communityHand = 0;
+    // Only the cards actually dealt this round are picked at random (with DrawCard), so there is no need to shuffle all 52
+    this->tableDeck.CollectCards();
 }
 
 // For each round, all the players are dealt 2 cards to start with 
@@ -23,7 +34,7 @@ void Round::DealCards() {
     // Using a for loop, and cycling through the list of players twice,
     // this ensures that each player will be dealt 2 cards
     for (int i = 0; i < (players.size() * handSize); i++) {
-        players.at(i % players.size()).TakeCard(tableDeck.DealCard());
+        players.at(i % players.size()).TakeCard(tableDeck.DrawCard());
     }
 }
 
@@ -33,11 +44,26 @@ void Round::DealCommunityCards(int numCards) {
     // Before dealing the cards to the community, a card must be "burned".
     // This means that the card is removed from the game without being seen.
     // It helps with limiting a player's knowledge of cards to come
-    tableDeck.DealCard();
+    tableDeck.DrawCard();
     
     // Then the number of cards specified as the parameter are dealt to the community
+    CardMask newCards = 0;
     for (size_t i = 0; i < numCards; i++) {
-        communityHand.push_back(tableDeck.DealCard());
+        Card card = tableDeck.DrawCard();
+        newCards |= card.GetCardMask();
+
+        // Note down the card in the order it was dealt when the hand is being recorded
+        if (recording) {
+            handRecord.board.push_back(card.GetCardCode());
+        }
+    }
+    communityHand |= newCards;
+
+    // Each player still in the hand adds the new cards to their best hand so far
+    for (size_t i = 0; i < players.size(); i++) {
+        if (!players.at(i).GetFoldedStat()) {
+            players.at(i).AddCommunityCards(newCards);
+        }
     }
 }
 
@@ -89,29 +115,45 @@ void Round::AssignDealer() {
 }
 
 // Once the dealer is set as currentDealer, the player to the left (one number higher in the players vector)
-// must ante 1 for the "small blind", and the player after that (one numbers higher)
-// must ante 2 for the "big blind"
+// must ante the "small blind" (1 by default), and the player after that (one numbers higher)
+// must ante the "big blind" (2 by default)
 // For example: if the currentDealer index is 3, the "small blind" player index would be at 4 and would pay 1,
 // and the "big blind" player index would be 5 and would pay 2
 void Round::CollectAnte() {
-    // This is done with a for loop because the "big blind" is one larger than the "small blind"
-    // and the player index for the "big blind" is also one larger than the "small blind"
-    for (int i = 0; i < 2; i++) {
-        // The mod of players.size() ensures that the index wraps around to the start of the vector when necessary
-        players.at((currentDealer + i + 1) % players.size()).Ante(i + 1);
+    // When the hand is being recorded, start its record with who is sitting where, and with how many chips, before the blinds go in
+    if (recording) {
+        handRecord.gameId = history.gameId;
+        handRecord.smallBlind = blinds.smallBlind;
+        handRecord.bigBlind = blinds.bigBlind;
+        handRecord.dealer = currentDealer;
+        handRecord.seats.resize(players.size());
+        for (size_t i = 0; i < players.size(); i++) {
+            handRecord.seats[i].name = players.at(i).GetName();
+            handRecord.seats[i].chips = players.at(i).GetChips();
+        }
+    }
+
+    // The mod of players.size() ensures that the index wraps around to the start of the vector when necessary
+    int smallBlindSeat = (currentDealer + 1) % players.size();
+    int bigBlindSeat = (currentDealer + 2) % players.size();
+    players.at(smallBlindSeat).Ante(blinds.smallBlind);
+    players.at(bigBlindSeat).Ante(blinds.bigBlind);
+
+    if (recording) {
+        handRecord.smallBlindSeat = smallBlindSeat;
+        handRecord.bigBlindSeat = bigBlindSeat;
     }
 }
 
-// This function receives player bets from input values by the human players
-// and prints to the console appropriate text to help the player know necessary information for the game
+// This function asks the round's ActionProvider for each player's decision in turn and applies it,
+// printing the table for each player first when the provider is played at the console
 void Round::PlaceBet(int roundNumber) {
-    std::string choice = "";
     bool bettingRoundOver = false;
     int firstRoundOfBetting = 1;
     int playerIndex; 
     
     // To know whose bet it is, set the playerIndex
-    if (communityHand.size()) {
+    if (communityHand) {
         // If the community hand already has cards, then the person to the left of the dealer (index 1 higher) bets first
         playerIndex = (currentDealer + 1) % players.size();
     }
@@ -128,100 +170,34 @@ void Round::PlaceBet(int roundNumber) {
 
         // If the player has folded, or if the player has gone all in, they are out of the betting. So just pass them over
         if (!players.at(playerIndex).GetFoldedStat() && !players.at(playerIndex).GetAllInStat()) {
-            // If the highestBet is 2, the currentPlayer's highestBet is that 2 (the "big blind"), everyone has had a chance to bet, and it is the first round of betting
-            if (highestBet == 2 && players.at(playerIndex).GetTotalBet() == highestBet && firstRoundOfBetting >= players.size() && roundNumber != -1) {
-                // Use the standard PrintHandText with all the necessary information (explained below)
-                PrintHandText(playerIndex, roundNumber);
-                std::cout << players.at(playerIndex).GetName();
-                std::cout << " still has the highest bet from the big blind. ";
-                std::cout << players.at(playerIndex).GetName();
-                std::cout << " can either (r)aise or (c)heck.\n";
-                // Receive the player's input for the choice they decide
-                getline(std::cin, choice);
-
-                // Keep asking until they give one of the two viable options
-                while (choice != "r" && choice != "c") {
-                    std::cout << "That is not a valid choice, please enter again.\n";
-                    std::cout << "Choose to (r)aise or (c)heck\n";
-
-                    getline(std::cin, choice);
-                }
+            // If the highestBet is still the "big blind", the currentPlayer's highestBet is the big blind, everyone has had a chance to bet, 
+            // and it is the first round of betting, the big blind has the option to raise or check
+            bool bigBlindOption = highestBet == blinds.bigBlind && players.at(playerIndex).GetTotalBet() == highestBet && 
+                                  firstRoundOfBetting >= players.size() && roundNumber != -1;
 
-                // If the player chooses to (c)heck, then the round ends
-                if (choice == "c") {
-                    bettingRoundOver = true;
-                    break;
-                }
-                // Otherwise, the player raises using the player BetChips function
-                else if (choice == "r") {
-                    int raisedAmount = players.at(playerIndex).BetChips(highestBet);
-                    // If the player's highestBet is larger than the previous set highestBet, mark it as the new highestBet
-                    if (highestBet < players.at(playerIndex).GetTotalBet()) {
-                        highestBet = players.at(playerIndex).GetTotalBet();
-                    }
-                    playerIndex++;
-                    continue;
-                }
-            }
             // If the bet is larger than the "big blind" and everyone has had a chance to bet, the round ends
-            else if ((players.at(playerIndex).GetTotalBet() == highestBet && firstRoundOfBetting > players.size())) {
+            if (!bigBlindOption && players.at(playerIndex).GetTotalBet() == highestBet && firstRoundOfBetting > players.size()) {
                 bettingRoundOver = true;
                 break;
             }
 
             // Use the standard PrintHandText with all the necessary information (explained below)
-            PrintHandText(playerIndex, roundNumber);
-            std::cout << players.at(playerIndex).GetName();
-            
-            // For rounds of betting after the first (say after there are 3 community cards),
-            // if the player has the matched highestBet, the option for them would be "check" instead of "call"
-            if (players.at(playerIndex).GetTotalBet() == highestBet) {
-                std::cout << " must decide to (r)aise, (c)heck or (f)old.\n";
-
-                getline(std::cin, choice);
-
-                while (choice != "r" && choice != "c" && choice != "f") {
-                    std::cout << "That is not a valid choice, please enter again." << std::endl;
-                    std::cout << "Choose to (r)aise, (c)heck or (f)old.\n";
-
-                    getline(std::cin, choice);
-                }
+            if (actions.ShowsTable()) {
+                PrintHandText(playerIndex, roundNumber);
             }
-            // Otherwise the currentPlayer has the option to "call" what the current highestBet is
-            else {
-                std::cout << " must decide to (r)aise, (c)all or (f)old.\n";
-
-                getline(std::cin, choice);
 
-                while (choice != "r" && choice != "c" && choice != "f") {
-                    std::cout << "That is not a valid choice, please enter again." << std::endl;
-                    std::cout << "Choose to (r)aise, (c)all or (f)old.\n";
-
-                    getline(std::cin, choice);
-                }
-            }
+            PlayerAction action = actions.ChooseAction(GetTurnState(playerIndex, roundNumber, bigBlindOption));
+            bool raised = ApplyAction(playerIndex, action);
 
-            // If the player chooses to raise, then the BetChips function is called
-            if (choice == "r") {
-                int raisedAmount = players.at(playerIndex).BetChips(highestBet);
-                // If it turns out the player cannot raise and instead chooses to fold,
-                // the BetChips function will return 0
-                if (raisedAmount == 0) {
-                    players.at(playerIndex).SetFolded(true);
-                }
-                // Otherwise, if the player's highestBet is the new highestBet, 
-                // reassign the highestBet to the new value
-                else if (highestBet < players.at(playerIndex).GetTotalBet()) {
-                    highestBet = players.at(playerIndex).GetTotalBet();
+            if (bigBlindOption) {
+                // If the big blind checks, then the round ends
+                if (!raised) {
+                    bettingRoundOver = true;
+                    break;
                 }
-            }
-            // If the player selects "call", use the player's CallBet function
-            else if (choice == "c") {
-                players.at(playerIndex).CallBet(highestBet);
-            }
-            // If the player selects "fold", mark the player's folded stat to true
-            else if (choice == "f") {
-                players.at(playerIndex).SetFolded(true);
+                // Otherwise the big blind has raised, and the betting goes round again
+                playerIndex++;
+                continue;
             }
         }
         // Check if either all the players but 1 have folded, or everyone is either all-in or has folded
@@ -237,28 +213,129 @@ void Round::PlaceBet(int roundNumber) {
     }
 }
 
-// The PrintHandText function prints to the console all necessary information
-// for the player when it is their turn to bet
+// Gather everything the player at playerIndex can see into a TurnState for the ActionProvider
+TurnState Round::GetTurnState(int playerIndex, int roundNumber, bool bigBlindOption) {
+    Player &currentPlayer = players.at(playerIndex);
+    TurnState turn;
+
+    turn.playerIndex = playerIndex;
+    turn.name = currentPlayer.GetName();
+    turn.hand = currentPlayer.GetHand();
+    turn.communityHand = communityHand;
+    turn.handKey = currentPlayer.GetHandKey();
+    turn.chips = currentPlayer.GetChips();
+    turn.totalBet = currentPlayer.GetTotalBet();
+    turn.highestBet = highestBet;
+    turn.callingCost = highestBet - currentPlayer.GetTotalBet();
+    turn.numPlayers = players.size();
+    turn.numFolded = CountFolded();
+    turn.numAllIn = CountAllIn();
+    turn.roundNumber = roundNumber;
+    turn.bigBlindOption = bigBlindOption;
+
+    for (size_t i = 0; i < players.size(); i++) {
+        turn.pot += players.at(i).GetTotalBet();
+    }
+
+    return turn;
+}
+
+// Carry out a player's decision, first turning it into the closest decision the player can actually make
+// Returns true if the decision raised the highestBet
+bool Round::ApplyAction(int playerIndex, PlayerAction action) {
+    Player &currentPlayer = players.at(playerIndex);
+    int callingCost = highestBet - currentPlayer.GetTotalBet();
+    int chipsBefore = currentPlayer.GetChips();
+
+    // The big blind cannot fold when they are able to check for free before the flop
+    if (action.type == FOLD && callingCost == 0 && !communityHand) {
+        action.type = CHECK;
+    }
+
+    if (action.type == FOLD) {
+        currentPlayer.SetFolded(true);
+        RecordAction(playerIndex, FOLD, 0);
+        return false;
+    }
+
+    if (action.type == RAISE || action.type == ALL_IN) {
+        // If the player cannot afford more than calling, raising just puts in every chip they have left
+        if (callingCost >= currentPlayer.GetChips()) {
+            currentPlayer.CallBet(highestBet);
+        }
+        else {
+            int maxRaise = currentPlayer.GetChips() - callingCost;
+            int raiseAmount = action.type == ALL_IN ? maxRaise : std::min(std::max(action.amount, 1), maxRaise);
+            currentPlayer.RaiseBet(highestBet, raiseAmount);
+        }
+    }
+    // Checking and calling both match the highestBet, which costs nothing when the player has already matched it
+    // CallBet also takes care of a player who cannot afford the whole call, putting in all they have instead
+    else {
+        currentPlayer.CallBet(highestBet);
+    }
+
+    // If the player's highestBet is larger than the previous set highestBet, mark it as the new highestBet
+    bool raised = false;
+    if (highestBet < currentPlayer.GetTotalBet()) {
+        highestBet = currentPlayer.GetTotalBet();
+        raised = true;
+    }
+
+    // Note down what the decision actually did, whatever the player asked for
+    int amount = chipsBefore - currentPlayer.GetChips();
+    if (amount == 0) {
+        RecordAction(playerIndex, CHECK, 0);
+    }
+    else if (currentPlayer.GetChips() == 0) {
+        RecordAction(playerIndex, ALL_IN, amount);
+    }
+    else {
+        RecordAction(playerIndex, raised ? RAISE : CALL, amount);
+    }
+
+    return raised;
+}
+
+// Add an action to the hand's record (when it is being recorded), on the street given by how many community cards are out
+void Round::RecordAction(int playerIndex, ActionType type, int amount) {
+    if (!recording) {
+        return;
+    }
+
+    ActionRecord action;
+    // No cards is before the flop, and 3, 4 and 5 cards are the flop, turn and river
+    action.street = handRecord.board.empty() ? PREFLOP : static_cast<Street>(handRecord.board.size() - 2);
+    action.seat = playerIndex;
+    action.type = type;
+    action.amount = amount;
+    handRecord.actions.push_back(action);
+}
+
+// The PrintHandText function puts on the console screen all necessary information
+// for the player when it is their turn to bet (the ConsoleActionProvider then adds its question and shows the screen)
 void Round::PrintHandText(int playerIndex, int roundNumber) {
-    Player currentPlayer = players.at(playerIndex);
+    const Player &currentPlayer = players.at(playerIndex);
+    ScreenRenderer &screen = ConsoleScreen();
     std::string takeTurn = "";
 
     // Clears screen for each player so previous information is not seen
-    std::cout << "\x1B[2J\x1B[H";
+    screen << CLEAR_SCREEN;
     // Explain whose turn it is next so the computer can be passed to the next person before cards are shown
-    std::cout << "It is now " << players.at(playerIndex).GetName() << "'s turn. Press 'enter' to continue...\n";
+    screen << "It is now " << currentPlayer.GetName() << "'s turn. Press 'enter' to continue...\n";
+    screen.Present();
     getline(std::cin, takeTurn);
 
     //Clears screen again so only pertinent information is present
-    std::cout << "\x1B[2J\x1B[H";
+    screen << CLEAR_SCREEN;
 
-    // If the communityHand vector is not empty, then print out the cards in the community hand
-    if (communityHand.size() > 0) {
+    // If the communityHand set is not empty, then print out the cards in the community hand
+    if (communityHand) {
         PrintCommunityHand();
     }
     // Otherwise mark that it is the start of a new hand, so players know the previous hand has ended
     else if (roundNumber > 1) {
-        std::cout << "Start of round " << roundNumber << std::endl;
+        screen << "Start of round " << roundNumber << '\n';
     }
     
     // If there are players who have gone all-in, let the currentPlayer know
@@ -272,36 +349,26 @@ void Round::PrintHandText(int playerIndex, int roundNumber) {
     }
     
     //Lists out all pertinent information for the current player
-    std::cout << currentPlayer.GetName() << " currently has the ";
-    currentPlayer.PrintHand();
-    std::cout << "\nThe current highest a player has bet is " << highestBet << ", and ";
-    std::cout << currentPlayer.GetName();
-    std::cout << " has currently bet " << currentPlayer.GetTotalBet() << std::endl;
-    std::cout << currentPlayer.GetName() << " has " << currentPlayer.GetChips() << " chips remaining.\n";
+    screen << currentPlayer.GetName() << " currently has the ";
+    screen.AddCardList(currentPlayer.GetHand());
+    // Once the community cards are out, also show the best hand the player can make with them so far
+    if (communityHand) {
+        screen << ", making " << currentPlayer.GetBestHand();
+    }
+    screen << "\nThe current highest a player has bet is " << highestBet << ", and ";
+    screen << currentPlayer.GetName();
+    screen << " has currently bet " << currentPlayer.GetTotalBet() << '\n';
+    screen << currentPlayer.GetName() << " has " << currentPlayer.GetChips() << " chips remaining.\n";
 }
 
-// A function for printing to the console the cards in the communityHand
+// A function for adding the cards in the communityHand to the console screen
 void Round::PrintCommunityHand() {
-    std::cout << "The community hand includes the ";
-
-    // For each card in the hand, get the string version of the card ("Ace of spades" instead of {1, 3})
-    // and print it to the console
-    for (size_t i = 0; i < communityHand.size(); i++) {
-        // If it is the last card in the hand, don't add any punctuation after the card string
-        if (i == communityHand.size() - 1) {
-            std::cout << communityHand.at(i).GetCardString();
-        }
-        // Otherwise if it is the second to last, print out a final "," and an "and" following the card string
-        else if (i == communityHand.size() - 2) {
-            std::cout << communityHand.at(i).GetCardString() << ", and ";
-        }
-        // Otherwise, just print out a ", " following the card string
-        else {
-            std::cout << communityHand.at(i).GetCardString() << ", ";
-        }
-    }
+    ScreenRenderer &screen = ConsoleScreen();
 
-    std::cout << std::endl;
+    // Each card is shown by its name ("Ace of Spades" instead of {1, 3}), with ", " between them and ", and " before the last
+    screen << "The community hand includes the ";
+    screen.AddCardList(communityHand);
+    screen << '\n';
 }
 
 // Cycle through all the players and return how many have folded
@@ -344,20 +411,21 @@ int Round::CountAllInAndFolded() {
     return numFoldedOrAllIn;
 }
 
-// Function to print to the console all the players who have gone all-in
+// Function to add to the console screen all the players who have gone all-in
 void Round::PrintAllIns() {
+    ScreenRenderer &screen = ConsoleScreen();
     int numAllIns = 0;
 
     for(int i = 0; i < players.size(); i++) {
         if (players.at(i).GetAllInStat()) {  
             // If this is the first player found going all-in, do not add punctuation
             if (numAllIns == 0) {
-                std::cout << players.at(i).GetName();
+                screen << players.at(i).GetName();
                 numAllIns++;
             }
             // Otherwise, place a ", " in front of the next name found
             else {
-                std::cout << ", " << players.at(i).GetName();
+                screen << ", " << players.at(i).GetName();
                 numAllIns++;
             }
         }
@@ -365,41 +433,42 @@ void Round::PrintAllIns() {
 
     // If there is only one player who went all-in, use the correct grammar
     if (numAllIns == 1) {
-        std::cout << " is all-in\n";
+        screen << " is all-in\n";
     }
     // Otherwise change to acknowledge that several people have gone all-in
     else {
-        std::cout << " are all-in\n";
+        screen << " are all-in\n";
     }
 }
 
 // A function similar to PrintAllIns, except with players who have folded
 void Round::PrintFolded() {
+    ScreenRenderer &screen = ConsoleScreen();
     int numFolded = 0;
 
     for (int i = 0; i < players.size(); i++) {
         if (players.at(i).GetFoldedStat()) {
             if (numFolded == 0) {
-                std::cout << players.at(i).GetName();
+                screen << players.at(i).GetName();
                 numFolded++;
             }
             else {
-                std::cout << ", " << players.at(i).GetName();
+                screen << ", " << players.at(i).GetName();
                 numFolded++;
             }
         }
     }
 
     if (numFolded == 1) {
-        std::cout << " has folded\n";
+        screen << " has folded\n";
     }
     else {
-        std::cout << " have folded\n";
+        screen << " have folded\n";
     }
 }
 
 // For each player who has not folded, use the EvaluateCards function to create a
-// handStats vector determining the value of the hand
+// hand key determining the value of the hand
 void Round::ScoreHands() {
     for (size_t i = 0; i < players.size(); i++) {
         if (!players.at(i).GetFoldedStat()) {
@@ -410,129 +479,91 @@ void Round::ScoreHands() {
 
 // The function that, after determining the winner, divides up the pot accordingly to winners, 
 // and resets (or deletes) players as necessary
-std::vector<Player> Round::DivvyPots(int roundNumber, bool winnerByFolding) {
+void Round::DivvyPots(int roundNumber, bool winnerByFolding) {
+    // Hand every player their winnings from the main pot and any side pots, along with any part of their bet nobody matched
+    // This works the same way when everyone else folded, as the one player left is the only one who can win any pot
+    PayOutPots();
+
+    // Write the hand to the hand history file while every player's cards are still in their hands
+    if (recording) {
+        handRecord.handNumber = roundNumber;
+        for (size_t i = 0; i < players.size(); i++) {
+            Card holeCards[2];
+            int numCards = MaskToCards(players.at(i).GetHand(), holeCards);
+            for (int j = 0; j < numCards && j < 2; j++) {
+                handRecord.seats[i].holeCards[j] = holeCards[j].GetCardCode();
+            }
+        }
+        if (history.writer) {
+            history.writer->WriteHand(handRecord);
+        }
+        if (history.played) {
+            *history.played = handRecord;
+        }
+    }
+
     // If the winner has not already been determined because everyone else folded
     if (!winnerByFolding) {    
         // Create a vector of pairs that contain the winner's index in the players vector,
-        // and whether that player has tied someone else for the value of their handStats
-        std::vector<std::pair<int, int>> winnerIndexAndTies;
+        // and whether that player has tied someone else for the value of their hand key
+        std::vector<std::pair<int, int>> winnerIndexAndTies = RankHands();
 
-        // For each player that has not folded, order the players' handStats vectors from highest to lowest
-        // using the recursive OrderPlayerHands stat, with the number of times the recursive function has been called set to 0
-        for (size_t i = 0; i < players.size(); i++) {
-            if (!players.at(i).GetFoldedStat()) {
-                int recursiveCount = 0;
-                OrderPlayerHands(winnerIndexAndTies, i, recursiveCount);
-            }
+        // Then export the results to a txt file for later review
+        if (exportStats) {
+            ExportStatsToFile(winnerIndexAndTies, roundNumber);
         }
 
-        // Once ordered, go through the players in the order of winnerIndexAndTies
-        for (int m = 0; m < winnerIndexAndTies.size(); m++) {
-            // If the player at the current index has some totalBet remaining 
-            // (has not all been removed from previous loops of this function)
-            if (players.at(winnerIndexAndTies.at(m).first).GetTotalBet() > 0) {
-                // If the player did not tie with anyone else, then subtract that player's totalBet
-                // from all remaining players with totalBet values equal to or less than the player's totalBet
-                if (winnerIndexAndTies.at(m).second == 0) { 
-                    AddBetsToWinner(m, winnerIndexAndTies);
+        // Show the results at the console when people are playing there
+        if (actions.ShowsTable()) {
+            ScreenRenderer &screen = ConsoleScreen();
+
+            //Clears screen for each player so previous information is not seen
+            screen << CLEAR_SCREEN;
+
+            // After exporting the information to the txt file, print to the console who won
+            // And include the type of winning hand the player won with (flush, straight, full house, etc.)
+            for (int i = 0; i < winnerIndexAndTies.size(); i++) {
+                if (i == 0 && winnerIndexAndTies.at(i).second == 0) {
+                    screen << players.at(winnerIndexAndTies.at(i).first).GetName() << " won with " << players.at(winnerIndexAndTies.at(i).first).GetBestHand();
+                }
+                else if (winnerIndexAndTies.at(i).second != 0 && winnerIndexAndTies.at(i).second == winnerIndexAndTies.at(0).second) {
+                    screen << players.at(winnerIndexAndTies.at(i).first).GetName() << " tied with " << players.at(winnerIndexAndTies.at(i).first).GetBestHand();
                 }
-                // If there are ties between winners
                 else {
-                    // Create a vector of pairs to track all the players who tied and what their totalBet was
-                    std::vector<std::pair<int, int>> tiesAndTotalBet;
-                    int j = m;
-
-                    // While the tie number (unique to each tied group) is the same as the first player being checked
-                    while (winnerIndexAndTies.at(j).second == winnerIndexAndTies.at(m).second) {
-                        // Add the pair {playerIndex, totalBet} to the tiesAndTotalBet vector
-                        std::pair<int, int> tempHolder = {winnerIndexAndTies.at(j).first, players.at(winnerIndexAndTies.at(j).first).GetTotalBet()}; 
-                        tiesAndTotalBet.push_back(tempHolder);
-                        j++;
-                    }
-
-                    // Then order this group of tied players from smallest totalBet to greatest
-                    tiesAndTotalBet = OrderTiedPlayers(tiesAndTotalBet);
-
-                    // While there are still players in the tiesAndTotalBet vector
-                    while (tiesAndTotalBet.size()) {
-                        // If the player still has some totalBet remaining
-                        if (players.at(tiesAndTotalBet.at(0).first).GetTotalBet() != 0) {
-                            // Cycle through all the players with totalBet remaining, 
-                            // and add either the winner's totalBet, or the currentPlayer's totalBet, whichever is smaller, to the totalInPot
-                            int totalInPot = 0;
-                            for (int l = 0; l < players.size(); l++) {
-                                if (players.at(l).GetTotalBet() != 0) {    
-                                    if (players.at(l).GetTotalBet() <= players.at(tiesAndTotalBet.at(0).first).GetTotalBet()) {
-                                        totalInPot += players.at(l).GetTotalBet();
-                                    }
-                                    else {
-                                        totalInPot += players.at(tiesAndTotalBet.at(0).first).GetTotalBet();
-                                    }
-                                }
-                            }
-                            // Calculate what fraction of that pot goes to the current winner given how many are tied
-                            int currentWonAmount = totalInPot / tiesAndTotalBet.size();
-                            // If the chips do not divide evenly among the tied winners, give the currentPlayer 1 extra chip
-                            if (totalInPot % tiesAndTotalBet.size() != 0) {
-                                AddBetsToWinner(tiesAndTotalBet.at(0).first, winnerIndexAndTies, currentWonAmount + 1);
-                            }
-                            // Otherwise just give the divided amount to the player, and subtract it from all the other players
-                            else {
-                                AddBetsToWinner(tiesAndTotalBet.at(0).first, winnerIndexAndTies, currentWonAmount);
-                            }
-                        }
-                        // After this player has received their portion of the pot, delete them from the tiesAndTotalBet vector
-                        tiesAndTotalBet.erase(tiesAndTotalBet.begin());
-                        // Increment the m value tracking what player has been paid in the winnerIndexAndTies vector
-                        m++;
-                    }
-                    m--;
+                    screen << players.at(winnerIndexAndTies.at(i).first).GetName() << " had " << players.at(winnerIndexAndTies.at(i).first).GetBestHand();
                 }
-            }
-        }
-
-        // Then export the results to a txt file for later review
-        ExportStatsToFile(winnerIndexAndTies, roundNumber);
-
-        //Clears screen for each player so previous information is not seen
-        std::cout << "\x1B[2J\x1B[H";
 
-        // After exporting the information to the txt file, print to the console who won
-        // And include the type of winning hand the player won with (flush, straight, full house, etc.)
-        for (int i = 0; i < winnerIndexAndTies.size(); i++) {
-            if (i == 0 && winnerIndexAndTies.at(i).second == 0) {
-                std::cout << players.at(winnerIndexAndTies.at(i).first).GetName() << " won with " << players.at(winnerIndexAndTies.at(i).first).GetBestHand();
-            }
-            else if (winnerIndexAndTies.at(i).second != 0 && winnerIndexAndTies.at(i).second == winnerIndexAndTies.at(0).second) {
-                std::cout << players.at(winnerIndexAndTies.at(i).first).GetName() << " tied with " << players.at(winnerIndexAndTies.at(i).first).GetBestHand();
-            }
-            else {
-                std::cout << players.at(winnerIndexAndTies.at(i).first).GetName() << " had " << players.at(winnerIndexAndTies.at(i).first).GetBestHand();
+                screen << '\n';
             }
 
-            std::cout << std::endl;
+            // Then add a pause for everyone to see and review the results before starting another hand
+            std::string pause = "";
+            screen << "Press 'enter' to continue...\n";
+            screen.Present();
+            getline(std::cin, pause);
         }
-
-        // Then add a pause for everyone to see and review the results before starting another hand
-        std::string pause = "";
-        std::cout << "Press 'enter' to continue...\n";
-        getline(std::cin, pause);
     }   
     // If, however, the player won because everyone else folded
     else {
-        // Just find that winning player
-        // subtract the winner's totalBet from everyone else
-        // and export to the txt file that the winner won because everyone else folded
-        int winnerIndex = FindNotFolded();
-        AddBetsToWinnerFolded(winnerIndex);
-        ExportWinnerFolded(roundNumber);
+        // Just export to the txt file that the winner won because everyone else folded
+        if (exportStats) {
+            ExportWinnerFolded(roundNumber);
+        }
     }
 
     // Then check if any players are out of the game because they have no chips left
     for (int i = 0; i < players.size(); i++) {
         if (players.at(i).GetChips() == 0) {
+            // If the player leaving was the dealer, pass the dealer marker back to the player before them,
+            // so AssignDealer still moves the dealer on to the player who was after them
+            bool wasDealer = players.at(i).isDealer();
+
             // If they are, erase them from the players vector
             players.erase(players.begin() + i);
+
+            if (wasDealer && !players.empty()) {
+                players.at((i + players.size() - 1) % players.size()).FlipDealerStat();
+            }
             i--;
         }
         // Otherwise make sure their folded stat gets reset to false and their cards and cardStats are cleared
@@ -544,201 +575,119 @@ std::vector<Player> Round::DivvyPots(int roundNumber, bool winnerByFolding) {
             players.at(i).EmptyHandStats();
         }
     }
-
-    // Then return the revised players vector
-    return players;
 }
 
-// Take in a vector of pairs containing a player's totalBet as the second element,
-// and order the pairs in increasing order based on that totalBet value, then return the ordered vector
-std::vector<std::pair<int, int>> Round::OrderTiedPlayers(std::vector<std::pair<int, int>> tiesAndTotalBet) {
-    // Create new vector to place the elements in order
-    std::vector<std::pair<int, int>> newOrderedTies = {tiesAndTotalBet.at(0)};
-
-    // Cycle through the elements in the original vector, tiesAndTotalBet
-    for (int i = 1; i < tiesAndTotalBet.size(); i++) {
-        // Then compare its elements to those in the new vector, newOrderedTies
-        for (int j = 0; j < newOrderedTies.size(); j++) {
-            // If the totalBet is smaller than the current element
-            if (tiesAndTotalBet.at(i).second < newOrderedTies.at(j).second) {
-                // Then insert the tiesAndTotalBet element into the newOrderedTies vector and break the loop
-                newOrderedTies.insert(newOrderedTies.begin() + j, tiesAndTotalBet.at(i));
-                break;
-            }
-            // If the loop has reached the end of newOrderedTies with no larger totalBets found
-            else if (j == newOrderedTies.size() - 1) {
-                // Just insert the new element at the end of newOrderedTies
-                newOrderedTies.push_back(tiesAndTotalBet.at(i));
-            }
-        }
+// Settle the hand with the pot engine: every player's totalBet, whether they folded and their hand key go in,
+// and the chips each player won (or gets back) come out, after which every totalBet is back to 0
+void Round::PayOutPots() {
+    std::vector<PotEntry> entries(players.size());
+    for (size_t i = 0; i < players.size(); i++) {
+        entries[i].totalBet = players.at(i).GetTotalBet();
+        entries[i].folded = players.at(i).GetFoldedStat();
+        entries[i].handKey = players.at(i).GetHandKey();
     }
 
-    // Return the newly ordered vector
-    return newOrderedTies;
-}
+    // Odd chips from a split pot go to the tied players closest to the left of the dealer
+    std::vector<int> chipsWon = SettlePots(entries, (currentDealer + 1) % players.size());
 
-// A function that takes in the index of the winnerIndexAndTies vector of the winning player
-// and includes a winnerShare if this player tied and was dividing up their winnings
-// It then subtracts the specified amount (or the winner's totalBet) from every player's totalBet greater than 0
-// and adds that amount to the winning player
-void Round::AddBetsToWinner(int winnerIndex, std::vector<std::pair<int, int>> &winnerIndexAndTies, int winnerShare) {
-    // If a divided up share is not specified
-    if (!winnerShare) {
-        // winnerShare becomes the totalBet of the winner
-        winnerShare = players.at(winnerIndexAndTies.at(winnerIndex).first).GetTotalBet();
+    for (size_t i = 0; i < players.size(); i++) {
+        players.at(i).TakeWinnings(chipsWon[i], chipsWon[i]);
+        players.at(i).SubtractTotalBet(players.at(i).GetTotalBet());
     }
 
-    // It then loops through every player
-    for (size_t i = 0; i < players.size(); i++) {
-        // If the player has a totalBet greater than zero remaining
-        if (players.at(i).GetTotalBet() > 0) {
-            // Add the winnerShare or the losing player's totalBet, whichever is smaller, to the winner's chips
-            players.at(winnerIndexAndTies.at(winnerIndex).first).TakeWinnings(players.at(i).GetTotalBet(), winnerShare);
-            // Then subtract that same value from the loser's totalBet, tracking what is remaining to lose, if anything
-            players.at(i).SubtractTotalBet(winnerShare);
-        }
+    if (recording) {
+        handRecord.chipsWon = chipsWon;
     }
 }
 
-// If a player won by everyone else folding, and no winnerIndexAndTies was created
-// then this function takes in the index of the player vector who won and adds the winnings
-// to that player's chips and subtracts from every other player's totalBet
-void Round::AddBetsToWinnerFolded(int winnerIndex) {
-    int winningAmount = players.at(winnerIndex).GetTotalBet();
-    
-    // Loop through every player
+// Order the players who have not folded from the best hand key to the worst, with one sort
+// Players with equal hand keys are listed from the highest index down, and each group of tied players
+// shares a tie number (starting at 1), while a player who tied nobody has 0
+std::vector<std::pair<int, int>> Round::RankHands() {
+    std::vector<std::pair<int, int>> winnerIndexAndTies;
     for (size_t i = 0; i < players.size(); i++) {
-        // If the player had made a totalBet, then subtract that amount from the loser's totalBet 
-        // and add it to the winner's chips
-        if (players.at(i).GetTotalBet() > 0) {
-            players.at(winnerIndex).TakeWinnings(players.at(i).GetTotalBet(), winningAmount);
-            players.at(i).SubtractTotalBet(winningAmount);
+        if (!players.at(i).GetFoldedStat()) {
+            winnerIndexAndTies.push_back(std::make_pair(i, 0));
         }
     }
-}
 
-// This function takes in the vector of pairs, winnerIndexAndTies, the index i tracking the current player index in the players vector,
-// and the count of how many times this function has been called recursively
-// It then orders the currentPlayer (at index i) in the winnerIndexAndTies vector, in decreasing order,
-// based on the size of the values in the handStats vector
-void Round::OrderPlayerHands(std::vector<std::pair<int, int>> &winnerIndexAndTies, int i, int recursiveCount) {
-    // If the recursiveCount gets to then end of the winnerIndexAndTies vector without 
-    // successfully finding a smaller handStats vector
-    if (recursiveCount == winnerIndexAndTies.size()) {
-        // Then it gets placed at the end of the winnerIndexAndTies vector
-        winnerIndexAndTies.push_back(std::make_pair(i, 0));
-        return;
-    }
-    
-    int bestHandIndex = winnerIndexAndTies.at(0 + recursiveCount).first;
-
-    // If the currentPlayer's handStats vector is larger than the handStats of the player at
-    // the current index of winnerIndexAndTies
-    if (players.at(i).GetHandStats() > players.at(bestHandIndex).GetHandStats()) {
-        // Insert the currentPlayer's index as the pair's first value, and 0 as the second value,
-        // because no tie was found
-        winnerIndexAndTies.insert(winnerIndexAndTies.begin() + recursiveCount, std::make_pair(i, 0));
-    }
-    // If the currentPlayer's handStats tied the current winnerIndexAndTies handStats
-    else if (players.at(i).GetHandStats() == players.at(bestHandIndex).GetHandStats()) {
-        // Then check if the winnerIndexAndTies player already has tied someone else
-        int nextBestTieCount = winnerIndexAndTies.at(recursiveCount).second; 
-        
-        // If that player had already tied someone else
-        if (nextBestTieCount > 0) {
-            // Then insert the new player index into winnerIndexAndTies, and use the tied value provided from the winnerIndexAndTies player
-            winnerIndexAndTies.insert(winnerIndexAndTies.begin() + recursiveCount, std::make_pair(i, nextBestTieCount));
-        }
-        // Otherwise, insert the new player index, but use the recursiveCount + 1 as the second value for both tied pairs in winnerIndexAndTies
-        else {
-            winnerIndexAndTies.insert(winnerIndexAndTies.begin() + recursiveCount, std::make_pair(i, 1 + recursiveCount));
-            winnerIndexAndTies.at(1 + recursiveCount).second = 1 + recursiveCount;
-        }
+    std::sort(winnerIndexAndTies.begin(), winnerIndexAndTies.end(), [this](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+        unsigned int keyA = players.at(a.first).GetHandKey();
+        unsigned int keyB = players.at(b.first).GetHandKey();
+        return keyA != keyB ? keyA > keyB : a.first > b.first;
+    });
 
-        // Then go to the index just past the newly tied players
-        int j = 2 + recursiveCount;
-        // Track how many players tied with those two and keep incrementing the index until it gets to a player not tied with the inserted player
-        while (j < winnerIndexAndTies.size() && winnerIndexAndTies.at(j).second != winnerIndexAndTies.at(recursiveCount).second) {
+    // Give each run of equal hand keys its own tie number
+    int tieNumber = 0;
+    for (size_t i = 0; i < winnerIndexAndTies.size(); ) {
+        size_t j = i + 1;
+        while (j < winnerIndexAndTies.size() &&
+               players.at(winnerIndexAndTies.at(j).first).GetHandKey() == players.at(winnerIndexAndTies.at(i).first).GetHandKey()) {
             j++;
         }
-
-        // Then increment the second value in the pair (the tied value) for every tied group after the inserted tied group
-        // This will ensure that no two different tied groups will have the same tied value
-        for (j; j < winnerIndexAndTies.size(); j++) {
-            if (winnerIndexAndTies.at(j).second >= 1) {
-                winnerIndexAndTies.at(j).second++;
+        if (j - i > 1) {
+            tieNumber++;
+            for (size_t k = i; k < j; k++) {
+                winnerIndexAndTies.at(k).second = tieNumber;
             }
         }
-    }
-    // If the handStats of the currentPlayer is smaller, then call OrderPlayerHands and increment the recursiveCount
-    else {
-        OrderPlayerHands(winnerIndexAndTies, i, recursiveCount + 1);
+        i = j;
     }
 
-    return;
+    return winnerIndexAndTies;
 }
 
 // This function exports to a txt file the name of the winning player and the round number they won
 int Round::ExportWinnerFolded(int roundNumber) {
-    std::ofstream dataFile;
-
-    // Open the file for appending and check itt make sure it opened successfully
-    dataFile.open("game_stats.txt", std::ios_base::app);
-
-    if (!dataFile.is_open()) {
-        std::cout << "Could not open file: 'game_stats.txt'\n";
+    // Check to make sure the game's log opened the file successfully
+    if (!GameStatsLog().IsOpen()) {
+        std::cout << "Could not open file: '" << GAME_STATS_FILE << "'\n";
 
         return 1;
     }
 
-    Player winner = players.at(FindNotFolded());
-
-    // Then write to the opened file the information of who won, the round number, and the status of winning by folding
-    dataFile << winner.GetName() << " won round " << roundNumber << " because everyone else folded.";
-
-    dataFile << std::endl;
+    const Player &winner = players.at(FindNotFolded());
 
-    // Then close the file
-    dataFile.close();
+    // Then write to the log the information of who won, the round number, and the status of winning by folding
+    std::ostringstream record;
+    record << winner.GetName() << " won round " << roundNumber << " because everyone else folded.\n";
+    GameStatsLog().Write(record.str());
 
     return 0;
 }
 
-// This function exports to a txt file the winner, the handStats information as a string,
+// This function exports to a txt file the winner, the hand key information as a string,
 // and the hand itself, to review to make sure the analysis was accurate
 int Round::ExportStatsToFile(std::vector<std::pair<int, int>> &winnerIndexAndTies, int roundNumber) {
-    std::ofstream dataFile;
-
-    // Open the file for appending and check itt make sure it opened successfully
-    dataFile.open("game_stats.txt", std::ios_base::app);
-
-    if (!dataFile.is_open()) {
-        std::cout << "Could not open file: 'game_stats.txt'\n";
+    // Check to make sure the game's log opened the file successfully
+    if (!GameStatsLog().IsOpen()) {
+        std::cout << "Could not open file: '" << GAME_STATS_FILE << "'\n";
 
         return 1;
     }
 
-    Player winner = players.at(winnerIndexAndTies.at(0).first);
+    const Player &winner = players.at(winnerIndexAndTies.at(0).first);
     
     // Then export the player's name, the round they won, the best winning hand according to the hand checks,
-    // and then loops through each card in the hand and exports the string of each card
-    dataFile << winner.GetName() << " won round " << roundNumber << " with ";
-    dataFile << winner.GetBestHand() << ", using the cards: ";
-    std::vector<Card> winnerHand = winner.GetHand();
-    for (int i = 0; i < winnerHand.size(); i++) {
-        dataFile << winnerHand.at(i).GetCardString();
+    // and then loops through each card in the hand (along with the community cards) and exports the string of each card
+    // The whole record is put together first and handed to the log in one piece
+    std::ostringstream record;
+    record << winner.GetName() << " won round " << roundNumber << " with ";
+    record << winner.GetBestHand() << ", using the cards: ";
+    Card winnerHand[7];
+    int numCards = MaskToCards(winner.GetHand() | communityHand, winnerHand);
+    for (int i = 0; i < numCards; i++) {
+        record << winnerHand[i].GetCardName();
         // Include punctuation as necessary
-        if (i == winnerHand.size() - 2) {
-            dataFile << ", and ";
+        if (i == numCards - 2) {
+            record << ", and ";
         }
-        else if (i != winnerHand.size() - 1) {
-            dataFile << ", ";
+        else if (i != numCards - 1) {
+            record << ", ";
         }
     }
-    dataFile << std::endl;
-
-    // Then close the file
-    dataFile.close();
+    record << "\n";
+    GameStatsLog().Write(record.str());
 
     return 0;
 }
\ No newline at end of file
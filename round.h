@@ -3,15 +3,33 @@
 
 #include "player.h"
 #include "deck.h"
+#include "action.h"
+#include "hand_history.h"
+
+// The forced bets posted at the start of each round by the two players after the dealer
+struct Blinds {
+    int smallBlind = 1;
+    int bigBlind = 2;
+};
 
 // Class constructed to handle all the events within a game's individual round
 class Round {
     public:
-        /* Initializer function, requiring a parameter of a vector of players that serves as the round's players.
-           When a Round class is created, it populates a new Deck class consisting of a series of 52 Cards.
-           The Round also initializes the highestBet to be 2 for the big blind, and a currentDealer variable starting at 0
-        */
-        Round(std::vector<Player> &players);
+        /* Initializer function, requiring a parameter of a vector of players that serves as the round's players, the table's Deck,
+           and the ActionProvider that makes every betting decision during the round (people at the console, code, or a script).
+           The Round keeps a reference to the players vector rather than a copy, so every bet, win and removed player changes the
+           table's own players directly and nothing has to be copied back when the round is over.
+           If exportStats is false the results of the round are not written to the txt file, for rounds played in large numbers by code.
+           The same Deck is used for every round of the game: when a Round class is created, it puts the previous round's
+           cards back into the Deck rather than building a new Deck of 52 Cards, and every card dealt during the round
+           is then drawn at random from the cards left.
+           The Round also initializes the highestBet to be the big blind (2 unless other blinds are given), and a currentDealer variable starting at 0.
+           If history has a writer, everything that happens in the round (seats, cards, every action and the chips won) is written to
+           the hand history file (see hand_history.h) as one hand of the game with history's gameId. If history has a "played" record,
+           the same record is copied into it at the end of the round.
+        */
+        Round(std::vector<Player> &players, Deck &tableDeck, ActionProvider &actions, bool exportStats = true, Blinds blinds = Blinds(),
+              HandHistoryGame history = HandHistoryGame());
 
         /* This method uses the member players vector to loop through each player
            and deal the specified amount of cards. It is called to deal player cards
@@ -20,7 +38,8 @@ class Round {
         */
         void DealCards();
         /* This method takes in a parameter of the number of cards to be dealt. It
-           places the dealt cards within the member communityHand vector, increasing that vector's size. It is called
+           places the dealt cards within the member communityHand set of cards, adding them to that set. Every player who has not folded
+           also receives the new cards through AddCommunityCards, keeping their best hand so far up to date street by street. It is called
            when the community hand is supposed to receive more cards as part of the game's structure
         */
         void DealCommunityCards(int numCards);
@@ -49,12 +68,14 @@ class Round {
            the player member function Ante to subtract the appropriate amount from that player's member variable chips and adds that to the 
            player's member variable totalBet. The method then does this with the player to the left of the small blind, who is assigned as 
            owing the big blind and the same functions are called but just for the different player and the higher ante amount.
+           When the hand is being recorded, every player's name and chips are noted down first, before any blind is posted.
         */
         void CollectAnte();
         /* This method takes in a roundNumber as a parameter if the community hand has not been dealt any cards yet. Otherwise, the parameter 
            is assigned as -1 to be ignored by the method. The method then interacts with every user in the player vector, 
-           asking if the user wishes to raise, call, or fold. Depending on the user's response, either the player's member functions
-           BetChips or CallBet are called, or the player's member variable "folded" is set to true, respectively. If chips are bet, the player
+           asking the round's ActionProvider whether the player raises, checks, calls, goes all-in or folds (printing the table first with PrintHandText
+           if the provider is played at the console). Depending on the decision, ApplyAction calls either the player's member functions
+           RaiseBet or CallBet, or sets the player's member variable "folded" to true. If chips are bet, the player
            has those chips subtracted from their member variable chips and their totalBet variable is increased by the same amount. This process of
            looping through players in the players vector continues until an entire loop goes through without anyone increasing the bet, or until everyone 
            but 1 person folds, or until everyone has either folded or gone all-in.
@@ -62,26 +83,41 @@ class Round {
            no available money left to bet because everyone has gone all-in.
         */
         void PlaceBet(int roundNumber=-1);
+        /* This method fills in a TurnState with everything the player at playerIndex can see when deciding what to do: their cards and best hand so far,
+           the community cards, their chips and totalBet, the highestBet and what it costs them to call, the pot, and how many players have folded or
+           gone all-in. It is called by PlaceBet before each decision and does not change anything.
+        */
+        TurnState GetTurnState(int playerIndex, int roundNumber, bool bigBlindOption);
+        /* This method carries out a player's decision. Decisions the player cannot make are first turned into the closest one they can:
+           checking with a bet to call is a call, raising with too few chips (or by more than they have) goes all-in, raising by less than 1
+           raises by 1, and the big blind folding when they could check for free before the flop is a check. It returns true if the decision
+           raised the member variable highestBet, and is called only by PlaceBet. When the hand is being recorded, the decision is noted down
+           as it was actually applied: the chips it put in, and whether it was a fold, check, call, raise or all-in.
+        */
+        bool ApplyAction(int playerIndex, PlayerAction action);
+        /* This method adds an action to the hand's record when the hand is being recorded (and does nothing otherwise). The street is worked out
+           from how many community cards have been dealt. It is called only by ApplyAction, once for every decision applied.
+        */
+        void RecordAction(int playerIndex, ActionType type, int amount);
         /* This method loops through all players in the member players vector who do not have the player variable "folded" set to true.
-           For each player, the method calls the player member function EvaluateCards to alter the player's handStats vector,
-           with the first int value in the vector representing the type of best winning hand (straight, flush, pair, etc.), and the remaining
-           5 int values being the 5 highest cards (for example, with the full house, the second value 
-           in the handStats vector would be the three-of-a-kind card number, and the third value in the handStats vector would be the pair card
-           number. All other values in the handStats vector would be 0 as the other 3 card numbers are repeats of what already is listed). ScoreHands 
+           For each player, the method calls the player member function EvaluateCards to set the player's hand key, a single integer
+           packing the type of best winning hand (straight, flush, pair, etc.) in its top bits, followed by 
+           5 card numbers being the 5 highest cards (for example, with the full house, the first card number
+           in the hand key would be the three-of-a-kind card number, and the second card number would be the pair card
+           number. All other card numbers in the hand key would be 0 as the other 3 card numbers are repeats of what already is listed). ScoreHands 
            is called after all betting is complete and only if there is more than one player who has not folded.
         */
         void ScoreHands();
         /* This method takes in the game's roundNumber and boolean value that is assigned true if a player won a round because everyone
-           else folded. Upon being called, DivvyPots takes one of 2 paths, either organizing the players from best hand to worst hand using the player's
-           handStats vector populated by the ScoreHands method, or begins adding the pot's winnings to the player who remained after everyone else
-           folded. If ScoreHands is called, then the hands are ordered by the OrderPlayerHands method, properly handling ties by doing a second ordering,
-           from least bet to most bet with the OrderTiedPlayers method. After the ordering is complete, AddBetsToWinners loops through everyone in order,
-           so that everyone who should receive money from the pot, does, resetting the player variable totalBet in the process. DivvyPots then clears every
-           player's hands and resets all player folded variables so that no player is marked as being folded. Finally DivvyPots deletes any players
-           that at the end of the round have no chips. DivvyPots returns the updated player vector to be used for future rounds as necessary. DivvyPots is
+           else folded. Upon being called, DivvyPots first settles the pot with the PayOutPots method, which works the same way whether the
+           hand went to a showdown or everyone but one player folded. If there was a showdown, the hands are then ordered by the RankHands method,
+           using the hand keys populated by the ScoreHands method, so the results can be exported and shown. DivvyPots then clears every
+           player's hands and resets all player folded variables so that no player is marked as being folded (if the hand is being recorded,
+           it is written to the hand history file just before this, while the hole cards are still known). Finally DivvyPots deletes any players
+           that at the end of the round have no chips, handing the dealer marker back to the previous player if the dealer was deleted. The players vector is changed in place, ready for the next round. DivvyPots is
            called at the end of each round as a way of summing up the events of each round.
         */
-        std::vector<Player> DivvyPots(int roundNumber, bool winnerByFolding = false);
+        void DivvyPots(int roundNumber, bool winnerByFolding = false);
         /* This method loops through the member players vector and tracks the number of players that either
            have 0 chips left (because they are all-in), or have their member folded variable marked as true. If either of these
            statements is true, the method counts that player. The method returns the resultant counted total. CountAllInAndFolded is called
@@ -104,79 +140,69 @@ class Round {
         */
         int CountAllIn();
 
-        /* This method prints to the console all pertinent information a player (at the parameter's playerIndex value) might need when making a bet during a round.
+        /* This method puts on the console screen (see screen_renderer.h) all pertinent information a player (at the parameter's playerIndex value) might need when making a bet during a round.
            This information includes a list of all players who have folded, using the PrintFolded function, all players who are all-in,
            using the PrintAllIns function, what the highestBet currently is, using the Round's member variable, how many chips the current player
            has, using the Player member function GetTotalBet, the parameter roundNumber (if it is greater than 1), and the player's cards as well as the community cards, using
-           the Card's GetCardString function. PrintHandText is called before every player makes a bet. No values are changed during this process.
+           the Card's GetCardName function. PrintHandText is called before every player makes a bet. The turn handoff is shown right away, but the
+           table is only shown along with the question the ConsoleActionProvider adds under it, as one screen. No values are changed during this process.
         */
         void PrintHandText(int playerIndex, int roundNumber);
-        /* This method specializes in printing to the console the cards in the member communityHand vector and is called only within the PrintHandText function.
-           It does not change any values in the process and only calls the card's GetCardString function.
+        /* This method specializes in adding to the console screen the cards in the member communityHand set and is called only within the PrintHandText function.
+           It does not change any values in the process and only uses the card's GetCardName function.
         */
         void PrintCommunityHand();
         /* This method is called only during the PrintHandText function and only if there are AllIns (determined by the
-           CountAllIn function). No values are changed when calling this function and player names are just printed
-           to the console if that player is all-in.
+           CountAllIn function). No values are changed when calling this function and player names are just added
+           to the console screen if that player is all-in.
         */
         void PrintAllIns();
         /* This method is called only during the PrintHandText function and only if there are folded players (determined by the
-           CountFolded function). No values are changed when calling this function and player names are just printed
-           to the console if that player has folded.
+           CountFolded function). No values are changed when calling this function and player names are just added
+           to the console screen if that player has folded.
         */
         void PrintFolded(); 
-        /* This recursive method is called when ordering the hands of all players who have not folded. After the player at index 0
-           is added to winnerIndexAndTies (a parameter of this method, consisting of a vector of pairs), each successive player (looping through all the players) 
-           compares their handStats vector to the first player in the winnerIndexAndTies vector. If the winnerIndexAndTies player's
-           handStats vector is better (higher int values), then OrderPlayerHands is called recursively (with the recursiveCount being tracked), until it finds a player that 
-           has either a lower or equally high handStats vector. If OrderPlayerHands reaches the end of the winnerIndexAndTies vector 
-           finding no hand lower, then the currentPlayer's index and tied value pair is inserted at the end of the winnerIndexAndTies vector.
-           This process continues until all players who have not folded are present in the winnerIndexAndTies vector, which is updated
-           by reference for future use in the DivvyPots method, from which this method is called.
-        */
-        void OrderPlayerHands(std::vector<std::pair<int, int>> &winnerIndexAndTies, int i, int recursiveCount);
-        /* This method is called only if there are tied players in the winnerIndexAndTies vector, meaning the second
-           value in the winnerIndexAndTies vector pair is greater than 0. If that is the case, AND these players had a 
-           good enough hand to share some of the pot, then this method takes the parameter tiesAndTotalBet vector and re-orders
-           it by ranking the totalBet (the second value in the pair) from smallest to to largest. Once the newOrderedTies vector
-           has all the elements of tiesAndTotalBet, OrderTiedPlayers returns the new vector to replace the previous vector that was 
-           unordered. OrderTiedPlayers is only called in DivvyPots and only for the specific purpose of sorting a group
-           of tied players. 
-        */
-        std::vector<std::pair<int, int>> OrderTiedPlayers(std::vector<std::pair<int, int>> tiesAndTotalBet);
-        /* This method takes in the current winner's index in the winnerIndexAndTies vector, the winnerIndexAndTies
-           vector itself, and, if the winner tied with others, the winnerShare int value. The method then loops through all the players
-           in the players vector. If a player has a totalBet greater than 0, the winner adds to their member chips either the loser's totalBet 
-           or the winner's totalBet, whichever is smaller, and then subtracts that same amount from the loser's totalBet. 
-           This method is called within the DivvyPots method and as many times as necessary, until all players have a totalBet of 0. 
-        */
-        void AddBetsToWinner(int winnerIndex, std::vector<std::pair<int, int>> &winnerIndexAndTies, int winnerShare=0);
-        /* Similar to AddBetsToWinner, this function specializes in the situation where all players have folded except one.
-           In this case, the method loops through all the players who have a totalBet greater than zero. All totalBets from losers
-           get added to the winner of the round (dictated by the index parameter associated with the players vector) as only that 
-           player will get any chips. And then the losing player's totalBet returns to 0. Again, this function is only called during 
-           DivvyPots after gameplay has finished for a game round.
-        */
-        void AddBetsToWinnerFolded(int winnerIndex);
+        /* This method is called at the start of DivvyPots to settle the hand. It hands every player's totalBet, folded variable and
+           hand key to the pot engine (SettlePots in pot.h), which sorts the players by totalBet once to build the main pot and
+           any side pots, gives each pot to the best hand among the players who did not fold and bet up to that pot's level,
+           splitting tied pots evenly with any odd chips going to the tied players closest to the left of the dealer, and returns
+           any part of a bet that nobody still in the hand matched. Each player's chips are increased by what they won (which is also
+           noted down when the hand is being recorded), and every totalBet is reset to 0.
+        */
+        void PayOutPots();
+        /* This method is called in DivvyPots when more than one player has not folded, and returns the winnerIndexAndTies vector
+           used to export and print the results: a pair for each player who has not folded, holding the player's index in the
+           players vector and a tie number, ordered from the best hand key to the worst with one sort. Players who tied nobody
+           have a tie number of 0, and each group of players with equal hand keys shares a tie number of its own (starting at 1).
+        */
+        std::vector<std::pair<int, int>> RankHands();
         /* This method exports the winner's name, roundNumber, and the hands of all players who did not fold (as listed by the 
            winnerIndexAndTies vector parameter) to a txt file for tracking the results of each round of the game. This method
            is called at the end of each round unless ExportWinnerFolded is called instead, meaning hands are not shown at the end of the round.
+           The record is handed to the program's log (GameStatsLog in log_writer.h), which writes it to the file in the background.
            No variables are changed in exporting this information to the txt file.
         */
         int ExportStatsToFile(std::vector<std::pair<int, int>> &winnerIndexAndTies, int roundNumber);
         /* This method exports the winner's name and that they won because everyone else folded to a txt file for tracking 
            the results of each round of the game. This method is called at the end of each round unless ExportStatsToFile 
-           is called instead, meaning hands hand information is available and multiple players did not fold. No variables 
-           are changed in exporting this information to the txt file.
+           is called instead, meaning hands hand information is available and multiple players did not fold. Like ExportStatsToFile,
+           it writes through the program's log. No variables are changed in exporting this information to the txt file.
         */
         int ExportWinnerFolded(int roundNumber);
 
     private: 
         int highestBet;
-        std::vector<Player> players;
-        Deck tableDeck;
+        std::vector<Player> &players;
+        Deck &tableDeck;
+        ActionProvider &actions;
+        bool exportStats;
+        Blinds blinds;
         int currentDealer;
-        std::vector<Card> communityHand;
+        CardMask communityHand;
+        // Where the hand is recorded (if anywhere), whether it is being recorded at all, and the record being filled in as the hand is played
+        HandHistoryGame history;
+        bool recording;
+        HandRecord handRecord;
 
 };
 
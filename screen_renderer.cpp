@@ -0,0 +1,129 @@
+#include <iostream>
+#include <string>
+#include <charconv>
+#include <cstdio>
+
+#include "screen_renderer.h"
+
+// A frame is written straight to the console's file descriptor on POSIX systems; elsewhere it goes through stdout in one fwrite
+#if defined(__unix__) || defined(__APPLE__)
+#define HAS_POSIX_WRITE 1
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+// Initialization of a renderer, setting aside the memory for its frames
+ScreenRenderer::ScreenRenderer(size_t capacity) {
+    frame.reserve(capacity);
+    quiet = false;
+}
+
+// Turn quiet mode on or off, throwing away anything composed so far
+void ScreenRenderer::SetQuiet(bool quiet) {
+    this->quiet = quiet;
+    frame.clear();
+}
+
+// Return whether the renderer is in quiet mode
+bool ScreenRenderer::IsQuiet() {
+    return quiet;
+}
+
+// Add text to the frame
+ScreenRenderer &ScreenRenderer::operator<<(const std::string &text) {
+    if (!quiet) {
+        frame += text;
+    }
+    return *this;
+}
+
+// Add text to the frame
+ScreenRenderer &ScreenRenderer::operator<<(const char *text) {
+    if (!quiet) {
+        frame += text;
+    }
+    return *this;
+}
+
+// Add a single character to the frame
+ScreenRenderer &ScreenRenderer::operator<<(char letter) {
+    if (!quiet) {
+        frame += letter;
+    }
+    return *this;
+}
+
+// Add a number to the frame, written straight into it without making a string first
+ScreenRenderer &ScreenRenderer::operator<<(int number) {
+    if (!quiet) {
+        char digits[16];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), number);
+        frame.append(digits, result.ptr);
+    }
+    return *this;
+}
+
+// Add a card's name to the frame, from the table of names every card shares
+ScreenRenderer &ScreenRenderer::operator<<(const Card &card) {
+    if (!quiet) {
+        frame += card.GetCardName();
+    }
+    return *this;
+}
+
+// Add each card's name, putting ", and " before the last card and ", " between the others
+void ScreenRenderer::AddCardList(CardMask cards) {
+    if (quiet) {
+        return;
+    }
+
+    Card cardList[7];
+    int numCards = MaskToCards(cards, cardList);
+    for (int i = 0; i < numCards; i++) {
+        frame += cardList[i].GetCardName();
+        if (i == numCards - 2) {
+            frame += ", and ";
+        }
+        else if (i != numCards - 1) {
+            frame += ", ";
+        }
+    }
+}
+
+// Write the whole frame out and empty it, keeping its memory for the next one
+void ScreenRenderer::Present() {
+    if (quiet || frame.empty()) {
+        frame.clear();
+        return;
+    }
+
+    // Anything printed through std::cout (or stdout) before this frame has to reach the console first
+    std::cout.flush();
+    std::fflush(stdout);
+
+#ifdef HAS_POSIX_WRITE
+    // A single write takes the whole frame unless the console is very slow to drain, in which case the rest follows on
+    size_t written = 0;
+    while (written < frame.size()) {
+        ssize_t count = write(STDOUT_FILENO, frame.data() + written, frame.size() - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        written += count;
+    }
+#else
+    std::fwrite(frame.data(), 1, frame.size(), stdout);
+    std::fflush(stdout);
+#endif
+
+    frame.clear();
+}
+
+// The renderer is made the first time it is needed
+ScreenRenderer &ConsoleScreen() {
+    static ScreenRenderer screen;
+    return screen;
+}
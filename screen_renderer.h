@@ -0,0 +1,46 @@
+#ifndef SCREEN_RENDERER_H
+#define SCREEN_RENDERER_H
+
+#include <string>
+
+#include "card.h"
+
+// The bytes set aside for a screen up front: far more than the largest table the game draws, so composing a screen never allocates memory
+const size_t DEFAULT_SCREEN_CAPACITY = 1 << 14;
+// The escape codes that clear the terminal and move the cursor to its top-left corner
+const std::string CLEAR_SCREEN = "\x1B[2J\x1B[H";
+
+/* Class created for drawing the console game one whole screen at a time. Everything shown is added to a frame buffer
+   set aside once, and Present writes the frame out with a single system call and starts a new one. A terminal (or a slow
+   SSH link) then gets each screen in one piece instead of as dozens of small writes, and nothing is flushed in between.
+   What is added is kept until Present is called, so a screen can be put together by more than one part of the game:
+   the Round adds the table, and the ConsoleActionProvider adds its question and presents the lot before waiting for an answer.
+
+   In quiet mode nothing is composed or written at all, and the console game skips drawing the table and pausing between
+   players and hands (see ConsoleActionProvider::ShowsTable), for batch runs that feed every decision in from a file.
+*/
+class ScreenRenderer {
+    public:
+        ScreenRenderer(size_t capacity = DEFAULT_SCREEN_CAPACITY);
+        void SetQuiet(bool quiet);
+        bool IsQuiet();
+        // Add text, a number, or a card's name to the frame
+        ScreenRenderer &operator<<(const std::string &text);
+        ScreenRenderer &operator<<(const char *text);
+        ScreenRenderer &operator<<(char letter);
+        ScreenRenderer &operator<<(int number);
+        ScreenRenderer &operator<<(const Card &card);
+        // Add the names of a set of cards, separated by commas with an "and" before the last, such as "2 of Hearts, and Ace of Spades"
+        void AddCardList(CardMask cards);
+        // Write the frame to the console in one go (unless quiet) and start a new one
+        void Present();
+
+    private:
+        std::string frame;
+        bool quiet;
+};
+
+// Return the renderer for the console shared by the whole program
+ScreenRenderer &ConsoleScreen();
+
+#endif
@@ -0,0 +1,462 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include "simulation.h"
+#include "game.h"
+#include "hand_history.h"
+#include "strategy.h"
+#include "thread_pool.h"
+#include "snapshot.h"
+
+// How a single simulated game ended
+struct GameRecord {
+    int rounds = 0;
+    // The index in SimulationOptions::strategies of the winning player's strategy, or -1 if the game was stopped unfinished
+    int winner = -1;
+};
+
+// Each game in progress takes a snapshot of itself for the checkpoint every this many hands, so a game carried on from a checkpoint
+// plays at most this many hands again. Copying a snapshot (about 1 KB) under the lock this often costs too little to measure
+static const int GAME_SNAPSHOT_HANDS = 10;
+// The first bytes of every checkpoint file, and the version of the format written
+static const char CHECKPOINT_MAGIC[4] = {'T', 'H', 'C', 'K'};
+static const uint32_t CHECKPOINT_VERSION = 1;
+
+/* The start of a checkpoint file, giving the simulation it belongs to. After it come the strategy names (separated by commas),
+   a CheckpointGame for every game in order, and then each snapshot of a game in progress as the game's index (an int64_t)
+   followed by the GameSnapshot itself.
+*/
+struct CheckpointHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t seed;
+    int64_t numGames;
+    int32_t numPlayers;
+    int32_t maxRounds;
+    uint32_t strategiesBytes;
+    uint32_t numSnapshots;
+};
+
+// How a game ended, with rounds of -1 for a game not finished yet
+struct CheckpointGame {
+    int32_t rounds;
+    int32_t winner;
+};
+
+/* The progress of a simulation, kept for its checkpoint file: how every finished game ended, and the latest snapshot of every
+   game in progress. Games on every thread of the pool report to it, so everything it holds is guarded by its lock.
+*/
+class SimulationCheckpoint {
+    public:
+        SimulationCheckpoint(const SimulationOptions &options);
+        // Read the checkpoint file, returning false if there is none yet, and handing back the snapshots of the games in progress.
+        // Throws std::invalid_argument if the file is damaged or belongs to a different simulation
+        bool Load(std::unordered_map<long, GameSnapshot> &loadedSnapshots);
+        // Return true and fill in the record if the checkpoint has the game finished
+        bool GetFinishedGame(long gameIndex, GameRecord &record);
+        // Keep a game's latest snapshot, or note down how it ended, along with the hands it played since it last reported.
+        // The checkpoint file is written again once enough hands have been played since it was last written
+        void SaveSnapshot(long gameIndex, const GameSnapshot &snapshot, long newHands);
+        void FinishGame(long gameIndex, const GameRecord &record, long newHands);
+        // Write the checkpoint file, returning false if it could not be written
+        bool Write();
+
+    private:
+        bool WriteFile();
+
+        const SimulationOptions &options;
+        std::string strategies;
+        std::mutex lock;
+        std::vector<CheckpointGame> games;
+        std::map<long, GameSnapshot> snapshots;
+        long handsSinceWrite;
+};
+
+// Initialization of a checkpoint with no game finished or started
+SimulationCheckpoint::SimulationCheckpoint(const SimulationOptions &options) : options(options) {
+    for (size_t i = 0; i < options.strategies.size(); i++) {
+        strategies += (i > 0 ? "," : "") + options.strategies[i];
+    }
+
+    CheckpointGame notFinished;
+    notFinished.rounds = -1;
+    notFinished.winner = -1;
+    games.assign(options.numGames, notFinished);
+    handsSinceWrite = 0;
+}
+
+// Read the whole checkpoint file, checking it was written by a simulation with the same options
+bool SimulationCheckpoint::Load(std::unordered_map<long, GameSnapshot> &loadedSnapshots) {
+    std::ifstream file(options.checkpointFile, std::ios_base::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    CheckpointHeader header;
+    if (!file.read((char *) &header, sizeof(header)) || std::memcmp(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != CHECKPOINT_VERSION) {
+        throw std::invalid_argument("RunSimulation: '" + options.checkpointFile + "' is not a checkpoint file this program can read");
+    }
+
+    std::string savedStrategies(header.strategiesBytes, ' ');
+    file.read(&savedStrategies[0], savedStrategies.size());
+    if (header.seed != options.seed || header.numGames != options.numGames || header.numPlayers != options.numPlayers ||
+        header.maxRounds != options.maxRounds || savedStrategies != strategies) {
+        throw std::invalid_argument("RunSimulation: the checkpoint file '" + options.checkpointFile + "' was written by a different simulation");
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    file.read((char *) games.data(), games.size() * sizeof(CheckpointGame));
+    for (uint32_t i = 0; i < header.numSnapshots && file; i++) {
+        int64_t gameIndex;
+        GameSnapshot snapshot;
+        file.read((char *) &gameIndex, sizeof(gameIndex));
+        file.read((char *) &snapshot, sizeof(snapshot));
+        if (file && (gameIndex < 0 || gameIndex >= options.numGames || snapshot.numProviders != options.numPlayers)) {
+            throw std::invalid_argument("RunSimulation: the checkpoint file '" + options.checkpointFile + "' is damaged");
+        }
+        // Every snapshot is checked now, since restoring one happens on the pool, where nothing may throw
+        if (file) {
+            try {
+                CheckSnapshot(snapshot);
+            }
+            catch (const std::invalid_argument &) {
+                throw std::invalid_argument("RunSimulation: the checkpoint file '" + options.checkpointFile + "' is damaged");
+            }
+        }
+        snapshots[gameIndex] = snapshot;
+        loadedSnapshots[gameIndex] = snapshot;
+    }
+    if (!file) {
+        throw std::invalid_argument("RunSimulation: the checkpoint file '" + options.checkpointFile + "' is damaged");
+    }
+
+    return true;
+}
+
+// Look a game up among the finished ones
+bool SimulationCheckpoint::GetFinishedGame(long gameIndex, GameRecord &record) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (games[gameIndex].rounds < 0) {
+        return false;
+    }
+
+    record.rounds = games[gameIndex].rounds;
+    record.winner = games[gameIndex].winner;
+    return true;
+}
+
+// Replace the game's snapshot with a newer one
+void SimulationCheckpoint::SaveSnapshot(long gameIndex, const GameSnapshot &snapshot, long newHands) {
+    std::lock_guard<std::mutex> guard(lock);
+    snapshots[gameIndex] = snapshot;
+    handsSinceWrite += newHands;
+    if (handsSinceWrite >= options.checkpointHands) {
+        WriteFile();
+    }
+}
+
+// Note down how the game ended, dropping its snapshot as it will not be needed again
+void SimulationCheckpoint::FinishGame(long gameIndex, const GameRecord &record, long newHands) {
+    std::lock_guard<std::mutex> guard(lock);
+    games[gameIndex].rounds = record.rounds;
+    games[gameIndex].winner = record.winner;
+    snapshots.erase(gameIndex);
+    handsSinceWrite += newHands;
+    if (handsSinceWrite >= options.checkpointHands) {
+        WriteFile();
+    }
+}
+
+// Write the checkpoint file as things stand
+bool SimulationCheckpoint::Write() {
+    std::lock_guard<std::mutex> guard(lock);
+    return WriteFile();
+}
+
+// Write everything to a temporary file, then rename it over the checkpoint file so the checkpoint file is always a whole one.
+// Called with the lock held
+bool SimulationCheckpoint::WriteFile() {
+    std::string temporaryFile = options.checkpointFile + ".tmp";
+    std::ofstream file(temporaryFile, std::ios_base::binary | std::ios_base::trunc);
+
+    CheckpointHeader header;
+    std::memcpy(header.magic, CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_VERSION;
+    header.seed = options.seed;
+    header.numGames = options.numGames;
+    header.numPlayers = options.numPlayers;
+    header.maxRounds = options.maxRounds;
+    header.strategiesBytes = strategies.size();
+    header.numSnapshots = snapshots.size();
+
+    file.write((const char *) &header, sizeof(header));
+    file.write(strategies.data(), strategies.size());
+    file.write((const char *) games.data(), games.size() * sizeof(CheckpointGame));
+    for (const std::pair<const long, GameSnapshot> &snapshot : snapshots) {
+        int64_t gameIndex = snapshot.first;
+        file.write((const char *) &gameIndex, sizeof(gameIndex));
+        file.write((const char *) &snapshot.second, sizeof(snapshot.second));
+    }
+    file.close();
+
+    if (!file || std::rename(temporaryFile.c_str(), options.checkpointFile.c_str()) != 0) {
+        return false;
+    }
+    handsSinceWrite = 0;
+    return true;
+}
+
+// Return the index of the strategy playing in "seat" during game "gameIndex", moving every strategy one seat along each game
+static int SeatStrategy(const SimulationOptions &options, long gameIndex, int seat) {
+    return (seat + gameIndex) % options.strategies.size();
+}
+
+// Play one complete game with its own players, deck and strategies, all seeded from the game's own seed
+// Every hand is written to the hand history if there is one. With a checkpoint, the game carries on from its snapshot
+// if it has one, and reports its progress to the checkpoint as it goes
+static GameRecord PlaySimulatedGame(const SimulationOptions &options, long gameIndex, uint64_t gameSeed, HandHistoryWriter *history,
+                                    const GameSnapshot *resumeFrom, SimulationCheckpoint *checkpoint) {
+    Xoshiro256 gameGenerator(gameSeed);
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<ActionProvider>> strategies;
+    std::vector<ActionProvider *> providers;
+    TableActionProvider table;
+
+    // Name each player after their strategy and seat, such as "tight-3", and give them their strategy
+    for (int seat = 0; seat < options.numPlayers; seat++) {
+        const std::string &strategyName = options.strategies.at(SeatStrategy(options, gameIndex, seat));
+        names.push_back(strategyName + "-" + std::to_string(seat + 1));
+        strategies.push_back(MakeStrategy(strategyName, gameGenerator()));
+        table.AddPlayer(names.back(), *strategies.back());
+        providers.push_back(strategies.back().get());
+    }
+
+    std::vector<Player> players;
+    SeatPlayers(players, names);
+    Deck tableDeck;
+    tableDeck.SeedDeck(gameGenerator());
+
+    // Everything is set up just as for a new game first, so a game carried on from a snapshot picks up exactly where it was
+    int roundsPlayed = 0;
+    if (resumeFrom) {
+        roundsPlayed = RestoreSnapshot(*resumeFrom, players, tableDeck, providers);
+    }
+
+    // Every GAME_SNAPSHOT_HANDS rounds, hand the checkpoint a snapshot along with the number of hands played since the last one
+    int reportedRounds = roundsPlayed;
+    GameSnapshot snapshot;
+    std::function<void(int)> afterRound;
+    if (checkpoint) {
+        afterRound = [&](int roundNumber) {
+            if (roundNumber % GAME_SNAPSHOT_HANDS == 0) {
+                TakeSnapshot(snapshot, players, roundNumber, tableDeck, providers);
+                checkpoint->SaveSnapshot(gameIndex, snapshot, roundNumber - reportedRounds);
+                reportedRounds = roundNumber;
+            }
+        };
+    }
+
+    GameRecord record;
+    record.rounds = PlayGame(players, tableDeck, table, options.maxRounds, false, Blinds(), history, roundsPlayed, afterRound);
+
+    // If the game finished, find the winner's seat from their name
+    if (players.size() == 1) {
+        for (int seat = 0; seat < options.numPlayers; seat++) {
+            if (names.at(seat) == players.at(0).GetName()) {
+                record.winner = SeatStrategy(options, gameIndex, seat);
+            }
+        }
+    }
+
+    if (checkpoint) {
+        checkpoint->FinishGame(gameIndex, record, record.rounds - reportedRounds);
+    }
+    return record;
+}
+
+// Play every game on a thread pool and gather up the results
+SimulationResult RunSimulation(const SimulationOptions &options) {
+    if (options.numGames < 1) {
+        throw std::invalid_argument("RunSimulation: at least 1 game is needed");
+    }
+    if (options.numPlayers < 2 || options.numPlayers > 10) {
+        throw std::invalid_argument("RunSimulation: between 2 and 10 players are needed");
+    }
+    if (options.strategies.empty()) {
+        throw std::invalid_argument("RunSimulation: at least 1 strategy is needed");
+    }
+    // Check every strategy name before any game starts, since tasks on the pool must not throw
+    for (const std::string &name : options.strategies) {
+        MakeStrategy(name);
+    }
+    if (!options.checkpointFile.empty() && !options.historyFile.empty()) {
+        throw std::invalid_argument("RunSimulation: a simulation cannot keep both a checkpoint and a hand history");
+    }
+    if (options.checkpointHands < 1) {
+        throw std::invalid_argument("RunSimulation: the checkpoint needs to be written at least every 1 hand");
+    }
+
+    // Take each game's seed from the simulation's seed in order, so game g always gets the same seed
+    Xoshiro256 seedGenerator(options.seed);
+    std::vector<uint64_t> gameSeeds(options.numGames);
+    for (long i = 0; i < options.numGames; i++) {
+        gameSeeds[i] = seedGenerator();
+    }
+
+    // One hand history file shared by every game, if the hands are being recorded
+    std::unique_ptr<HandHistoryWriter> history;
+    if (!options.historyFile.empty()) {
+        history.reset(new HandHistoryWriter(options.historyFile));
+        if (!history->IsOpen()) {
+            throw std::invalid_argument("RunSimulation: could not open the hand history file '" + options.historyFile + "'");
+        }
+    }
+
+    // Carry on from the checkpoint file if there is one, then write it straight away so a file that cannot be written is found
+    // before any game is played
+    std::unique_ptr<SimulationCheckpoint> checkpoint;
+    std::unordered_map<long, GameSnapshot> resumeSnapshots;
+    if (!options.checkpointFile.empty()) {
+        checkpoint.reset(new SimulationCheckpoint(options));
+        checkpoint->Load(resumeSnapshots);
+        if (!checkpoint->Write()) {
+            throw std::invalid_argument("RunSimulation: could not write the checkpoint file '" + options.checkpointFile + "'");
+        }
+    }
+
+    SimulationResult result;
+    std::vector<GameRecord> records(options.numGames);
+    ThreadPool pool(options.numThreads);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < options.numGames; i++) {
+        // Games the checkpoint has finished are not played again, and games it has a snapshot of carry on from it
+        if (checkpoint && checkpoint->GetFinishedGame(i, records[i])) {
+            result.resumedGames++;
+            result.resumedHands += records[i].rounds;
+            continue;
+        }
+        const GameSnapshot *resumeFrom = nullptr;
+        auto found = resumeSnapshots.find(i);
+        if (found != resumeSnapshots.end()) {
+            resumeFrom = &found->second;
+            result.resumedHands += resumeFrom->roundNumber;
+        }
+
+        pool.Submit([&options, &gameSeeds, &records, &history, &checkpoint, resumeFrom, i] {
+            records[i] = PlaySimulatedGame(options, i, gameSeeds[i], history.get(), resumeFrom, checkpoint.get());
+        });
+    }
+    pool.Wait();
+    if (history) {
+        history->Flush();
+    }
+    if (checkpoint) {
+        checkpoint->Write();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    result.games = options.numGames;
+    result.seconds = elapsed.count();
+    result.seed = options.seed;
+    for (const std::string &name : options.strategies) {
+        StrategyResult strategy;
+        strategy.name = name;
+        result.strategies.push_back(strategy);
+    }
+
+    for (long i = 0; i < options.numGames; i++) {
+        result.hands += records[i].rounds;
+
+        for (int seat = 0; seat < options.numPlayers; seat++) {
+            result.strategies.at(SeatStrategy(options, i, seat)).seats++;
+        }
+
+        if (records[i].winner >= 0) {
+            result.strategies.at(records[i].winner).wins++;
+            result.gameLengths.push_back(records[i].rounds);
+        }
+        else {
+            result.unfinishedGames++;
+        }
+    }
+
+    std::sort(result.gameLengths.begin(), result.gameLengths.end());
+    result.handsPerSecond = result.seconds > 0 ? (result.hands - result.resumedHands) / result.seconds : 0;
+
+    return result;
+}
+
+// Return the game length that "fraction" of the finished games are no longer than
+static int GameLengthPercentile(const std::vector<int> &gameLengths, double fraction) {
+    size_t index = std::min(gameLengths.size() - 1, (size_t) (fraction * gameLengths.size()));
+    return gameLengths.at(index);
+}
+
+// Print the speed of a simulation, the distribution of game lengths and the win rate of each strategy
+void PrintSimulationResult(const SimulationResult &result, int numPlayers) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Played " << result.games << " games of " << numPlayers << " players in " << result.seconds << " seconds";
+    if (result.unfinishedGames > 0) {
+        std::cout << " (" << result.unfinishedGames << " stopped before finishing)";
+    }
+    std::cout << "\n" << result.hands << " hands, " << std::setprecision(0) << result.handsPerSecond << " hands per second\n";
+    if (result.resumedGames > 0 || result.resumedHands > 0) {
+        std::cout << "Carried on from a checkpoint, with " << result.resumedGames << " games finished and " << result.resumedHands
+                  << " hands played before this run\n";
+    }
+
+    if (!result.gameLengths.empty()) {
+        const std::vector<int> &lengths = result.gameLengths;
+        double mean = 0;
+        for (int length : lengths) {
+            mean += length;
+        }
+        mean /= lengths.size();
+
+        std::cout << "Game length in hands: shortest " << lengths.front() << ", 10% " << GameLengthPercentile(lengths, 0.1)
+                  << ", median " << GameLengthPercentile(lengths, 0.5) << ", mean " << std::setprecision(1) << mean
+                  << ", 90% " << GameLengthPercentile(lengths, 0.9) << ", longest " << lengths.back() << "\n";
+
+        // Count the games in ranges that double in size (1, 2-3, 4-7, 8-15 ...) and draw a bar for each range
+        size_t counted = 0;
+        for (int low = 1; counted < lengths.size(); low *= 2) {
+            int high = low * 2 - 1;
+            size_t inRange = 0;
+            while (counted < lengths.size() && lengths.at(counted) <= high) {
+                inRange++;
+                counted++;
+            }
+
+            if (inRange > 0) {
+                double share = (double) inRange / lengths.size();
+                std::cout << "  " << std::setw(6) << low << " - " << std::setw(6) << high << " hands: " << std::setw(6) << std::setprecision(1)
+                          << share * 100 << "% " << std::string((int) (share * 50 + 0.5), '#') << "\n";
+            }
+        }
+    }
+
+    std::cout << "Win rate per seat (an even share would be " << std::setprecision(1) << 100.0 / numPlayers << "%):\n";
+    for (const StrategyResult &strategy : result.strategies) {
+        double winRate = strategy.seats > 0 ? (double) strategy.wins / strategy.seats : 0;
+        std::cout << "  " << std::left << std::setw(8) << strategy.name << std::right << std::setw(8) << strategy.wins
+                  << " wins from " << std::setw(8) << strategy.seats << " seats: " << std::setw(5) << winRate * 100 << "%\n";
+    }
+
+    // Passing this seed back with --seed plays exactly the same games again
+    std::cout << "Seed " << result.seed << "\n";
+}
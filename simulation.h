@@ -0,0 +1,74 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "random_generator.h"
+
+// What to simulate: how many games, how many players sit at each table, and which built-in strategies they play
+struct SimulationOptions {
+    long numGames = 1000;
+    int numPlayers = 6;
+    // Seats are given these strategies in turn, moving every strategy one seat along for each new game
+    // so no strategy always sits in the same place relative to the first dealer
+    std::vector<std::string> strategies = {"tight", "call", "raise", "random"};
+    // 0 uses one thread per core
+    int numThreads = 0;
+    // Games still going after this many rounds are stopped and counted as unfinished (0 for no limit)
+    int maxRounds = 10000;
+    // The same seed deals the same cards and makes the same random decisions, with any number of threads
+    uint64_t seed = RandomSeed();
+    // Every hand played is recorded in this hand history file (see hand_history.h), or none if it is empty
+    std::string historyFile;
+    // Progress is saved in this checkpoint file as the simulation runs (or nowhere if it is empty), and is rewritten each time
+    // another checkpointHands hands have been played. The same simulation run again with the same checkpoint file carries on from it
+    std::string checkpointFile;
+    long checkpointHands = 1000000;
+};
+
+// How one strategy did over every game played
+struct StrategyResult {
+    std::string name;
+    // The number of seats the strategy had over all the games, and how many games it won
+    long seats = 0;
+    long wins = 0;
+};
+
+// The results of a simulation, along with how quickly it ran
+struct SimulationResult {
+    long games = 0;
+    long unfinishedGames = 0;
+    long hands = 0;
+    double seconds = 0;
+    double handsPerSecond = 0;
+    // The number of rounds each finished game lasted, from shortest to longest
+    std::vector<int> gameLengths;
+    std::vector<StrategyResult> strategies;
+    uint64_t seed = 0;
+    // When carrying on from a checkpoint: the games it had finished, and the hands it had played (which are not counted in handsPerSecond)
+    long resumedGames = 0;
+    long resumedHands = 0;
+};
+
+/* Play options.numGames complete games between the built-in strategies, spread over a thread pool with one game per task.
+   Every game gets its own players, deck and strategies, all seeded from its own seed taken from options.seed,
+   so games share nothing and the results are the same with any number of threads. Nothing is printed
+   and no results are written to the txt file, but every hand is recorded if options.historyFile is set
+   (the games are in the order they started, which depends on the threads).
+   With options.checkpointFile set, each game in progress takes a snapshot of itself (see snapshot.h) every 10 hands,
+   and the checkpoint file keeps how every finished game ended along with the latest snapshot of every game in progress.
+   It is written to a temporary file first and then renamed over the old one, so a simulation killed at any point leaves
+   a whole checkpoint behind. Running the simulation again carries on from it, skipping the finished games and playing on from
+   each snapshot, and gives exactly the results the simulation would have given had it never stopped. A checkpoint that
+   cannot be written while the games are being played is skipped, and tried again later.
+   Throws std::invalid_argument for options that cannot be simulated, such as a checkpoint file written by a different simulation
+   (one with a different seed, number of games or players, strategies or maximum number of rounds), or one along with a hand history
+   file (as a game carried on from a snapshot cannot be replayed from its seed).
+*/
+SimulationResult RunSimulation(const SimulationOptions &options);
+// Print the speed of a simulation, the distribution of game lengths and the win rate of each strategy
+void PrintSimulationResult(const SimulationResult &result, int numPlayers);
+
+#endif
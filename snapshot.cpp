@@ -0,0 +1,88 @@
+#include <string>
+#include <vector>
+#include <cstring>
+#include <stdexcept>
+
+#include "snapshot.h"
+
+// Copy the players, the round number, the deck and the providers' generators into fixed-size fields
+void TakeSnapshot(GameSnapshot &snapshot, const std::vector<Player> &players, int roundNumber, const Deck &tableDeck,
+                  const std::vector<ActionProvider *> &providers) {
+    if (players.size() > MAX_SNAPSHOT_PLAYERS || providers.size() > MAX_SNAPSHOT_PLAYERS) {
+        throw std::invalid_argument("TakeSnapshot: a snapshot holds at most " + std::to_string(MAX_SNAPSHOT_PLAYERS) + " players and providers");
+    }
+
+    snapshot.roundNumber = roundNumber;
+    snapshot.numPlayers = players.size();
+    for (size_t i = 0; i < players.size(); i++) {
+        const std::string &name = players[i].GetName();
+        if (name.size() > MAX_SNAPSHOT_NAME_LENGTH) {
+            throw std::invalid_argument("TakeSnapshot: the name '" + name + "' is too long for a snapshot");
+        }
+
+        PlayerSnapshot &player = snapshot.players[i];
+        std::memset(player.name, 0, sizeof(player.name));
+        std::memcpy(player.name, name.data(), name.size());
+        player.chips = players[i].GetChips();
+        player.dealer = players[i].isDealer();
+    }
+
+    tableDeck.SaveSnapshot(snapshot.deck);
+
+    snapshot.numProviders = providers.size();
+    for (size_t i = 0; i < providers.size(); i++) {
+        snapshot.hasRandomState[i] = providers[i]->SaveRandomState(snapshot.randomStates[i]);
+    }
+}
+
+// Check every count, chip total, dealer marker and card in the snapshot, without changing any game
+void CheckSnapshot(const GameSnapshot &snapshot) {
+    if (snapshot.numPlayers < 1 || snapshot.numPlayers > MAX_SNAPSHOT_PLAYERS || snapshot.roundNumber < 0 ||
+        snapshot.numProviders < 0 || snapshot.numProviders > MAX_SNAPSHOT_PLAYERS) {
+        throw std::invalid_argument("CheckSnapshot: the snapshot is damaged");
+    }
+    // Exactly one player holds the dealer marker, or AssignDealer would have nobody to move it on from
+    int numDealers = 0;
+    for (int i = 0; i < snapshot.numPlayers; i++) {
+        if (snapshot.players[i].chips < 0) {
+            throw std::invalid_argument("CheckSnapshot: the snapshot is damaged");
+        }
+        if (snapshot.players[i].dealer) {
+            numDealers++;
+        }
+    }
+    if (numDealers != 1) {
+        throw std::invalid_argument("CheckSnapshot: the snapshot has " + std::to_string(numDealers) + " dealers instead of 1");
+    }
+
+    Deck::CheckSnapshot(snapshot.deck);
+}
+
+// Seat a new player for each one in the snapshot, then put the deck and the providers' generators back
+int RestoreSnapshot(const GameSnapshot &snapshot, std::vector<Player> &players, Deck &tableDeck, const std::vector<ActionProvider *> &providers) {
+    CheckSnapshot(snapshot);
+    if (snapshot.numProviders != (int) providers.size()) {
+        throw std::invalid_argument("RestoreSnapshot: the snapshot was taken with " + std::to_string(snapshot.numProviders) +
+                                    " providers, not " + std::to_string(providers.size()));
+    }
+
+    tableDeck.RestoreSnapshot(snapshot.deck);
+
+    players.clear();
+    for (int i = 0; i < snapshot.numPlayers; i++) {
+        const PlayerSnapshot &player = snapshot.players[i];
+        // Read the name up to its ending 0 byte, without ever reading past the field in a damaged snapshot
+        players.push_back(Player(std::string(player.name, strnlen(player.name, sizeof(player.name))), player.chips));
+        if (player.dealer) {
+            players.back().FlipDealerStat();
+        }
+    }
+
+    for (size_t i = 0; i < providers.size(); i++) {
+        if (snapshot.hasRandomState[i]) {
+            providers[i]->RestoreRandomState(snapshot.randomStates[i]);
+        }
+    }
+
+    return snapshot.roundNumber;
+}
@@ -0,0 +1,58 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "player.h"
+#include "deck.h"
+#include "action.h"
+
+/* A snapshot of a game between two hands: every player still at the table with their chips and whether they hold the dealer
+   marker (so AssignDealer moves the dealer on from the same seat), the number of rounds played so far, the whole deck
+   including its generator, and the generators of the ActionProviders making the players' decisions.
+   Playing on from a restored snapshot gives exactly the hands the game would have played had it never stopped.
+
+   A GameSnapshot has a fixed size and holds no pointers, so taking one is a matter of copying a couple of kilobytes
+   without allocating any memory, and it can be written to a file and read back as it is (by the same build of the program).
+*/
+
+// The most players and providers a snapshot holds, and the longest name it holds for each player
+const int MAX_SNAPSHOT_PLAYERS = 10;
+const int MAX_SNAPSHOT_NAME_LENGTH = 31;
+
+struct PlayerSnapshot {
+    char name[MAX_SNAPSHOT_NAME_LENGTH + 1];
+    int32_t chips;
+    int32_t dealer;
+};
+
+struct GameSnapshot {
+    int32_t roundNumber;
+    int32_t numPlayers;
+    PlayerSnapshot players[MAX_SNAPSHOT_PLAYERS];
+    DeckSnapshot deck;
+    // Each provider's generator state, in the order the providers were given (hasRandomState is 0 for a provider with none)
+    int32_t numProviders;
+    int32_t hasRandomState[MAX_SNAPSHOT_PLAYERS];
+    uint64_t randomStates[MAX_SNAPSHOT_PLAYERS][4];
+};
+
+/* Copy a game into a snapshot after roundNumber rounds have been played, along with the generators of "providers".
+   Must be called between hands, when no player has any cards or chips bet.
+   Throws std::invalid_argument if there are too many players or providers, or a name is too long, to fit in a snapshot
+*/
+void TakeSnapshot(GameSnapshot &snapshot, const std::vector<Player> &players, int roundNumber, const Deck &tableDeck,
+                  const std::vector<ActionProvider *> &providers);
+/* Check that a snapshot makes sense before using it: its counts, chips and card codes, and that exactly one player holds
+   the dealer marker. Throws std::invalid_argument if it does not
+*/
+void CheckSnapshot(const GameSnapshot &snapshot);
+/* Put a game back as a snapshot has it, replacing the players, and return the number of rounds it had played.
+   The providers must be the same ones (of the same kinds, in the same order) that the snapshot was taken with.
+   Throws std::invalid_argument if the snapshot does not make sense (see CheckSnapshot), or was taken with a different number of providers
+*/
+int RestoreSnapshot(const GameSnapshot &snapshot, std::vector<Player> &players, Deck &tableDeck, const std::vector<ActionProvider *> &providers);
+
+#endif
@@ -0,0 +1,117 @@
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+
+#include "strategy.h"
+#include "hand_evaluator.h"
+
+// The hand key categories the strategies look for
+static const int PAIR_CATEGORY = 2;
+static const int TWO_PAIR_CATEGORY = 3;
+
+// Return an action of the given type, with the raise amount for raises
+static PlayerAction MakeAction(ActionType type, int amount = 0) {
+    PlayerAction action;
+    action.type = type;
+    action.amount = amount;
+    return action;
+}
+
+// Check when it is free, and fold otherwise
+static PlayerAction CheckOrFold(const TurnState &turn) {
+    return MakeAction(turn.callingCost == 0 ? CHECK : FOLD);
+}
+
+// Always match the highest bet
+PlayerAction CallingStationStrategy::ChooseAction(const TurnState &) {
+    return MakeAction(CALL);
+}
+
+// Always raise by the size of the pot (at least 2 chips)
+PlayerAction AggressiveStrategy::ChooseAction(const TurnState &turn) {
+    return MakeAction(RAISE, std::max(turn.pot, 2));
+}
+
+// Play only good starting hands, and bet them by how strong the hand is after the flop
+PlayerAction TightStrategy::ChooseAction(const TurnState &turn) {
+    // Before the flop, judge the two hole cards on their own
+    if (!turn.communityHand) {
+        Card holeCards[2];
+        MaskToCards(turn.hand, holeCards);
+        int low = std::min(holeCards[0].GetHighCardNumber(), holeCards[1].GetHighCardNumber());
+        int high = std::max(holeCards[0].GetHighCardNumber(), holeCards[1].GetHighCardNumber());
+
+        bool pair = low == high;
+        if ((pair && low >= 10) || (low == 13 && high == 14)) {
+            return MakeAction(RAISE, std::max(turn.pot, 2));
+        }
+        if (pair || low >= 10) {
+            return MakeAction(CALL);
+        }
+        return CheckOrFold(turn);
+    }
+
+    // After the flop, use the best hand made with the community cards
+    int category = HandKeyCategory(turn.handKey);
+    if (category >= TWO_PAIR_CATEGORY) {
+        return MakeAction(RAISE, std::max(turn.pot / 2, 2));
+    }
+    if (category == PAIR_CATEGORY && turn.callingCost * 2 <= turn.pot) {
+        return MakeAction(CALL);
+    }
+    return CheckOrFold(turn);
+}
+
+// Initialization of the random strategy with its own seeded generator
+RandomStrategy::RandomStrategy(uint64_t seed) : generator(seed) {
+}
+
+// Fold 15% of the time (checking instead when it is free), call 55% of the time,
+// and otherwise raise by anything from 1 chip up to the size of the pot
+PlayerAction RandomStrategy::ChooseAction(const TurnState &turn) {
+    uint64_t roll = RandomBelow(generator, 100);
+
+    if (roll < 15) {
+        return CheckOrFold(turn);
+    }
+    if (roll < 70) {
+        return MakeAction(CALL);
+    }
+    return MakeAction(RAISE, 1 + RandomBelow(generator, std::max(turn.pot, 1)));
+}
+
+// Copy out the generator's state, as this strategy's decisions depend on it
+bool RandomStrategy::SaveRandomState(uint64_t state[4]) {
+    generator.GetState(state);
+    return true;
+}
+
+// Put back a state saved with SaveRandomState
+void RandomStrategy::RestoreRandomState(const uint64_t state[4]) {
+    generator.SetState(state);
+}
+
+// Return the names of the built-in strategies
+std::vector<std::string> StrategyNames() {
+    return {"call", "raise", "tight", "random"};
+}
+
+// Create the built-in strategy with the given name
+std::unique_ptr<ActionProvider> MakeStrategy(const std::string &name, uint64_t seed) {
+    if (name == "call") {
+        return std::make_unique<CallingStationStrategy>();
+    }
+    if (name == "raise") {
+        return std::make_unique<AggressiveStrategy>();
+    }
+    if (name == "tight") {
+        return std::make_unique<TightStrategy>();
+    }
+    if (name == "random") {
+        return std::make_unique<RandomStrategy>(seed);
+    }
+
+    throw std::invalid_argument("MakeStrategy: there is no strategy called \"" + name + "\"");
+}
@@ -0,0 +1,55 @@
+#ifndef STRATEGY_H
+#define STRATEGY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "action.h"
+#include "random_generator.h"
+
+/* Built-in computer players for simulations. Each one is an ActionProvider that decides from the TurnState alone,
+   so it never touches the console and can play thousands of games a second.
+*/
+
+// Always calls (or checks when there is nothing to call), whatever the cards
+class CallingStationStrategy : public ActionProvider {
+    public:
+        PlayerAction ChooseAction(const TurnState &turn);
+};
+
+// Always raises by the size of the pot, whatever the cards
+class AggressiveStrategy : public ActionProvider {
+    public:
+        PlayerAction ChooseAction(const TurnState &turn);
+};
+
+/* Only plays good starting hands (pairs, or two cards 10 or higher) and folds the rest unless checking is free.
+   Before the flop it raises with a pair of 10s or better and Ace-King. After the flop it raises with two pair or better,
+   calls with a pair as long as the call is no more than half the pot, and otherwise checks or folds
+*/
+class TightStrategy : public ActionProvider {
+    public:
+        PlayerAction ChooseAction(const TurnState &turn);
+};
+
+// Folds, calls or raises at random, with its own generator so a game can be repeated from its seed
+class RandomStrategy : public ActionProvider {
+    public:
+        RandomStrategy(uint64_t seed = 0);
+        PlayerAction ChooseAction(const TurnState &turn);
+        bool SaveRandomState(uint64_t state[4]);
+        void RestoreRandomState(const uint64_t state[4]);
+
+    private:
+        Xoshiro256 generator;
+};
+
+// Return the names of the built-in strategies: "call", "raise", "tight" and "random"
+std::vector<std::string> StrategyNames();
+// Create the built-in strategy with the given name, seeding it if it makes random decisions.
+// Throws std::invalid_argument if there is no strategy with that name
+std::unique_ptr<ActionProvider> MakeStrategy(const std::string &name, uint64_t seed = 0);
+
+#endif
@@ -0,0 +1,132 @@
+#include <algorithm>
+
+#include "thread_pool.h"
+
+// The pool the thread running this code works for (null on threads that are not pool workers) and its worker index there.
+// A task running on one pool can use another pool, so the index only means something to the pool it came from
+static thread_local const ThreadPool *currentPool = nullptr;
+static thread_local int currentWorker = -1;
+
+// Start the worker threads, one per core if no number is given
+ThreadPool::ThreadPool(int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    queuedTasks = 0;
+    unfinishedTasks = 0;
+    nextQueue = 0;
+    stopping = false;
+
+    for (int i = 0; i < numThreads; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 0; i < numThreads; i++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, i);
+    }
+}
+
+// Finish every task already submitted, then stop and join the worker threads
+ThreadPool::~ThreadPool() {
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+// Add a task to a queue: the submitting worker's own queue when called from inside a task,
+// or the next queue in turn when called from outside the pool
+void ThreadPool::Submit(std::function<void()> task) {
+    int workerIndex = CurrentWorker();
+    int queueIndex = workerIndex >= 0 ? workerIndex : nextQueue++ % queues.size();
+
+    unfinishedTasks++;
+    {
+        std::lock_guard<std::mutex> lock(queues.at(queueIndex)->lock);
+        queues.at(queueIndex)->tasks.push_back(std::move(task));
+    }
+    queuedTasks++;
+
+    // Taking the lock before notifying makes sure a worker that is just about to sleep still hears about the task
+    {
+        std::lock_guard<std::mutex> lock(sleepLock);
+    }
+    wakeUp.notify_one();
+}
+
+// Block until every submitted task (including tasks submitted by other tasks) has finished.
+// This covers every task pending in the pool, not just the caller's, so a pool shared by several callers waits for all of them
+void ThreadPool::Wait() {
+    std::unique_lock<std::mutex> lock(sleepLock);
+    allDone.wait(lock, [this] { return unfinishedTasks == 0; });
+}
+
+// Getter for the number of worker threads
+int ThreadPool::GetNumThreads() {
+    return workers.size();
+}
+
+// Return the index (0 up to GetNumThreads() - 1) of this pool's worker running the calling task, or -1 when called
+// from any other thread (including the workers of another pool). Tasks use this to add their results to a per-worker total without any locking
+int ThreadPool::CurrentWorker() const {
+    return currentPool == this ? currentWorker : -1;
+}
+
+// Take the newest task from this worker's own queue, or failing that steal the oldest task from another worker
+bool ThreadPool::TakeTask(int workerIndex, std::function<void()> &task) {
+    for (size_t i = 0; i < queues.size(); i++) {
+        WorkerQueue &queue = *queues.at((workerIndex + i) % queues.size());
+        std::lock_guard<std::mutex> lock(queue.lock);
+
+        if (queue.tasks.empty()) {
+            continue;
+        }
+
+        if (i == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        queuedTasks--;
+        return true;
+    }
+
+    return false;
+}
+
+// Run tasks until the pool is stopped, sleeping whenever every queue is empty
+void ThreadPool::WorkerLoop(int workerIndex) {
+    currentPool = this;
+    currentWorker = workerIndex;
+
+    while (true) {
+        std::function<void()> task;
+
+        if (TakeTask(workerIndex, task)) {
+            task();
+
+            // The last task to finish wakes up anyone waiting in Wait
+            if (--unfinishedTasks == 0) {
+                std::lock_guard<std::mutex> lock(sleepLock);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepLock);
+        wakeUp.wait(lock, [this] { return stopping || queuedTasks > 0; });
+        if (stopping && queuedTasks == 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/* Class created for running many small tasks over a fixed set of worker threads.
+   Each worker has its own queue of tasks: it takes its newest task first from the back of its own queue,
+   and once its queue is empty it "steals" the oldest task from the front of another worker's queue.
+   This keeps every core busy even when the tasks are of very different sizes, without every worker
+   fighting over one shared queue. Tasks submitted from inside a task go to the submitting worker's own queue,
+   so a task can split its work further and let idle workers steal the pieces.
+   Tasks must not throw, and Wait must not be called from inside a task. Wait waits for every task in the pool,
+   so when several callers share one pool, each of them also waits for the others' tasks.
+*/
+class ThreadPool {
+    public:
+        ThreadPool(int numThreads = 0);
+        ~ThreadPool();
+        void Submit(std::function<void()> task);
+        void Wait();
+        int GetNumThreads();
+        int CurrentWorker() const;
+
+    private:
+        // One worker's queue, with its own lock so workers only block each other when stealing
+        struct WorkerQueue {
+            std::mutex lock;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        void WorkerLoop(int workerIndex);
+        bool TakeTask(int workerIndex, std::function<void()> &task);
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> workers;
+        // Tasks sitting in a queue, and tasks submitted but not yet finished
+        std::atomic<long> queuedTasks;
+        std::atomic<long> unfinishedTasks;
+        std::atomic<unsigned int> nextQueue;
+        bool stopping;
+        // Idle workers sleep on wakeUp and Wait sleeps on allDone, both guarded by sleepLock
+        std::mutex sleepLock;
+        std::condition_variable wakeUp;
+        std::condition_variable allDone;
+};
+
+#endif
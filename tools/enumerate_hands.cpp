@@ -0,0 +1,261 @@
+// Enumerate all 133,784,560 seven-card hands, run every one through an evaluator, and check how many of each
+// type of hand were found against the known totals. Reports hands per second with one thread and with several,
+// giving one throughput number to track across evaluator changes.
+// Built from the repository root with:
+//   g++ -std=c++17 -O2 -pthread -o enumerate_hands tools/enumerate_hands.cpp player.cpp rank_table.cpp hand_evaluator.cpp hand_evaluator_simd.cpp card.cpp
+// Usage: enumerate_hands [tables|batch|ranktable|reference] [number of threads]
+//   tables     EvaluateHand, one hand at a time (the default)
+//   batch      EvaluateHandBatch with the fastest kernel this processor supports
+//   ranktable  the state machine in rank_table.bin, stepping through the states shared by neighbouring hands
+//   reference  Player::EvaluateCardsReference, the original hand checks (much slower)
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include "../player.h"
+#include "../rank_table.h"
+
+const int NUM_CARDS = 52;
+const int NUM_CATEGORIES = 11;
+const long TOTAL_HANDS = 133784560;
+const int BATCH_SIZE = 1024;
+
+// The number of 7-card hands of each type, indexed by the hand key category (1 for high card up to 10 for a Royal flush)
+const long EXPECTED_COUNTS[NUM_CATEGORIES] = {0, 23294460, 58627800, 31433400, 6461620, 6180020,
+                                              4047644, 3473184, 224848, 37260, 4324};
+const std::string CATEGORY_NAMES[NUM_CATEGORIES] = {"none", "High card", "Pair", "Two pair", "Three-of-a-kind", "Straight",
+                                                    "Flush", "Full house", "Four-of-a-kind", "Straight flush", "Royal flush"};
+
+// The ways the hands can be evaluated
+enum Evaluator {
+    TABLES_EVALUATOR,
+    BATCH_EVALUATOR,
+    RANK_TABLE_EVALUATOR,
+    REFERENCE_EVALUATOR
+};
+
+// The counts found by one thread
+struct CategoryCounts {
+    long counts[NUM_CATEGORIES] = {};
+};
+
+// Return the card code of each of the 52 cards, ordered suit by suit from the Deuce up
+unsigned char CardCode(int card) {
+    return ((card / 13) << CARD_SUIT_SHIFT) | (card % 13);
+}
+
+// Return the set holding only one of the 52 cards
+CardMask CardBit(int card) {
+    return (CardMask) 1 << CardCode(card);
+}
+
+// Pass every hand whose two lowest cards are first and second to "visit", one hand at a time
+template <typename VisitFunction>
+void VisitHandsFrom(int first, int second, VisitFunction visit) {
+    CardMask twoCards = CardBit(first) | CardBit(second);
+
+    for (int third = second + 1; third < NUM_CARDS; third++) {
+        CardMask threeCards = twoCards | CardBit(third);
+        for (int fourth = third + 1; fourth < NUM_CARDS; fourth++) {
+            CardMask fourCards = threeCards | CardBit(fourth);
+            for (int fifth = fourth + 1; fifth < NUM_CARDS; fifth++) {
+                CardMask fiveCards = fourCards | CardBit(fifth);
+                for (int sixth = fifth + 1; sixth < NUM_CARDS; sixth++) {
+                    CardMask sixCards = fiveCards | CardBit(sixth);
+                    for (int seventh = sixth + 1; seventh < NUM_CARDS; seventh++) {
+                        visit(sixCards | CardBit(seventh));
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Count every hand whose two lowest cards are first and second, collecting them into batches for EvaluateHandBatch
+void CountHandsFromBatched(int first, int second, CategoryCounts &counts) {
+    CardMask hands[BATCH_SIZE] = {};
+    unsigned int handKeys[BATCH_SIZE];
+    int numHands = 0;
+
+    VisitHandsFrom(first, second, [&](CardMask hand) {
+        hands[numHands++] = hand;
+        if (numHands == BATCH_SIZE) {
+            EvaluateHandBatch(hands, handKeys, numHands);
+            for (int i = 0; i < numHands; i++) {
+                counts.counts[HandKeyCategory(handKeys[i])]++;
+            }
+            numHands = 0;
+        }
+    });
+
+    EvaluateHandBatch(hands, handKeys, numHands);
+    for (int i = 0; i < numHands; i++) {
+        counts.counts[HandKeyCategory(handKeys[i])]++;
+    }
+}
+
+// Count every hand whose two lowest cards are first and second by stepping through the rank table.
+// Each state reached is reused by every hand that starts with the same cards, so only the last step differs per hand
+void CountHandsFromRankTable(int first, int second, CategoryCounts &counts, const uint32_t *entries) {
+    uint32_t twoCards = entries[entries[RankTableEntry(CardCode(first))] + RankTableEntry(CardCode(second))];
+
+    for (int third = second + 1; third < NUM_CARDS; third++) {
+        uint32_t threeCards = entries[twoCards + RankTableEntry(CardCode(third))];
+        for (int fourth = third + 1; fourth < NUM_CARDS; fourth++) {
+            uint32_t fourCards = entries[threeCards + RankTableEntry(CardCode(fourth))];
+            for (int fifth = fourth + 1; fifth < NUM_CARDS; fifth++) {
+                uint32_t fiveCards = entries[fourCards + RankTableEntry(CardCode(fifth))];
+                for (int sixth = fifth + 1; sixth < NUM_CARDS; sixth++) {
+                    uint32_t sixCards = entries[fiveCards + RankTableEntry(CardCode(sixth))];
+                    for (int seventh = sixth + 1; seventh < NUM_CARDS; seventh++) {
+                        counts.counts[HandKeyCategory(entries[sixCards + RankTableEntry(CardCode(seventh))])]++;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Count every hand whose two lowest cards are first and second with the original hand checks in player.cpp
+void CountHandsFromReference(int first, int second, CategoryCounts &counts) {
+    Player player;
+
+    VisitHandsFrom(first, second, [&](CardMask hand) {
+        Card cards[7];
+        MaskToCards(hand, cards);
+
+        player.EmptyHand();
+        player.EmptyHandStats();
+        for (int i = 0; i < 7; i++) {
+            player.TakeCard(cards[i]);
+        }
+        player.EvaluateCardsReference(0);
+
+        counts.counts[HandKeyCategory(player.GetHandKey())]++;
+    });
+}
+
+// Work through the pairs of lowest cards handed out by nextPair until there are none left.
+// Splitting the work by the two lowest cards gives 1,326 pieces of very different sizes,
+// so threads that finish early simply take the next piece
+void CountHandsWorker(Evaluator evaluator, std::atomic<int> &nextPair, CategoryCounts &counts) {
+    const uint32_t *entries = GetRankTableEntries();
+
+    for (int pair = nextPair++; pair < NUM_CARDS * NUM_CARDS; pair = nextPair++) {
+        int first = pair / NUM_CARDS;
+        int second = pair % NUM_CARDS;
+        if (second <= first) {
+            continue;
+        }
+
+        switch (evaluator) {
+            case TABLES_EVALUATOR:
+                VisitHandsFrom(first, second, [&](CardMask hand) { counts.counts[HandKeyCategory(EvaluateHand(hand))]++; });
+                break;
+            case BATCH_EVALUATOR:
+                CountHandsFromBatched(first, second, counts);
+                break;
+            case RANK_TABLE_EVALUATOR:
+                CountHandsFromRankTable(first, second, counts, entries);
+                break;
+            case REFERENCE_EVALUATOR:
+                CountHandsFromReference(first, second, counts);
+                break;
+        }
+    }
+}
+
+// Enumerate every hand with the given number of threads, print the speed and the counts,
+// and return whether every count matched the known totals
+bool RunEnumeration(Evaluator evaluator, int numThreads) {
+    std::vector<CategoryCounts> threadCounts(numThreads);
+    std::vector<std::thread> threads;
+    std::atomic<int> nextPair(0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back(CountHandsWorker, evaluator, std::ref(nextPair), std::ref(threadCounts.at(i)));
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    // Add up every thread's counts
+    CategoryCounts totals;
+    long totalHands = 0;
+    for (const CategoryCounts &counts : threadCounts) {
+        for (int category = 0; category < NUM_CATEGORIES; category++) {
+            totals.counts[category] += counts.counts[category];
+            totalHands += counts.counts[category];
+        }
+    }
+
+    std::cout << numThreads << (numThreads == 1 ? " thread: " : " threads: ") << totalHands << " hands in "
+              << elapsed.count() << " seconds, " << totalHands / elapsed.count() / 1e6 << " million hands per second\n";
+
+    bool allMatch = totalHands == TOTAL_HANDS;
+    for (int category = NUM_CATEGORIES - 1; category >= 0; category--) {
+        bool matches = totals.counts[category] == EXPECTED_COUNTS[category];
+        allMatch = allMatch && matches;
+        if (category == 0 && matches) {
+            continue;
+        }
+
+        std::cout << "  " << std::left << std::setw(16) << CATEGORY_NAMES[category] << std::right << std::setw(10)
+                  << totals.counts[category] << (matches ? "" : "  ERROR: expected " + std::to_string(EXPECTED_COUNTS[category])) << "\n";
+    }
+
+    return allMatch;
+}
+
+int main(int argc, char *argv[]) {
+    std::string evaluatorName = argc > 1 ? argv[1] : "tables";
+    int numThreads = argc > 2 ? std::stoi(argv[2]) : std::thread::hardware_concurrency();
+    Evaluator evaluator;
+
+    if (evaluatorName == "tables") {
+        evaluator = TABLES_EVALUATOR;
+    }
+    else if (evaluatorName == "batch") {
+        evaluator = BATCH_EVALUATOR;
+        evaluatorName += std::string(" (") + BatchKernelName(BestBatchKernel()) + ")";
+    }
+    else if (evaluatorName == "ranktable") {
+        evaluator = RANK_TABLE_EVALUATOR;
+        if (!LoadRankTable()) {
+            std::cout << "Could not load '" << DEFAULT_RANK_TABLE_FILE << "'; run generate_rank_table first\n";
+            return 1;
+        }
+    }
+    else if (evaluatorName == "reference") {
+        evaluator = REFERENCE_EVALUATOR;
+    }
+    else {
+        std::cout << "Unknown evaluator '" << evaluatorName << "'; use tables, batch, ranktable or reference\n";
+        return 1;
+    }
+
+    if (numThreads < 1) {
+        numThreads = 1;
+    }
+
+    std::cout << "Enumerating every 7-card hand with the " << evaluatorName << " evaluator\n";
+    bool allMatch = RunEnumeration(evaluator, 1);
+    if (numThreads > 1) {
+        allMatch = RunEnumeration(evaluator, numThreads) && allMatch;
+    }
+
+    if (!allMatch) {
+        std::cout << "ERROR: the hand counts did not match the known totals!\n";
+        return 1;
+    }
+
+    std::cout << "Every hand count matches the known totals\n";
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Work out each player's chance of winning a hand from their hole cards, by dealing out random boards,
+// or with --exact by dealing every possible board.
+// Built from the repository root with:
+//   g++ -std=c++17 -O2 -pthread -o equity_calculator tools/equity_calculator.cpp equity.cpp thread_pool.cpp random_generator.cpp deck.cpp hand_evaluator.cpp hand_evaluator_simd.cpp card.cpp
+// Usage: equity_calculator [--exact] [--board CARDS] [--dead CARDS] [--boards N] [--threads N] [--seed N] HAND HAND [HAND ...]
+// Cards are written as short names, for example: equity_calculator --board "Ts 9s 2d" AhAd KsQs
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "../equity.h"
+
+// Print each player's results as percentages, followed by how long the calculation took
+void PrintEquityResult(const std::vector<std::string> &handNames, const EquityResult &result) {
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (size_t i = 0; i < handNames.size(); i++) {
+        const PlayerEquity &player = result.players.at(i);
+        std::cout << "Player " << i + 1 << " (" << handNames.at(i) << "): equity " << player.equity * 100
+                  << "% +/- " << player.standardError * 100 << "%, win " << player.win * 100
+                  << "%, tie " << player.tie * 100 << "%\n";
+    }
+
+    std::cout << std::setprecision(2) << result.boards << " boards in " << result.seconds << " seconds, "
+              << result.handsPerSecond / 1e6 << " million hands per second\n";
+}
+
+int main(int argc, char *argv[]) {
+    EquitySpot spot;
+    std::vector<std::string> handNames;
+    long numBoards = 1000000;
+    int numThreads = 0;
+    bool exact = false;
+    uint64_t seed = RandomSeed();
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+
+            // --exact is a switch, every other option is followed by its value
+            if (argument == "--exact") {
+                exact = true;
+                continue;
+            }
+            if (argument.rfind("--", 0) == 0 && i + 1 >= argc) {
+                throw std::invalid_argument(argument + " needs a value");
+            }
+
+            if (argument == "--board") {
+                spot.board = ParseCards(argv[++i]);
+            }
+            else if (argument == "--dead") {
+                spot.deadCards = ParseCards(argv[++i]);
+            }
+            else if (argument == "--boards") {
+                numBoards = std::stol(argv[++i]);
+            }
+            else if (argument == "--threads") {
+                numThreads = std::stoi(argv[++i]);
+            }
+            else if (argument == "--seed") {
+                seed = std::stoull(argv[++i]);
+            }
+            else {
+                spot.holeCards.push_back(ParseCards(argument));
+                handNames.push_back(argument);
+            }
+        }
+
+        if (exact) {
+            PrintEquityResult(handNames, CalculateEquityExact(spot, numThreads));
+        }
+        else {
+            EquityResult result = CalculateEquityMonteCarlo(spot, numBoards, numThreads, seed);
+            PrintEquityResult(handNames, result);
+            // Passing this seed back with --seed deals exactly the same boards again
+            std::cout << "Seed " << result.seed << "\n";
+        }
+    }
+    catch (const std::exception &error) {
+        std::cout << "ERROR: " << error.what() << "\n";
+        std::cout << "Usage: equity_calculator [--exact] [--board CARDS] [--dead CARDS] [--boards N] [--threads N] [--seed N] HAND HAND [HAND ...]\n";
+        return 1;
+    }
+
+    return 0;
+}
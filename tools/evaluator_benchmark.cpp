@@ -0,0 +1,80 @@
+// Benchmark comparing the one-hand-at-a-time evaluator with each batch evaluation kernel.
+// Built from the repository root with:
+//   g++ -std=c++17 -O2 -o evaluator_benchmark tools/evaluator_benchmark.cpp hand_evaluator.cpp hand_evaluator_simd.cpp card.cpp
+// Usage: evaluator_benchmark [number of hands] [number of passes]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+
+#include "../hand_evaluator.h"
+
+// Fill the hands vector with random sets of 7 different cards
+void DealRandomHands(std::vector<CardMask> &hands, unsigned int seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<int> cardDistribution(0, 51);
+
+    for (size_t i = 0; i < hands.size(); i++) {
+        CardMask hand = 0;
+        // Keep drawing cards until 7 different ones have been found
+        while (CountCards(hand) < 7) {
+            int card = cardDistribution(generator);
+            hand |= Card(card % 13 + 1, card / 13 + 1).GetCardMask();
+        }
+        hands.at(i) = hand;
+    }
+}
+
+// Print how fast a pass over every hand ran, in millions of hands per second
+void PrintThroughput(std::string name, size_t numHands, int passes, double seconds) {
+    std::cout << name << ": " << (numHands * passes) / seconds / 1e6 << " million hands per second\n";
+}
+
+int main(int argc, char *argv[]) {
+    size_t numHands = argc > 1 ? std::stoul(argv[1]) : 1 << 20;
+    int passes = argc > 2 ? std::stoi(argv[2]) : 10;
+    std::vector<CardMask> hands(numHands);
+    std::vector<unsigned int> scalarKeys(numHands);
+    std::vector<unsigned int> batchKeys(numHands);
+
+    DealRandomHands(hands, 2024);
+
+    // Read the lookup tables once so they are paged in before any timing starts
+    EvaluateHand(hands.at(0));
+
+    // Time the ordinary single-hand evaluator as the baseline
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; pass++) {
+        for (size_t i = 0; i < numHands; i++) {
+            scalarKeys.at(i) = EvaluateHand(hands.at(i));
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    PrintThroughput("EvaluateHand, one hand per call", numHands, passes, elapsed.count());
+
+    // Then time every batch kernel this processor supports, checking its keys against the baseline
+    BatchKernel kernels[] = {SCALAR_KERNEL, SSE4_KERNEL, AVX2_KERNEL};
+    int failures = 0;
+    for (BatchKernel kernel : kernels) {
+        if (kernel > BestBatchKernel()) {
+            std::cout << "EvaluateHandBatch, " << BatchKernelName(kernel) << " kernel: not supported on this processor\n";
+            continue;
+        }
+
+        start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; pass++) {
+            EvaluateHandBatch(hands.data(), batchKeys.data(), numHands, kernel);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        PrintThroughput(std::string("EvaluateHandBatch, ") + BatchKernelName(kernel) + " kernel", numHands, passes, elapsed.count());
+
+        if (batchKeys != scalarKeys) {
+            std::cout << "ERROR: the " << BatchKernelName(kernel) << " kernel did not match EvaluateHand!\n";
+            failures++;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,247 @@
+// Generate the rank table file that LoadRankTable maps into memory (see rank_table.h), then check it
+// against EvaluateHand on random hands and time both.
+// Built from the repository root with:
+//   g++ -std=c++17 -O2 -o generate_rank_table tools/generate_rank_table.cpp rank_table.cpp hand_evaluator.cpp hand_evaluator_simd.cpp card.cpp
+// Usage: generate_rank_table [output file] [number of hands to check]
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+#include <cstring>
+
+#include "../rank_table.h"
+#include "../hand_evaluator.h"
+
+// Every state is a set of cards, kept as the count of each card number (3 bits per card number, with the
+// number of cards in the top byte) and the card numbers held in each suit that could still make a flush
+struct RankTableState {
+    uint64_t rankCounts;
+    CardMask suitRanks;
+
+    bool operator==(const RankTableState &other) const {
+        return rankCounts == other.rankCounts && suitRanks == other.suitRanks;
+    }
+};
+
+// Hash function so states can be kept in an unordered_map
+struct RankTableStateHash {
+    size_t operator()(const RankTableState &state) const {
+        return std::hash<uint64_t>()(state.rankCounts * 0x9E3779B97F4A7C15ull ^ state.suitRanks);
+    }
+};
+
+const int NUM_CARD_COUNT_SHIFT = 56;
+
+// Return the number of cards in a state
+int StateCards(const RankTableState &state) {
+    return state.rankCounts >> NUM_CARD_COUNT_SHIFT;
+}
+
+// Forget the cards of any suit that cannot reach 5 cards with the cards still to come,
+// since from then on only their card numbers can matter
+void ForgetDeadSuits(RankTableState &state) {
+    int cardsToCome = 7 - StateCards(state);
+
+    for (int suit = 0; suit < 4; suit++) {
+        if (CountCards(SuitRanks(state.suitRanks, suit)) + cardsToCome < 5) {
+            state.suitRanks &= ~((CardMask) MASK_LANE_RANKS << (suit * MASK_LANE_BITS));
+        }
+    }
+}
+
+// Add a card to a state, returning false if the card cannot be added (it is already held,
+// or its card number is already held 4 times)
+bool AddCardToState(const RankTableState &state, unsigned char cardCode, RankTableState &next) {
+    int rank = cardCode & 0xF;
+    int suit = cardCode >> CARD_SUIT_SHIFT;
+    int rankCount = (state.rankCounts >> (3 * rank)) & 7;
+    int cardsToCome = 7 - StateCards(state);
+    CardMask card = (CardMask) 1 << cardCode;
+
+    if (rankCount == 4 || (state.suitRanks & card)) {
+        return false;
+    }
+
+    next = state;
+    next.rankCounts += ((uint64_t) 1 << (3 * rank)) + ((uint64_t) 1 << NUM_CARD_COUNT_SHIFT);
+    // Only suits that can still make a flush keep track of their cards
+    if (CountCards(SuitRanks(state.suitRanks, suit)) + cardsToCome >= 5) {
+        next.suitRanks |= card;
+    }
+    ForgetDeadSuits(next);
+
+    return true;
+}
+
+// Work out the hand key of a state with 5 to 7 cards
+unsigned int StateHandKey(const RankTableState &state) {
+    // A suit with 5 or more cards is a flush, and with 7 cards or fewer nothing else can beat it
+    for (int suit = 0; suit < 4; suit++) {
+        unsigned int suitRanks = SuitRanks(state.suitRanks, suit);
+        if (CountCards(suitRanks) >= 5) {
+            return EvaluateHand((CardMask) suitRanks);
+        }
+    }
+
+    // Otherwise only the card numbers matter, so hand the suits out in turn to build any set with those numbers
+    CardMask cards = 0;
+    int nextSuit = 0;
+    for (int rank = 0; rank < 13; rank++) {
+        int rankCount = (state.rankCounts >> (3 * rank)) & 7;
+        for (int i = 0; i < rankCount; i++) {
+            cards |= (CardMask) 1 << (nextSuit * MASK_LANE_BITS + rank);
+            nextSuit = (nextSuit + 1) % 4;
+        }
+    }
+
+    return EvaluateHand(cards);
+}
+
+// Build every state in order of its number of cards, writing each state's entries to the file as soon as they are known.
+// A state's entries only point at states with more cards, which are numbered the first time they are reached,
+// so the whole table never needs to be held in memory. Returns the number of states written
+uint32_t WriteRankTableStates(std::ofstream &file) {
+    std::vector<RankTableState> states;
+    std::unordered_map<RankTableState, uint32_t, RankTableStateHash> stateNumbers;
+    std::vector<uint32_t> entries(RANK_TABLE_ENTRIES_PER_STATE);
+
+    RankTableState empty = {0, 0};
+    states.push_back(empty);
+    stateNumbers[empty] = 0;
+
+    for (size_t i = 0; i < states.size(); i++) {
+        RankTableState state = states.at(i);
+        int numCards = StateCards(state);
+
+        entries.at(0) = numCards >= 5 ? StateHandKey(state) : 0;
+
+        for (int suit = 0; suit < 4; suit++) {
+            for (int rank = 0; rank < 13; rank++) {
+                unsigned char cardCode = (suit << CARD_SUIT_SHIFT) | rank;
+                uint32_t &entry = entries.at(RankTableEntry(cardCode));
+                RankTableState next;
+
+                if (!AddCardToState(state, cardCode, next)) {
+                    entry = 0;
+                }
+                // The 7th card leads straight to the hand key
+                else if (numCards == 6) {
+                    entry = StateHandKey(next);
+                }
+                else {
+                    auto found = stateNumbers.find(next);
+                    if (found == stateNumbers.end()) {
+                        found = stateNumbers.emplace(next, states.size()).first;
+                        states.push_back(next);
+                    }
+                    entry = found->second * RANK_TABLE_ENTRIES_PER_STATE;
+                }
+            }
+        }
+
+        file.write((const char *) entries.data(), entries.size() * sizeof(uint32_t));
+    }
+
+    return states.size();
+}
+
+// Fill the hands vector with random sets of 7 different cards
+void DealRandomHands(std::vector<CardMask> &hands, unsigned int seed) {
+    std::mt19937_64 generator(seed);
+    std::uniform_int_distribution<int> cardDistribution(0, 51);
+
+    for (size_t i = 0; i < hands.size(); i++) {
+        CardMask hand = 0;
+        while (CountCards(hand) < 7) {
+            int card = cardDistribution(generator);
+            hand |= Card(card % 13 + 1, card / 13 + 1).GetCardMask();
+        }
+        hands.at(i) = hand;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::string path = argc > 1 ? argv[1] : DEFAULT_RANK_TABLE_FILE;
+    size_t numHands = argc > 2 ? std::stoul(argv[2]) : 1 << 22;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open()) {
+        std::cout << "Could not open file: '" << path << "'\n";
+        return 1;
+    }
+
+    // Write a placeholder header first, and fill in the number of states once they are all written
+    RankTableHeader header = {};
+    memcpy(header.magic, RANK_TABLE_MAGIC, sizeof(RANK_TABLE_MAGIC));
+    header.version = RANK_TABLE_VERSION;
+    header.headerBytes = sizeof(RankTableHeader);
+    header.entriesPerState = RANK_TABLE_ENTRIES_PER_STATE;
+    header.handKeyCategoryShift = HAND_KEY_CATEGORY_SHIFT;
+    header.handKeyValueBits = HAND_KEY_VALUE_BITS;
+    file.write((const char *) &header, sizeof(header));
+
+    auto start = std::chrono::steady_clock::now();
+    header.numStates = WriteRankTableStates(file);
+    file.seekp(0);
+    file.write((const char *) &header, sizeof(header));
+    file.close();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    if (!file) {
+        std::cout << "ERROR: writing '" << path << "' failed\n";
+        return 1;
+    }
+    std::cout << "Wrote " << header.numStates << " states ("
+              << (sizeof(header) + (size_t) header.numStates * RANK_TABLE_ENTRIES_PER_STATE * sizeof(uint32_t)) / 1e6
+              << " MB) to " << path << " in " << elapsed.count() << " seconds\n";
+
+    if (!LoadRankTable(path)) {
+        std::cout << "ERROR: the new file could not be loaded\n";
+        return 1;
+    }
+
+    // Check the table against EvaluateHand and time both
+    std::vector<CardMask> hands(numHands);
+    DealRandomHands(hands, 2024);
+    std::vector<unsigned int> tableKeys(numHands);
+    std::vector<unsigned int> computedKeys(numHands);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < numHands; i++) {
+        computedKeys.at(i) = EvaluateHand(hands.at(i));
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "EvaluateHand: " << numHands / elapsed.count() / 1e6 << " million hands per second\n";
+
+    // The first pass also reads each page of the table the first time it is touched, so time a second pass as well
+    for (int pass = 1; pass <= 2; pass++) {
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < numHands; i++) {
+            tableKeys.at(i) = EvaluateHandWithRankTable(hands.at(i));
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "EvaluateHandWithRankTable, pass " << pass << ": " << numHands / elapsed.count() / 1e6 << " million hands per second\n";
+    }
+
+    // Hands of 5 and 6 cards read their key from entry 0 of a state instead, so check those too
+    size_t shortHandMismatches = 0;
+    for (size_t i = 0; i < numHands; i++) {
+        CardMask sixCards = hands.at(i) & (hands.at(i) - 1);
+        CardMask fiveCards = sixCards & (sixCards - 1);
+        if (EvaluateHandWithRankTable(sixCards) != EvaluateHand(sixCards) || EvaluateHandWithRankTable(fiveCards) != EvaluateHand(fiveCards)) {
+            shortHandMismatches++;
+        }
+    }
+
+    if (tableKeys != computedKeys || shortHandMismatches) {
+        std::cout << "ERROR: the rank table did not match EvaluateHand!\n";
+        return 1;
+    }
+    std::cout << "Every hand checked matches EvaluateHand\n";
+
+    return 0;
+}
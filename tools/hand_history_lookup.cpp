@@ -0,0 +1,147 @@
+// Find hands in a hand history file through its index (see hand_history_index.h): every hand a player played,
+// every hand within a range of round numbers, or both, printed out in full without reading the rest of the file.
+// Built from the repository root with:
+//   g++ -std=c++17 -O2 -pthread -o hand_history_lookup tools/hand_history_lookup.cpp hand_history_index.cpp hand_history.cpp log_writer.cpp card.cpp
+// Usage: hand_history_lookup [--player NAME] [--rounds FIRST[-LAST]] [--limit N] [--update] FILE
+//   --update   index anything in the file the index does not cover yet (creating the index if there is none) before looking
+// For example: hand_history_lookup --player tight-3 --rounds 1-5 hand_history.thhb
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <climits>
+#include <stdexcept>
+
+#include "../hand_history_index.h"
+
+const std::string STREET_NAMES[NUM_STREETS] = {"Preflop", "Flop", "Turn", "River"};
+const std::string ACTION_NAMES[] = {"folds", "checks", "calls", "raises", "goes all-in"};
+
+// Print a card code as its full name, such as "Ace of spades"
+std::string CardName(unsigned char code) {
+    return code == NO_CARD ? "unknown" : Card::FromCode(code).GetCardString();
+}
+
+// Print everything about a hand: the seats, the cards, every action street by street and the chips won
+void PrintHand(const HandRecord &hand) {
+    std::cout << "Game " << hand.gameId << " (seed " << hand.seed << "), round " << hand.handNumber << ": blinds "
+              << hand.smallBlind << "/" << hand.bigBlind << ", " << hand.seats.at(hand.dealer).name << " dealing\n";
+
+    for (size_t seat = 0; seat < hand.seats.size(); seat++) {
+        const SeatRecord &record = hand.seats[seat];
+        std::cout << "  " << record.name << " (" << record.chips << " chips): " << CardName(record.holeCards[0]) << ", "
+                  << CardName(record.holeCards[1]);
+        if (hand.chipsWon[seat] > 0) {
+            std::cout << ", won " << hand.chipsWon[seat];
+        }
+        std::cout << "\n";
+    }
+
+    if (!hand.board.empty()) {
+        std::cout << "  Board: ";
+        for (size_t i = 0; i < hand.board.size(); i++) {
+            std::cout << (i > 0 ? ", " : "") << CardName(hand.board[i]);
+        }
+        std::cout << "\n";
+    }
+
+    int street = -1;
+    for (const ActionRecord &action : hand.actions) {
+        if (action.street != street) {
+            street = action.street;
+            std::cout << (street > PREFLOP ? "\n" : "") << "  " << STREET_NAMES[street] << ":";
+        }
+        std::cout << " " << hand.seats.at(action.seat).name << " " << ACTION_NAMES[action.type];
+        if (action.amount > 0) {
+            std::cout << " " << action.amount;
+        }
+        std::cout << ";";
+    }
+    std::cout << "\n\n";
+}
+
+int main(int argc, char *argv[]) {
+    std::string path;
+    std::string player;
+    int firstRound = 1;
+    int lastRound = INT_MAX;
+    long limit = 0;
+    bool update = false;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+
+            // --update is a switch, every other option is followed by its value
+            if (argument == "--update") {
+                update = true;
+                continue;
+            }
+            if (argument.rfind("--", 0) == 0 && i + 1 >= argc) {
+                throw std::invalid_argument(argument + " needs a value");
+            }
+
+            if (argument == "--player") {
+                player = argv[++i];
+            }
+            else if (argument == "--rounds") {
+                // A single round, or a range such as 10-20
+                std::string rounds = argv[++i];
+                size_t dash = rounds.find('-');
+                firstRound = std::stoi(rounds.substr(0, dash));
+                lastRound = dash == std::string::npos ? firstRound : std::stoi(rounds.substr(dash + 1));
+            }
+            else if (argument == "--limit") {
+                limit = std::stol(argv[++i]);
+            }
+            else if (argument.rfind("--", 0) == 0) {
+                throw std::invalid_argument("unknown option " + argument);
+            }
+            else {
+                path = argument;
+            }
+        }
+        if (path.empty()) {
+            throw std::invalid_argument("no hand history file given");
+        }
+        if (player.empty() && firstRound == 1 && lastRound == INT_MAX) {
+            throw std::invalid_argument("give a player, a range of rounds, or both");
+        }
+
+        if (update && !UpdateHandHistoryIndex(path)) {
+            throw std::invalid_argument("could not index '" + path + "'");
+        }
+
+        HandHistoryIndex index(path);
+        if (!index.IsOpen()) {
+            throw std::invalid_argument("could not open '" + path + "' and its index (run with --update to create the index)");
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<HandLocation> locations = player.empty() ? index.FindRoundHands(firstRound, lastRound)
+                                                             : index.FindPlayerHands(player, firstRound, lastRound);
+
+        HandRecord hand;
+        long printed = 0;
+        for (const HandLocation &location : locations) {
+            if (limit > 0 && printed == limit) {
+                break;
+            }
+            index.ReadHand(location, hand);
+            PrintHand(hand);
+            printed++;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Found " << locations.size() << " hands (printed " << printed << ") out of the " << index.GetNumHands()
+                  << " indexed in " << elapsed.count() << " seconds\n";
+    }
+    catch (const std::exception &error) {
+        std::cout << "ERROR: " << error.what() << "\n";
+        std::cout << "Usage: hand_history_lookup [--player NAME] [--rounds FIRST[-LAST]] [--limit N] [--update] FILE\n";
+        return 1;
+    }
+
+    return 0;
+}
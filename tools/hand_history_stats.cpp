@@ -0,0 +1,386 @@
+// Add up how every player did over one or more hand history files (see hand_history.h): hands played, net chips won or lost,
+// how often they went to a showdown and won there, and the type of hand they showed down with.
+// Each file is mapped into memory rather than read in, then cut into pieces at record boundaries that are scanned in parallel,
+// so files of any size are read straight from the page cache with every core busy.
+// Built from the repository root with:
+//   g++ -std=c++17 -O2 -pthread -o hand_history_stats tools/hand_history_stats.cpp hand_history.cpp hand_history_index.cpp log_writer.cpp thread_pool.cpp hand_evaluator.cpp card.cpp
+// Usage: hand_history_stats [--threads N] FILE [FILE ...]
+// Memory mapping needs a POSIX system (Linux or macOS)
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../hand_history.h"
+#include "../hand_evaluator.h"
+#include "../thread_pool.h"
+
+const int NUM_CATEGORIES = 11;
+const std::string CATEGORY_NAMES[NUM_CATEGORIES] = {"none", "High card", "Pair", "Two pair", "Three-of-a-kind", "Straight",
+                                                    "Flush", "Full house", "Four-of-a-kind", "Straight flush", "Royal flush"};
+// Each thread gets about this many pieces of a file, so a thread finishing early can take pieces from the others
+const int PIECES_PER_THREAD = 8;
+
+// How one player did over every hand scanned
+struct PlayerStats {
+    long hands = 0;
+    long netChips = 0;
+    long showdowns = 0;
+    // Showdowns where the player won (or split) at least one pot someone else was playing for too
+    long showdownWins = 0;
+    // The type of hand the player showed down with, indexed by the hand key category
+    long categories[NUM_CATEGORIES] = {};
+};
+
+// Add one player's stats into another's
+void AddStats(PlayerStats &total, const PlayerStats &stats) {
+    total.hands += stats.hands;
+    total.netChips += stats.netChips;
+    total.showdowns += stats.showdowns;
+    total.showdownWins += stats.showdownWins;
+    for (int i = 0; i < NUM_CATEGORIES; i++) {
+        total.categories[i] += stats.categories[i];
+    }
+}
+
+// A hand history file mapped into memory, unmapped again when it goes out of scope
+class MappedFile {
+    public:
+        MappedFile(const std::string &path) {
+            int file = open(path.c_str(), O_RDONLY);
+            if (file < 0) {
+                throw std::invalid_argument("could not open '" + path + "'");
+            }
+
+            struct stat fileInfo;
+            if (fstat(file, &fileInfo) != 0) {
+                close(file);
+                throw std::invalid_argument("could not read the size of '" + path + "'");
+            }
+
+            // The mapping stays valid after the file is closed
+            size = fileInfo.st_size;
+            mapping = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0) : nullptr;
+            close(file);
+            if (mapping == MAP_FAILED) {
+                throw std::invalid_argument("could not map '" + path + "' into memory");
+            }
+
+            // Every page is read once from start to end, so the system can read well ahead of the scan
+            if (mapping) {
+                madvise(mapping, size, MADV_SEQUENTIAL);
+            }
+        }
+
+        ~MappedFile() {
+            if (mapping) {
+                munmap(mapping, size);
+            }
+        }
+
+        const unsigned char *GetData() {
+            return (const unsigned char *) mapping;
+        }
+
+        size_t GetSize() {
+            return size;
+        }
+
+    private:
+        void *mapping;
+        size_t size;
+};
+
+// A piece of a file to be scanned by one task: the records from start to end, and a parser that already knows
+// every player name and game seed given before start
+struct FilePiece {
+    size_t start = 0;
+    size_t end = 0;
+    HandHistoryParser parser;
+};
+
+// Read the length of the record at "position" and return where its payload starts, throwing if the file is damaged there
+const unsigned char *RecordPayload(const unsigned char *data, size_t size, size_t position, uint64_t &length) {
+    const unsigned char *payload = data + position;
+    if (!ReadVarint(payload, data + size, length) || length == 0 || length > (uint64_t) (data + size - payload)) {
+        throw std::invalid_argument("damaged record at byte " + std::to_string(position));
+    }
+    return payload;
+}
+
+// Cut a file into pieces of about pieceBytes each, at record boundaries. Only the length of each record is read,
+// apart from the few GAME and PLAYER records, which are parsed so each piece's parser can start from where the last one left off
+std::vector<FilePiece> SplitFile(const unsigned char *data, size_t size, size_t pieceBytes) {
+    std::vector<FilePiece> pieces;
+    HandHistoryParser parser;
+    HandRecord unused;
+    size_t position = ReadHandHistoryHeader(data, size);
+
+    while (position < size) {
+        FilePiece piece;
+        piece.start = position;
+        piece.parser = parser;
+
+        while (position < size && position - piece.start < pieceBytes) {
+            uint64_t length;
+            const unsigned char *payload = RecordPayload(data, size, position, length);
+            if (payload[0] != HAND_RECORD) {
+                parser.ParseRecord(payload, length, unused);
+            }
+            position = payload + length - data;
+        }
+
+        piece.end = position;
+        pieces.push_back(piece);
+    }
+
+    return pieces;
+}
+
+// Add one hand to the stats of the players in it, which are kept by player id
+void CountHand(const HandRecord &hand, std::vector<PlayerStats> &statsById) {
+    int numSeats = hand.seats.size();
+    int totalBets[HAND_HISTORY_MAX_SEATS] = {};
+    bool folded[HAND_HISTORY_MAX_SEATS] = {};
+    unsigned int handKeys[HAND_HISTORY_MAX_SEATS] = {};
+
+    // Every seat's part of the pot: its blind (or all it had, if that was less) and every chip it put in after that
+    int blindSeats[2] = {hand.smallBlindSeat, hand.bigBlindSeat};
+    int blinds[2] = {hand.smallBlind, hand.bigBlind};
+    for (int i = 0; i < 2; i++) {
+        int seat = blindSeats[i];
+        totalBets[seat] += std::min(blinds[i], hand.seats[seat].chips - totalBets[seat]);
+    }
+    for (const ActionRecord &action : hand.actions) {
+        totalBets[action.seat] += action.amount;
+        if (action.type == FOLD) {
+            folded[action.seat] = true;
+        }
+    }
+    // A seat dealt no cards (NO_CARD) never had a hand to show, so it is left out of the showdown like a folded one
+    for (int seat = 0; seat < numSeats; seat++) {
+        if (hand.seats[seat].holeCards[0] == NO_CARD || hand.seats[seat].holeCards[1] == NO_CARD) {
+            folded[seat] = true;
+        }
+    }
+
+    // Only hands that went to a showdown have their cards evaluated
+    int numShowingDown = 0;
+    int largestBet = 0;
+    int secondLargestBet = 0;
+    CardMask board = 0;
+    // The parser has already checked every card code (see HandHistoryParser::ParseRecord)
+    for (unsigned char code : hand.board) {
+        board |= Card::FromCode(code).GetCardMask();
+    }
+    for (int seat = 0; seat < numSeats; seat++) {
+        if (!folded[seat]) {
+            numShowingDown++;
+            secondLargestBet = std::max(secondLargestBet, std::min(largestBet, totalBets[seat]));
+            largestBet = std::max(largestBet, totalBets[seat]);
+        }
+    }
+    if (numShowingDown > 1) {
+        for (int seat = 0; seat < numSeats; seat++) {
+            if (!folded[seat]) {
+                CardMask cards = board | Card::FromCode(hand.seats[seat].holeCards[0]).GetCardMask() |
+                                 Card::FromCode(hand.seats[seat].holeCards[1]).GetCardMask();
+                handKeys[seat] = EvaluateHand(cards);
+            }
+        }
+    }
+
+    for (int seat = 0; seat < numSeats; seat++) {
+        // The parser only lets through ids below HAND_HISTORY_MAX_ID, which bounds how far this can grow
+        int playerId = hand.seats[seat].playerId;
+        if (playerId >= (int) statsById.size()) {
+            statsById.resize(playerId + 1);
+        }
+
+        PlayerStats &stats = statsById[playerId];
+        stats.hands++;
+        stats.netChips += hand.chipsWon[seat] - totalBets[seat];
+        if (numShowingDown < 2 || folded[seat]) {
+            continue;
+        }
+
+        // The pots a player plays for get fewer players the higher they go (see pot.h), so the highest pot the player shares
+        // with anyone is the one with the fewest hands to beat: it is the pot up to the player's own bet, or up to the second
+        // largest bet if nobody else bet as much as the player. Winning a contested pot means having the best hand in that one
+        int sharedLevel = std::min(totalBets[seat], secondLargestBet);
+        bool wonPot = true;
+        for (int other = 0; other < numSeats; other++) {
+            if (!folded[other] && totalBets[other] >= sharedLevel && handKeys[other] > handKeys[seat]) {
+                wonPot = false;
+            }
+        }
+
+        stats.showdowns++;
+        stats.showdownWins += wonPot ? 1 : 0;
+        stats.categories[HandKeyCategory(handKeys[seat])]++;
+    }
+}
+
+// Move the stats kept by player id over to the stats kept by name, using the names the parser knows right now
+void MoveStatsToNames(std::vector<PlayerStats> &statsById, HandHistoryParser &parser, std::unordered_map<std::string, PlayerStats> &statsByName) {
+    for (size_t id = 0; id < statsById.size(); id++) {
+        if (statsById[id].hands > 0) {
+            AddStats(statsByName[parser.PlayerName(id)], statsById[id]);
+        }
+    }
+    statsById.clear();
+}
+
+// Scan every record in a piece of a file and return the stats of every player in it by name, along with the number of hands
+long ScanPiece(const unsigned char *data, size_t size, FilePiece &piece, std::unordered_map<std::string, PlayerStats> &statsByName) {
+    // Stats are kept by player id while scanning, which is much quicker than looking up names, and only moved over to names
+    // at the end (or when an id that already has stats is given to a new name, which happens where files were joined together)
+    std::vector<PlayerStats> statsById;
+    HandRecord hand;
+    long numHands = 0;
+
+    for (size_t position = piece.start; position < piece.end; ) {
+        uint64_t length;
+        const unsigned char *payload = RecordPayload(data, size, position, length);
+        position = payload + length - data;
+
+        if (payload[0] == PLAYER_RECORD) {
+            const unsigned char *idBytes = payload + 1;
+            uint64_t playerId;
+            if (ReadVarint(idBytes, payload + length, playerId) && playerId < statsById.size() && statsById[playerId].hands > 0) {
+                MoveStatsToNames(statsById, piece.parser, statsByName);
+            }
+        }
+
+        if (piece.parser.ParseRecord(payload, length, hand)) {
+            CountHand(hand, statsById);
+            numHands++;
+        }
+    }
+
+    MoveStatsToNames(statsById, piece.parser, statsByName);
+    return numHands;
+}
+
+// Print each player's stats, from the most chips won to the most lost, and then the hands they showed down with
+void PrintStats(const std::unordered_map<std::string, PlayerStats> &statsByName) {
+    std::vector<std::pair<std::string, PlayerStats>> players(statsByName.begin(), statsByName.end());
+    std::sort(players.begin(), players.end(), [](const std::pair<std::string, PlayerStats> &a, const std::pair<std::string, PlayerStats> &b) {
+        return a.second.netChips != b.second.netChips ? a.second.netChips > b.second.netChips : a.first < b.first;
+    });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(16) << "Player" << std::right << std::setw(12) << "Hands" << std::setw(14) << "Net chips"
+              << std::setw(12) << "Per hand" << std::setw(12) << "Showdowns" << std::setw(10) << "Won" << "\n";
+    for (const auto &player : players) {
+        const PlayerStats &stats = player.second;
+        double perHand = stats.hands > 0 ? (double) stats.netChips / stats.hands : 0;
+        double winRate = stats.showdowns > 0 ? (double) stats.showdownWins / stats.showdowns : 0;
+        std::cout << std::left << std::setw(16) << player.first << std::right << std::setw(12) << stats.hands << std::setw(14) << stats.netChips
+                  << std::setw(12) << perHand << std::setw(12) << stats.showdowns << std::setw(9) << winRate * 100 << "%\n";
+    }
+
+    // The share of each player's showdowns made with each type of hand
+    std::cout << "\nHands shown down, as a share of each player's showdowns:\n" << std::left << std::setw(16) << "Player" << std::right;
+    for (int category = 1; category < NUM_CATEGORIES; category++) {
+        std::cout << std::setw(16) << CATEGORY_NAMES[category];
+    }
+    std::cout << "\n";
+    for (const auto &player : players) {
+        const PlayerStats &stats = player.second;
+        std::cout << std::left << std::setw(16) << player.first << std::right;
+        for (int category = 1; category < NUM_CATEGORIES; category++) {
+            double share = stats.showdowns > 0 ? (double) stats.categories[category] / stats.showdowns : 0;
+            std::cout << std::setw(15) << share * 100 << "%";
+        }
+        std::cout << "\n";
+    }
+}
+
+int main(int argc, char *argv[]) {
+    std::vector<std::string> paths;
+    int numThreads = 0;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string argument = argv[i];
+
+            if (argument == "--threads") {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(argument + " needs a value");
+                }
+                numThreads = std::stoi(argv[++i]);
+            }
+            else {
+                paths.push_back(argument);
+            }
+        }
+        if (paths.empty()) {
+            throw std::invalid_argument("no hand history files given");
+        }
+
+        ThreadPool pool(numThreads);
+        std::unordered_map<std::string, PlayerStats> statsByName;
+        long totalHands = 0;
+        size_t totalBytes = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        // The files are taken one at a time, with every thread working on pieces of the same file
+        for (const std::string &path : paths) {
+            MappedFile file(path);
+            std::vector<FilePiece> pieces = SplitFile(file.GetData(), file.GetSize(),
+                                                      std::max(file.GetSize() / (pool.GetNumThreads() * PIECES_PER_THREAD), (size_t) 1));
+
+            std::vector<std::unordered_map<std::string, PlayerStats>> pieceStats(pieces.size());
+            std::vector<long> pieceHands(pieces.size(), 0);
+            std::vector<std::string> pieceErrors(pieces.size());
+
+            for (size_t i = 0; i < pieces.size(); i++) {
+                pool.Submit([&file, &pieces, &pieceStats, &pieceHands, &pieceErrors, i] {
+                    // Tasks on the pool must not throw, so a damaged record is passed back as an error message
+                    try {
+                        pieceHands[i] = ScanPiece(file.GetData(), file.GetSize(), pieces[i], pieceStats[i]);
+                    }
+                    catch (const std::exception &error) {
+                        pieceErrors[i] = error.what();
+                    }
+                });
+            }
+            pool.Wait();
+
+            for (size_t i = 0; i < pieces.size(); i++) {
+                if (!pieceErrors[i].empty()) {
+                    throw std::invalid_argument(path + ": " + pieceErrors[i]);
+                }
+                totalHands += pieceHands[i];
+                for (const auto &player : pieceStats[i]) {
+                    AddStats(statsByName[player.first], player.second);
+                }
+            }
+            totalBytes += file.GetSize();
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        PrintStats(statsByName);
+        std::cout << std::setprecision(2) << "\nScanned " << totalHands << " hands (" << totalBytes / 1e6 << " MB) in " << elapsed.count()
+                  << " seconds with " << pool.GetNumThreads() << " threads, " << std::setprecision(0)
+                  << (elapsed.count() > 0 ? totalHands / elapsed.count() : 0) << " hands per second\n";
+    }
+    catch (const std::exception &error) {
+        std::cout << "ERROR: " << error.what() << "\n";
+        std::cout << "Usage: hand_history_stats [--threads N] FILE [FILE ...]\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+// Check every entry of the compile-time evaluator tables against the original hand checks in player.cpp
+// (Player::EvaluateCardsReference), and check both of them against a brute-force scorer written separately here,
+// which shares no code with either: it scores every 5 cards that can be picked from the hand with the plain rules
+// of the game and keeps the best. A hand passes only when all three agree.
+// Built from the repository root with:
+//   g++ -std=c++17 -O2 -o verify_evaluator_tables tools/verify_evaluator_tables.cpp hand_evaluator.cpp hand_evaluator_simd.cpp card.cpp player.cpp
+// Usage: verify_evaluator_tables [number of mismatches to print]
+
+#include <iostream>
+#include <string>
+#include <algorithm>
+
+#include "../player.h"
+
+// The names of the hand types, indexed by the hand key category
+const std::string CATEGORY_NAMES[] = {"none", "high card", "pair", "two pair", "three-of-a-kind", "straight",
+                                      "flush", "full house", "four-of-a-kind", "straight flush", "Royal flush"};
+
+// Counters shared by every check
+struct VerifyResults {
+    long checked = 0;
+    long mismatches = 0;
+    // Counted by the category the brute-force scorer gives the hand
+    long tableMismatchesByCategory[11] = {};
+    long referenceMismatchesByCategory[11] = {};
+    int maxPrinted = 20;
+};
+
+// Print a hand key as its category followed by its five card numbers
+void PrintHandKey(unsigned int handKey) {
+    std::cout << CATEGORY_NAMES[HandKeyCategory(handKey)];
+    for (int position = 1; position <= 5; position++) {
+        std::cout << " " << HandKeyValue(handKey, position);
+    }
+}
+
+// Score exactly 5 cards with the plain rules of the game, given their card numbers (2-14, Aces high) and suits
+unsigned int ScoreFiveCards(const int numbers[5], const int suits[5]) {
+    // Sort the card numbers from highest to lowest
+    int sorted[5];
+    std::copy(numbers, numbers + 5, sorted);
+    std::sort(sorted, sorted + 5, [](int first, int second) { return first > second; });
+
+    bool flush = true;
+    for (int i = 1; i < 5; i++) {
+        if (suits[i] != suits[0]) {
+            flush = false;
+        }
+    }
+
+    // Five different card numbers in a row make a straight, and so does A, 2, 3, 4, 5 (where the 5 is the highest card)
+    int straightHigh = 0;
+    bool allDifferent = sorted[0] != sorted[1] && sorted[1] != sorted[2] && sorted[2] != sorted[3] && sorted[3] != sorted[4];
+    if (allDifferent && sorted[0] - sorted[4] == 4) {
+        straightHigh = sorted[0];
+    }
+    else if (sorted[0] == 14 && sorted[1] == 5 && sorted[2] == 4 && sorted[3] == 3 && sorted[4] == 2) {
+        straightHigh = 5;
+    }
+
+    int values[5] = {0, 0, 0, 0, 0};
+    if (flush && straightHigh == 14) {
+        values[0] = 14;
+        return MakeHandKey(10, values);
+    }
+    if (flush && straightHigh) {
+        values[0] = straightHigh;
+        return MakeHandKey(9, values);
+    }
+
+    // Group the card numbers into sets, putting bigger sets first and higher card numbers first within sets of the same size
+    int counts[15] = {};
+    for (int i = 0; i < 5; i++) {
+        counts[sorted[i]]++;
+    }
+    int grouped[5];
+    int numGroups = 0;
+    for (int size = 4; size >= 1; size--) {
+        for (int number = 14; number >= 2; number--) {
+            if (counts[number] == size) {
+                grouped[numGroups++] = number;
+            }
+        }
+    }
+
+    int category;
+    if (counts[grouped[0]] == 4) {
+        category = 8;
+    }
+    else if (counts[grouped[0]] == 3 && counts[grouped[1]] == 2) {
+        category = 7;
+    }
+    else if (flush) {
+        std::copy(sorted, sorted + 5, values);
+        return MakeHandKey(6, values);
+    }
+    else if (straightHigh) {
+        values[0] = straightHigh;
+        return MakeHandKey(5, values);
+    }
+    else if (counts[grouped[0]] == 3) {
+        category = 4;
+    }
+    else if (counts[grouped[0]] == 2 && counts[grouped[1]] == 2) {
+        category = 3;
+    }
+    else if (counts[grouped[0]] == 2) {
+        category = 2;
+    }
+    else {
+        category = 1;
+    }
+
+    // Every other hand is worth its sets in order, then its remaining cards from highest to lowest
+    std::copy(grouped, grouped + numGroups, values);
+    return MakeHandKey(category, values);
+}
+
+// Score the best 5 cards out of a set of 5 to 7 cards by trying every way of picking 5 of them
+unsigned int BruteForceHandKey(const Card cardList[], int numCards) {
+    unsigned int bestKey = 0;
+
+    for (int picked = 0; picked < (1 << numCards); picked++) {
+        if (__builtin_popcount(picked) != 5) {
+            continue;
+        }
+
+        int numbers[5];
+        int suits[5];
+        int numPicked = 0;
+        for (int i = 0; i < numCards; i++) {
+            if (picked & (1 << i)) {
+                numbers[numPicked] = cardList[i].GetHighCardNumber();
+                suits[numPicked] = cardList[i].GetCardSuit();
+                numPicked++;
+            }
+        }
+
+        bestKey = std::max(bestKey, ScoreFiveCards(numbers, suits));
+    }
+
+    return bestKey;
+}
+
+// Evaluate one set of cards all three ways and record whether the tables and the reference both agree with the brute-force score
+void CheckHand(CardMask cards, VerifyResults &results) {
+    Card cardList[7];
+    int numCards = MaskToCards(cards, cardList);
+    Player reference;
+
+    // The reference reads the player's own cards, so give the player all of them and no community cards
+    for (int i = 0; i < numCards; i++) {
+        reference.TakeCard(cardList[i]);
+    }
+    reference.EvaluateCardsReference(0);
+
+    unsigned int tableKey = EvaluateHand(cards);
+    unsigned int referenceKey = reference.GetHandKey();
+    unsigned int bruteForceKey = BruteForceHandKey(cardList, numCards);
+    results.checked++;
+
+    if (tableKey == bruteForceKey && referenceKey == bruteForceKey) {
+        return;
+    }
+
+    results.mismatches++;
+    if (tableKey != bruteForceKey) {
+        results.tableMismatchesByCategory[HandKeyCategory(bruteForceKey)]++;
+    }
+    if (referenceKey != bruteForceKey) {
+        results.referenceMismatchesByCategory[HandKeyCategory(bruteForceKey)]++;
+    }
+    if (results.mismatches <= results.maxPrinted) {
+        for (int i = 0; i < numCards; i++) {
+            std::cout << cardList[i].GetCardString() << " ";
+        }
+        std::cout << "| brute force: ";
+        PrintHandKey(bruteForceKey);
+        std::cout << " | tables: ";
+        PrintHandKey(tableKey);
+        std::cout << " | reference: ";
+        PrintHandKey(referenceKey);
+        std::cout << "\n";
+    }
+}
+
+// Every flush table entry that can be looked up: 5, 6 or 7 card numbers, all of one suit
+void CheckFlushEntries(VerifyResults &results) {
+    for (unsigned int rankMask = 0; rankMask < (1u << 13); rankMask++) {
+        int numCards = __builtin_popcount(rankMask);
+        if (numCards >= 5 && numCards <= 7) {
+            CheckHand((CardMask) rankMask, results);
+        }
+    }
+}
+
+// Recursively spread "cardsLeft" cards over the card numbers from "rank" up (at most 4 of each),
+// checking every finished pattern. The suits are handed out in turn so no 5 cards ever share a suit,
+// which reaches every rank table entry exactly once
+void CheckRankEntries(int rank, int cardsLeft, CardMask cards, int nextSuit, VerifyResults &results) {
+    if (cardsLeft == 0) {
+        CheckHand(cards, results);
+        return;
+    }
+    if (rank == 13) {
+        return;
+    }
+
+    for (int count = 0; count <= 4 && count <= cardsLeft; count++) {
+        CardMask withRank = cards;
+        for (int i = 0; i < count; i++) {
+            withRank |= (CardMask) 1 << (((nextSuit + i) % 4) * MASK_LANE_BITS + rank);
+        }
+        CheckRankEntries(rank + 1, cardsLeft - count, withRank, (nextSuit + count) % 4, results);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    VerifyResults results;
+    if (argc > 1) {
+        results.maxPrinted = std::stoi(argv[1]);
+    }
+
+    CheckFlushEntries(results);
+    long flushChecked = results.checked;
+    std::cout << "Checked " << flushChecked << " flush table entries\n";
+
+    for (int numCards = 5; numCards <= 7; numCards++) {
+        CheckRankEntries(0, numCards, 0, 0, results);
+    }
+    std::cout << "Checked " << results.checked - flushChecked << " rank table entries\n";
+
+    if (results.mismatches == 0) {
+        std::cout << "Every table entry matches the reference hand checks and the brute-force score\n";
+        return 0;
+    }
+
+    std::cout << "ERROR: " << results.mismatches << " table entries did not match the brute-force score\n";
+    for (int category = 1; category <= 10; category++) {
+        if (results.tableMismatchesByCategory[category] || results.referenceMismatchesByCategory[category]) {
+            std::cout << "  " << CATEGORY_NAMES[category] << ": " << results.tableMismatchesByCategory[category] << " wrong in the tables, "
+                      << results.referenceMismatchesByCategory[category] << " wrong in the reference\n";
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,827 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <chrono>
+#include <climits>
+#include <numeric>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <sstream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+
+#include "tournament.h"
+#include "game.h"
+#include "strategy.h"
+#include "thread_pool.h"
+#include "deck.h"
+
+// One table of a tournament: its own players, in seat order, and its own deck
+struct Table {
+    std::vector<Player> players;
+    Deck deck;
+};
+
+// A player knocked out during a step, with the chips they had when the step started
+struct Elimination {
+    int playerId;
+    int startingChips;
+};
+
+// Everything that happened in one tournament, to be added to the TournamentResult
+struct TournamentRecord {
+    long hands = 0;
+    long steps = 0;
+    long tablesBroken = 0;
+    long playersMoved = 0;
+    Blinds finalBlinds;
+    // The place each player finished in, by player id (1 for the winner)
+    std::vector<int> places;
+};
+
+// Return the index of the strategy played by player "playerId" in tournament "tournamentIndex"
+static int PlayerStrategy(const TournamentOptions &options, long tournamentIndex, int playerId) {
+    return (playerId + tournamentIndex) % options.strategies.size();
+}
+
+// Return the blinds for a level, doubling the last level in the list for every level past the end
+// (stopping before the blinds would no longer fit in an int)
+Blinds BlindsForLevel(const std::vector<Blinds> &blindLevels, int level) {
+    if (level < (int) blindLevels.size()) {
+        return blindLevels.at(level);
+    }
+
+    Blinds blinds = blindLevels.back();
+    for (int i = blindLevels.size() - 1; i < level && blinds.bigBlind <= INT_MAX / 2; i++) {
+        blinds.smallBlind *= 2;
+        blinds.bigBlind *= 2;
+    }
+    return blinds;
+}
+
+// Return the options' payouts, or share the pool between the top 15% of the players in proportion to 1 / place
+std::vector<double> TournamentPayouts(const TournamentOptions &options) {
+    if (!options.payouts.empty()) {
+        return options.payouts;
+    }
+
+    int paidPlaces = std::max(1, options.numPlayers * 15 / 100);
+    std::vector<double> payouts;
+    double total = 0;
+    for (int place = 1; place <= paidPlaces; place++) {
+        payouts.push_back(1.0 / place);
+        total += 1.0 / place;
+    }
+    for (double &share : payouts) {
+        share /= total;
+    }
+    return payouts;
+}
+
+// Return the index of the player marked as the dealer at a table
+static int FindDealerSeat(std::vector<Player> &players) {
+    for (size_t i = 0; i < players.size(); i++) {
+        if (players.at(i).isDealer()) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// Return the index of the table with the fewest players. Ties go to the last such table when breaking a table,
+// so the tables at the front are kept, and to the first such table otherwise
+static size_t SmallestTable(const std::vector<Table> &tables, bool lastOfTies) {
+    size_t smallest = 0;
+    for (size_t i = 1; i < tables.size(); i++) {
+        size_t size = tables.at(i).players.size();
+        if (size < tables.at(smallest).players.size() || (lastOfTies && size == tables.at(smallest).players.size())) {
+            smallest = i;
+        }
+    }
+    return smallest;
+}
+
+// Return the index of the first table with the most players
+static size_t LargestTable(const std::vector<Table> &tables) {
+    size_t largest = 0;
+    for (size_t i = 1; i < tables.size(); i++) {
+        if (tables.at(i).players.size() > tables.at(largest).players.size()) {
+            largest = i;
+        }
+    }
+    return largest;
+}
+
+// Move one player from one table to another. The player who would post the big blind in the next hand moves
+// (AssignDealer moves the dealer on one seat, and the big blind sits two seats after that), and they sit down
+// just before the new table's dealer, so they are the last player there to post the blinds.
+// If the player moving was the dealer, the dealer marker goes back to the player before them, as when a player is knocked out
+static void MoveSeat(std::vector<Player> &from, std::vector<Player> &to) {
+    size_t seat = (FindDealerSeat(from) + 3) % from.size();
+    Player moving = std::move(from.at(seat));
+    from.erase(from.begin() + seat);
+
+    if (moving.isDealer()) {
+        moving.FlipDealerStat();
+        if (!from.empty()) {
+            from.at((seat + from.size() - 1) % from.size()).FlipDealerStat();
+        }
+    }
+
+    to.insert(to.begin() + FindDealerSeat(to), moving);
+}
+
+// Everything about a tournament being played: each player's name and strategy, the tables, and what has happened so far
+struct TournamentState {
+    std::vector<std::string> names;
+    std::vector<std::unique_ptr<ActionProvider>> strategies;
+    std::unordered_map<std::string, int> playerIds;
+    TableActionProvider seats;
+    std::vector<Table> tables;
+    TournamentRecord record;
+    int playersLeft = 0;
+};
+
+// Seat a new tournament: give every player their strategy, draw the seats and shuffle each table's deck
+static void StartTournament(const TournamentOptions &options, long tournamentIndex, uint64_t tournamentSeed, TournamentState &state) {
+    Xoshiro256 generator(tournamentSeed);
+
+    // Name each player by their number, such as "player-12", and give them their strategy
+    for (int id = 0; id < options.numPlayers; id++) {
+        state.names.push_back("player-" + std::to_string(id + 1));
+        state.strategies.push_back(MakeStrategy(options.strategies.at(PlayerStrategy(options, tournamentIndex, id)), generator()));
+        state.seats.AddPlayer(state.names.back(), *state.strategies.back());
+        state.playerIds[state.names.back()] = id;
+    }
+
+    // Draw the seats at random, then deal the players out to the tables in turn
+    std::vector<int> seatOrder(options.numPlayers);
+    std::iota(seatOrder.begin(), seatOrder.end(), 0);
+    for (int i = options.numPlayers - 1; i > 0; i--) {
+        std::swap(seatOrder[i], seatOrder[RandomBelow(generator, i + 1)]);
+    }
+
+    int numTables = (options.numPlayers + options.tableSize - 1) / options.tableSize;
+    std::vector<std::vector<std::string>> tableNames(numTables);
+    for (int i = 0; i < options.numPlayers; i++) {
+        tableNames.at(i % numTables).push_back(state.names.at(seatOrder.at(i)));
+    }
+
+    state.tables.resize(numTables);
+    for (int i = 0; i < numTables; i++) {
+        SeatPlayers(state.tables.at(i).players, tableNames.at(i), options.startingChips);
+        state.tables.at(i).deck.SeedDeck(generator());
+    }
+
+    state.record.places.assign(options.numPlayers, 0);
+    state.playersLeft = options.numPlayers;
+}
+
+// Play one step of a tournament, with every table's hands played on the pool, then give out places and break and balance
+// the tables. Returns the number of hands played
+static long PlayStep(const TournamentOptions &options, TournamentState &state, ThreadPool &pool) {
+    std::vector<Table> &tables = state.tables;
+    TournamentRecord &record = state.record;
+
+    Blinds blinds = BlindsForLevel(options.blindLevels, record.steps * options.handsPerStep / options.handsPerLevel);
+    record.finalBlinds = blinds;
+
+    // Remember who sits at each table and their chips, to find out who is knocked out during the step
+    std::vector<std::vector<Elimination>> seated(tables.size());
+    for (size_t t = 0; t < tables.size(); t++) {
+        for (Player &player : tables.at(t).players) {
+            seated.at(t).push_back({state.playerIds.at(player.GetName()), player.GetChips()});
+        }
+    }
+
+    // Every table plays its hands at the same time, sharing nothing but the (read-only) seats
+    std::vector<int> handsPlayed(tables.size());
+    TableActionProvider &seats = state.seats;
+    for (size_t t = 0; t < tables.size(); t++) {
+        pool.Submit([&tables, &seats, &handsPlayed, &options, blinds, t] {
+            handsPlayed[t] = PlayGame(tables[t].players, tables[t].deck, seats, options.handsPerStep, false, blinds);
+        });
+    }
+    pool.Wait();
+    record.steps++;
+
+    // Find every player who was seated at the start of the step but has been removed by DivvyPots since
+    long stepHands = 0;
+    std::vector<Elimination> knockedOut;
+    for (size_t t = 0; t < tables.size(); t++) {
+        stepHands += handsPlayed.at(t);
+
+        for (const Elimination &player : seated.at(t)) {
+            bool stillSeated = false;
+            for (Player &other : tables.at(t).players) {
+                if (state.playerIds.at(other.GetName()) == player.playerId) {
+                    stillSeated = true;
+                    break;
+                }
+            }
+            if (!stillSeated) {
+                knockedOut.push_back(player);
+            }
+        }
+    }
+    record.hands += stepHands;
+
+    // Players knocked out in the same step finish in order of the chips they started it with, then by player number,
+    // taking the places just below everyone still playing
+    std::sort(knockedOut.begin(), knockedOut.end(), [](const Elimination &a, const Elimination &b) {
+        if (a.startingChips != b.startingChips) {
+            return a.startingChips > b.startingChips;
+        }
+        return a.playerId < b.playerId;
+    });
+    for (size_t i = 0; i < knockedOut.size(); i++) {
+        record.places.at(knockedOut.at(i).playerId) = state.playersLeft - knockedOut.size() + 1 + i;
+    }
+    state.playersLeft -= knockedOut.size();
+
+    // Break up tables, from the smallest, until there are no more tables than the players left need,
+    // sending each player to whichever table is smallest at the time
+    size_t tablesNeeded = (state.playersLeft + options.tableSize - 1) / options.tableSize;
+    while (tables.size() > tablesNeeded) {
+        size_t broken = SmallestTable(tables, true);
+        std::vector<Player> brokenPlayers = tables.at(broken).players;
+        tables.erase(tables.begin() + broken);
+        record.tablesBroken++;
+
+        while (!brokenPlayers.empty()) {
+            MoveSeat(brokenPlayers, tables.at(SmallestTable(tables, false)).players);
+            record.playersMoved++;
+        }
+    }
+
+    // Then move players from the largest table to the smallest until no table has two more players than another
+    while (true) {
+        size_t largest = LargestTable(tables);
+        size_t smallest = SmallestTable(tables, false);
+        if (tables.at(largest).players.size() <= tables.at(smallest).players.size() + 1) {
+            break;
+        }
+        MoveSeat(tables.at(largest).players, tables.at(smallest).players);
+        record.playersMoved++;
+    }
+
+    // Once one player is left standing, they win
+    if (state.playersLeft <= 1) {
+        for (Table &table : tables) {
+            for (Player &player : table.players) {
+                record.places.at(state.playerIds.at(player.GetName())) = 1;
+            }
+        }
+    }
+
+    return stepHands;
+}
+
+// The first bytes of every tournament checkpoint file, and the version of the format written
+static const char TOURNAMENT_CHECKPOINT_MAGIC[4] = {'T', 'T', 'C', 'K'};
+static const uint32_t TOURNAMENT_CHECKPOINT_VERSION = 1;
+
+/* The start of a tournament checkpoint file, giving the tournaments it belongs to and how far they had got. After it come the
+   settings (see TournamentSettings), a CheckpointTotals and then a CheckpointStrategy for each strategy, covering the finished
+   tournaments. If a tournament was in progress, they are followed by its CheckpointProgress, the place of each player (an int32_t,
+   0 for players still playing), each player's strategy generator (an int32_t that is 0 for a strategy with none, then its state
+   as 4 uint64_t), and for each table its number of seats (an int32_t), a CheckpointSeat for each seat and its DeckSnapshot.
+*/
+struct TournamentCheckpointHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t seed;
+    int32_t numPlayers;
+    int32_t numTournaments;
+    int32_t tableSize;
+    int32_t startingChips;
+    int32_t handsPerStep;
+    int32_t handsPerLevel;
+    uint32_t settingsBytes;
+    int32_t inProgress;
+    int64_t finishedTournaments;
+};
+
+// The totals of the finished tournaments, or what has happened so far in the tournament in progress
+struct CheckpointTotals {
+    int64_t hands;
+    int64_t steps;
+    int64_t tablesBroken;
+    int64_t playersMoved;
+    int32_t smallBlind;
+    int32_t bigBlind;
+};
+
+struct CheckpointStrategy {
+    int64_t entries;
+    int64_t wins;
+    int64_t paid;
+    double prizes;
+};
+
+// A tournament in progress, past what CheckpointTotals holds for it
+struct CheckpointProgress {
+    int32_t playersLeft;
+    int32_t numTables;
+};
+
+struct CheckpointSeat {
+    int32_t playerId;
+    int32_t chips;
+    int32_t dealer;
+};
+
+// Describe the options that change how the tournaments are played and paid, beyond the numbers in the header,
+// such as "tight,call;10/20,15/30;0.5,0.3,0.2"
+static std::string TournamentSettings(const TournamentOptions &options) {
+    std::ostringstream settings;
+    settings << std::setprecision(17);
+    for (size_t i = 0; i < options.strategies.size(); i++) {
+        settings << (i > 0 ? "," : "") << options.strategies[i];
+    }
+    settings << ";";
+    for (size_t i = 0; i < options.blindLevels.size(); i++) {
+        settings << (i > 0 ? "," : "") << options.blindLevels[i].smallBlind << "/" << options.blindLevels[i].bigBlind;
+    }
+    settings << ";";
+    for (size_t i = 0; i < options.payouts.size(); i++) {
+        settings << (i > 0 ? "," : "") << options.payouts[i];
+    }
+    return settings.str();
+}
+
+/* The progress of a set of tournaments, kept for their checkpoint file. Tournaments are only saved between steps, when no table
+   is playing, so it is only ever used by the thread running the tournaments.
+*/
+class TournamentCheckpoint {
+    public:
+        TournamentCheckpoint(const TournamentOptions &options);
+        // Read the checkpoint file, returning false if there is none yet. Adds the totals of the finished tournaments to the result
+        // and sets finishedTournaments, keeping the tournament in progress (if there is one) for RestoreTournament.
+        // Throws std::invalid_argument if the file is damaged or belongs to different tournaments
+        bool Load(TournamentResult &result, long &finishedTournaments);
+        // Put the tournament in progress back as the checkpoint has it, returning false if it has none.
+        // The tournament must have been started exactly as it was the first time (see StartTournament)
+        bool RestoreTournament(TournamentState &state);
+        // Note down the hands played since the last call, and write the checkpoint file once enough have been played since it was
+        // last written. inProgress is the tournament being played, or null between tournaments
+        void Update(long newHands, const TournamentResult &result, long finishedTournaments, const TournamentState *inProgress);
+        // Write the checkpoint file, returning false if it could not be written
+        bool Write(const TournamentResult &result, long finishedTournaments, const TournamentState *inProgress);
+
+    private:
+        [[noreturn]] void Damaged();
+
+        const TournamentOptions &options;
+        std::string settings;
+        long handsSinceWrite;
+        // The tournament in progress read by Load, with the generator states 4 numbers to a player
+        bool hasSaved;
+        CheckpointTotals savedTotals;
+        std::vector<int32_t> savedPlaces;
+        std::vector<int32_t> savedHasRandomState;
+        std::vector<uint64_t> savedRandomStates;
+        std::vector<std::vector<CheckpointSeat>> savedSeats;
+        std::vector<DeckSnapshot> savedDecks;
+};
+
+// Initialization of a checkpoint with no tournament finished or started
+TournamentCheckpoint::TournamentCheckpoint(const TournamentOptions &options) : options(options) {
+    settings = TournamentSettings(options);
+    handsSinceWrite = 0;
+    hasSaved = false;
+}
+
+// Throw the error for a checkpoint file that cannot have been written by these tournaments as they were played
+void TournamentCheckpoint::Damaged() {
+    throw std::invalid_argument("RunTournaments: the checkpoint file '" + options.checkpointFile + "' is damaged");
+}
+
+// Read the whole checkpoint file, checking it was written by tournaments with the same options, and that the tournament in progress
+// makes sense, since it is played on the pool, where nothing may throw
+bool TournamentCheckpoint::Load(TournamentResult &result, long &finishedTournaments) {
+    std::ifstream file(options.checkpointFile, std::ios_base::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    TournamentCheckpointHeader header;
+    if (!file.read((char *) &header, sizeof(header)) ||
+        std::memcmp(header.magic, TOURNAMENT_CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 || header.version != TOURNAMENT_CHECKPOINT_VERSION) {
+        throw std::invalid_argument("RunTournaments: '" + options.checkpointFile + "' is not a tournament checkpoint file this program can read");
+    }
+
+    std::string savedSettings(std::min<uint32_t>(header.settingsBytes, settings.size() + 1), ' ');
+    file.read(&savedSettings[0], savedSettings.size());
+    if (header.seed != options.seed || header.numPlayers != options.numPlayers || header.numTournaments != options.numTournaments ||
+        header.tableSize != options.tableSize || header.startingChips != options.startingChips ||
+        header.handsPerStep != options.handsPerStep || header.handsPerLevel != options.handsPerLevel || savedSettings != settings) {
+        throw std::invalid_argument("RunTournaments: the checkpoint file '" + options.checkpointFile + "' was written by different tournaments");
+    }
+    if (header.finishedTournaments < 0 || header.finishedTournaments > options.numTournaments ||
+        (header.inProgress && header.finishedTournaments == options.numTournaments)) {
+        Damaged();
+    }
+
+    CheckpointTotals totals;
+    file.read((char *) &totals, sizeof(totals));
+    result.hands += totals.hands;
+    result.steps += totals.steps;
+    result.tablesBroken += totals.tablesBroken;
+    result.playersMoved += totals.playersMoved;
+    result.finalBlinds.smallBlind = totals.smallBlind;
+    result.finalBlinds.bigBlind = totals.bigBlind;
+    for (TournamentStrategyResult &strategy : result.strategies) {
+        CheckpointStrategy saved;
+        file.read((char *) &saved, sizeof(saved));
+        strategy.entries = saved.entries;
+        strategy.wins = saved.wins;
+        strategy.paid = saved.paid;
+        strategy.prizes = saved.prizes;
+    }
+    finishedTournaments = header.finishedTournaments;
+    result.resumedTournaments = finishedTournaments;
+    result.resumedHands = totals.hands;
+
+    if (file && header.inProgress) {
+        CheckpointProgress progress;
+        file.read((char *) &savedTotals, sizeof(savedTotals));
+        file.read((char *) &progress, sizeof(progress));
+        // A negative number of steps would ask BlindsForLevel for a level before the first
+        if (!file || savedTotals.steps < 0 || progress.playersLeft < 2 || progress.playersLeft > options.numPlayers ||
+            progress.numTables < 1 || progress.numTables > progress.playersLeft) {
+            Damaged();
+        }
+
+        // Every player still playing has no place yet, and everyone else has one below them
+        savedPlaces.resize(options.numPlayers);
+        file.read((char *) savedPlaces.data(), savedPlaces.size() * sizeof(int32_t));
+        int unplaced = 0;
+        for (int32_t place : savedPlaces) {
+            if (place < 0 || place > options.numPlayers || (place > 0 && place <= progress.playersLeft)) {
+                Damaged();
+            }
+            unplaced += place == 0;
+        }
+        if (unplaced != progress.playersLeft) {
+            Damaged();
+        }
+
+        savedHasRandomState.resize(options.numPlayers);
+        savedRandomStates.resize(options.numPlayers * 4);
+        for (int id = 0; id < options.numPlayers; id++) {
+            file.read((char *) &savedHasRandomState[id], sizeof(int32_t));
+            file.read((char *) &savedRandomStates[id * 4], 4 * sizeof(uint64_t));
+        }
+
+        // Each player still playing sits at exactly one table, and each table has between 1 and tableSize players and one dealer.
+        // Chips only ever move between players, so the players still playing hold every chip handed out
+        std::vector<bool> seated(options.numPlayers, false);
+        savedSeats.assign(progress.numTables, std::vector<CheckpointSeat>());
+        savedDecks.resize(progress.numTables);
+        int numSeated = 0;
+        long totalChips = 0;
+        for (int t = 0; t < progress.numTables && file; t++) {
+            int32_t numSeats;
+            file.read((char *) &numSeats, sizeof(numSeats));
+            if (!file || numSeats < 1 || numSeats > options.tableSize) {
+                Damaged();
+            }
+            savedSeats[t].resize(numSeats);
+            file.read((char *) savedSeats[t].data(), numSeats * sizeof(CheckpointSeat));
+            file.read((char *) &savedDecks[t], sizeof(DeckSnapshot));
+            if (!file) {
+                Damaged();
+            }
+
+            int numDealers = 0;
+            for (const CheckpointSeat &seat : savedSeats[t]) {
+                if (seat.playerId < 0 || seat.playerId >= options.numPlayers || savedPlaces[seat.playerId] != 0 ||
+                    seated[seat.playerId] || seat.chips < 0) {
+                    Damaged();
+                }
+                seated[seat.playerId] = true;
+                numDealers += seat.dealer != 0;
+                totalChips += seat.chips;
+            }
+            if (numDealers != 1) {
+                Damaged();
+            }
+            try {
+                Deck::CheckSnapshot(savedDecks[t]);
+            }
+            catch (const std::invalid_argument &) {
+                Damaged();
+            }
+            numSeated += numSeats;
+        }
+        if (numSeated != progress.playersLeft || totalChips != (long) options.startingChips * options.numPlayers) {
+            Damaged();
+        }
+        hasSaved = true;
+    }
+    if (!file) {
+        Damaged();
+    }
+
+    if (hasSaved) {
+        result.resumedHands += savedTotals.hands;
+    }
+    return true;
+}
+
+// Seat the players at their tables as they were saved, and put back the decks, the strategies' generators and the record
+bool TournamentCheckpoint::RestoreTournament(TournamentState &state) {
+    if (!hasSaved) {
+        return false;
+    }
+    hasSaved = false;
+
+    state.record.hands = savedTotals.hands;
+    state.record.steps = savedTotals.steps;
+    state.record.tablesBroken = savedTotals.tablesBroken;
+    state.record.playersMoved = savedTotals.playersMoved;
+    state.record.finalBlinds.smallBlind = savedTotals.smallBlind;
+    state.record.finalBlinds.bigBlind = savedTotals.bigBlind;
+    state.record.places.assign(savedPlaces.begin(), savedPlaces.end());
+
+    for (size_t id = 0; id < state.strategies.size(); id++) {
+        if (savedHasRandomState[id]) {
+            state.strategies[id]->RestoreRandomState(&savedRandomStates[id * 4]);
+        }
+    }
+
+    state.tables.assign(savedSeats.size(), Table());
+    state.playersLeft = 0;
+    for (size_t t = 0; t < savedSeats.size(); t++) {
+        for (const CheckpointSeat &seat : savedSeats[t]) {
+            state.tables[t].players.push_back(Player(state.names.at(seat.playerId), seat.chips));
+            if (seat.dealer) {
+                state.tables[t].players.back().FlipDealerStat();
+            }
+            state.playersLeft++;
+        }
+        state.tables[t].deck.RestoreSnapshot(savedDecks[t]);
+    }
+    return true;
+}
+
+// Count the new hands, and write the file if it is due
+void TournamentCheckpoint::Update(long newHands, const TournamentResult &result, long finishedTournaments, const TournamentState *inProgress) {
+    handsSinceWrite += newHands;
+    if (handsSinceWrite >= options.checkpointHands) {
+        Write(result, finishedTournaments, inProgress);
+    }
+}
+
+// Write everything to a temporary file, then rename it over the checkpoint file so the checkpoint file is always a whole one
+bool TournamentCheckpoint::Write(const TournamentResult &result, long finishedTournaments, const TournamentState *inProgress) {
+    std::string temporaryFile = options.checkpointFile + ".tmp";
+    std::ofstream file(temporaryFile, std::ios_base::binary | std::ios_base::trunc);
+
+    TournamentCheckpointHeader header;
+    std::memcpy(header.magic, TOURNAMENT_CHECKPOINT_MAGIC, sizeof(header.magic));
+    header.version = TOURNAMENT_CHECKPOINT_VERSION;
+    header.seed = options.seed;
+    header.numPlayers = options.numPlayers;
+    header.numTournaments = options.numTournaments;
+    header.tableSize = options.tableSize;
+    header.startingChips = options.startingChips;
+    header.handsPerStep = options.handsPerStep;
+    header.handsPerLevel = options.handsPerLevel;
+    header.settingsBytes = settings.size();
+    header.inProgress = inProgress != nullptr;
+    header.finishedTournaments = finishedTournaments;
+
+    CheckpointTotals totals;
+    totals.hands = result.hands;
+    totals.steps = result.steps;
+    totals.tablesBroken = result.tablesBroken;
+    totals.playersMoved = result.playersMoved;
+    totals.smallBlind = result.finalBlinds.smallBlind;
+    totals.bigBlind = result.finalBlinds.bigBlind;
+
+    file.write((const char *) &header, sizeof(header));
+    file.write(settings.data(), settings.size());
+    file.write((const char *) &totals, sizeof(totals));
+    for (const TournamentStrategyResult &strategy : result.strategies) {
+        CheckpointStrategy saved;
+        saved.entries = strategy.entries;
+        saved.wins = strategy.wins;
+        saved.paid = strategy.paid;
+        saved.prizes = strategy.prizes;
+        file.write((const char *) &saved, sizeof(saved));
+    }
+
+    if (inProgress) {
+        const TournamentRecord &record = inProgress->record;
+        totals.hands = record.hands;
+        totals.steps = record.steps;
+        totals.tablesBroken = record.tablesBroken;
+        totals.playersMoved = record.playersMoved;
+        totals.smallBlind = record.finalBlinds.smallBlind;
+        totals.bigBlind = record.finalBlinds.bigBlind;
+        CheckpointProgress progress;
+        progress.playersLeft = inProgress->playersLeft;
+        progress.numTables = inProgress->tables.size();
+        file.write((const char *) &totals, sizeof(totals));
+        file.write((const char *) &progress, sizeof(progress));
+
+        for (int place : record.places) {
+            int32_t savedPlace = place;
+            file.write((const char *) &savedPlace, sizeof(savedPlace));
+        }
+        for (const std::unique_ptr<ActionProvider> &strategy : inProgress->strategies) {
+            uint64_t randomState[4] = {0, 0, 0, 0};
+            int32_t hasRandomState = strategy->SaveRandomState(randomState);
+            file.write((const char *) &hasRandomState, sizeof(hasRandomState));
+            file.write((const char *) randomState, sizeof(randomState));
+        }
+
+        for (const Table &table : inProgress->tables) {
+            int32_t numSeats = table.players.size();
+            file.write((const char *) &numSeats, sizeof(numSeats));
+            for (const Player &player : table.players) {
+                CheckpointSeat seat;
+                seat.playerId = inProgress->playerIds.at(player.GetName());
+                seat.chips = player.GetChips();
+                seat.dealer = player.isDealer();
+                file.write((const char *) &seat, sizeof(seat));
+            }
+            DeckSnapshot deck;
+            table.deck.SaveSnapshot(deck);
+            file.write((const char *) &deck, sizeof(deck));
+        }
+    }
+    file.close();
+
+    if (!file || std::rename(temporaryFile.c_str(), options.checkpointFile.c_str()) != 0) {
+        return false;
+    }
+    handsSinceWrite = 0;
+    return true;
+}
+
+// Play every tournament in turn, each one spreading its tables over the same thread pool, and gather up the results
+TournamentResult RunTournaments(const TournamentOptions &options) {
+    if (options.numPlayers < 2) {
+        throw std::invalid_argument("RunTournaments: at least 2 players are needed");
+    }
+    if (options.numTournaments < 1) {
+        throw std::invalid_argument("RunTournaments: at least 1 tournament is needed");
+    }
+    if (options.tableSize < 2 || options.tableSize > 10) {
+        throw std::invalid_argument("RunTournaments: tables must seat between 2 and 10 players");
+    }
+    if (options.startingChips < 1 || (long) options.startingChips * options.numPlayers > INT_MAX) {
+        throw std::invalid_argument("RunTournaments: the starting chips must be at least 1, and all the chips must fit in an int");
+    }
+    if (options.handsPerStep < 1 || options.handsPerLevel < 1) {
+        throw std::invalid_argument("RunTournaments: the hands per step and per level must be at least 1");
+    }
+    if (options.blindLevels.empty()) {
+        throw std::invalid_argument("RunTournaments: at least 1 blind level is needed");
+    }
+    for (const Blinds &blinds : options.blindLevels) {
+        if (blinds.smallBlind < 0 || blinds.bigBlind < 1) {
+            throw std::invalid_argument("RunTournaments: the big blind must be at least 1 and the small blind at least 0");
+        }
+    }
+    if (options.strategies.empty()) {
+        throw std::invalid_argument("RunTournaments: at least 1 strategy is needed");
+    }
+    // Check every strategy name before any tournament starts, since tasks on the pool must not throw
+    for (const std::string &name : options.strategies) {
+        MakeStrategy(name);
+    }
+
+    std::vector<double> payouts = TournamentPayouts(options);
+    double totalShare = 0;
+    for (double share : payouts) {
+        if (share < 0) {
+            throw std::invalid_argument("RunTournaments: payouts cannot be negative");
+        }
+        totalShare += share;
+    }
+    if (payouts.size() > (size_t) options.numPlayers || totalShare > 1.000001) {
+        throw std::invalid_argument("RunTournaments: more places are paid than there are players, or more than the whole prize pool");
+    }
+
+    if (options.checkpointHands < 1) {
+        throw std::invalid_argument("RunTournaments: the checkpoint needs to be written at least every 1 hand");
+    }
+
+    TournamentResult result;
+    result.tournaments = options.numTournaments;
+    result.seed = options.seed;
+    for (const std::string &name : options.strategies) {
+        TournamentStrategyResult strategy;
+        strategy.name = name;
+        result.strategies.push_back(strategy);
+    }
+
+    // Carry on from the checkpoint file if there is one
+    std::unique_ptr<TournamentCheckpoint> checkpoint;
+    long finishedTournaments = 0;
+    if (!options.checkpointFile.empty()) {
+        checkpoint.reset(new TournamentCheckpoint(options));
+        checkpoint->Load(result, finishedTournaments);
+    }
+
+    Xoshiro256 seedGenerator(options.seed);
+    ThreadPool pool(options.numThreads);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long t = 0; t < options.numTournaments; t++) {
+        // Every tournament takes its seed in order, including the ones the checkpoint has finished, so tournament t always gets the same seed
+        uint64_t tournamentSeed = seedGenerator();
+        if (t < finishedTournaments) {
+            continue;
+        }
+
+        // A tournament the checkpoint has in progress is started just as it was the first time, then put back as it was saved
+        TournamentState state;
+        StartTournament(options, t, tournamentSeed, state);
+        if (checkpoint) {
+            checkpoint->RestoreTournament(state);
+            // The checkpoint is written straight away, so a file that cannot be written is found before any hand is played
+            if (t == finishedTournaments && !checkpoint->Write(result, t, &state)) {
+                throw std::invalid_argument("RunTournaments: could not write the checkpoint file '" + options.checkpointFile + "'");
+            }
+        }
+
+        // Play step after step until one player is left, saving the tournament between steps
+        long stepHands = PlayStep(options, state, pool);
+        while (state.playersLeft > 1) {
+            if (checkpoint) {
+                checkpoint->Update(stepHands, result, t, &state);
+            }
+            stepHands = PlayStep(options, state, pool);
+        }
+        const TournamentRecord &record = state.record;
+
+        result.hands += record.hands;
+        result.steps += record.steps;
+        result.tablesBroken += record.tablesBroken;
+        result.playersMoved += record.playersMoved;
+        result.finalBlinds = record.finalBlinds;
+
+        // Every entry costs 1 buy-in, so the prize pool is one buy-in per player
+        for (int id = 0; id < options.numPlayers; id++) {
+            TournamentStrategyResult &strategy = result.strategies.at(PlayerStrategy(options, t, id));
+            int place = record.places.at(id);
+            strategy.entries++;
+            if (place == 1) {
+                strategy.wins++;
+            }
+            if (place <= (int) payouts.size()) {
+                strategy.paid++;
+                strategy.prizes += payouts.at(place - 1) * options.numPlayers;
+            }
+        }
+
+        if (checkpoint) {
+            checkpoint->Update(stepHands, result, t + 1, nullptr);
+        }
+    }
+    if (checkpoint) {
+        checkpoint->Write(result, options.numTournaments, nullptr);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    result.seconds = elapsed.count();
+    result.handsPerSecond = result.seconds > 0 ? (result.hands - result.resumedHands) / result.seconds : 0;
+
+    return result;
+}
+
+// Print the speed of the tournaments, how the tables were broken and balanced, and each strategy's results
+void PrintTournamentResult(const TournamentResult &result, const TournamentOptions &options) {
+    int numTables = (options.numPlayers + options.tableSize - 1) / options.tableSize;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Played " << result.tournaments << " tournaments of " << options.numPlayers << " players (starting at " << numTables
+              << " tables of up to " << options.tableSize << ") in " << result.seconds << " seconds\n";
+    std::cout << result.hands << " hands, " << std::setprecision(0) << result.handsPerSecond << " hands per second\n";
+    if (result.resumedTournaments > 0 || result.resumedHands > 0) {
+        std::cout << "Carried on from a checkpoint, with " << result.resumedTournaments << " tournaments finished and " << result.resumedHands
+                  << " hands played before this run\n";
+    }
+    std::cout << result.steps << " steps of " << options.handsPerStep << " hands, " << result.tablesBroken << " tables broken, "
+              << result.playersMoved << " players moved, final blinds " << result.finalBlinds.smallBlind << "/" << result.finalBlinds.bigBlind << "\n";
+
+    std::cout << "Results per strategy (each entry costs 1 buy-in, " << TournamentPayouts(options).size() << " places paid):\n";
+    for (const TournamentStrategyResult &strategy : result.strategies) {
+        double entries = strategy.entries > 0 ? strategy.entries : 1;
+        std::cout << "  " << std::left << std::setw(8) << strategy.name << std::right << std::setw(8) << strategy.entries << " entries, "
+                  << std::setw(6) << strategy.wins << " wins, " << std::setw(7) << std::setprecision(1) << strategy.paid * 100 / entries
+                  << "% paid, return on investment " << std::setw(7) << (strategy.prizes - strategy.entries) * 100 / entries << "%\n";
+    }
+
+    // Passing this seed back with --seed plays exactly the same tournaments again
+    std::cout << "Seed " << result.seed << "\n";
+}
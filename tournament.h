@@ -0,0 +1,90 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "round.h"
+#include "random_generator.h"
+
+// What to play: how many players enter each tournament, how they are seated, the blind schedule and how the prizes are paid
+struct TournamentOptions {
+    int numPlayers = 1000;
+    int numTournaments = 1;
+    // The most players seated at one table (tables are kept within one player of each other's size)
+    int tableSize = 9;
+    int startingChips = 1000;
+    // Player p of tournament t plays strategies[(p + t) % strategies.size()], so every strategy gets the same number of entries
+    std::vector<std::string> strategies = {"tight", "call", "raise", "random"};
+    // Every table plays this many hands between each time the tables are broken and balanced
+    int handsPerStep = 10;
+    // The blinds go up to the next level every handsPerLevel hands, and double after the last level in the list
+    int handsPerLevel = 20;
+    std::vector<Blinds> blindLevels = {{10, 20}, {15, 30}, {25, 50}, {50, 100}, {75, 150}, {100, 200}, {150, 300},
+                                       {200, 400}, {300, 600}, {400, 800}, {500, 1000}, {700, 1400}, {1000, 2000}};
+    // The share of the prize pool paid for 1st place, 2nd place and so on. Left empty, the top 15% of the players are paid,
+    // each place getting a share in proportion to 1 / place
+    std::vector<double> payouts;
+    // 0 uses one thread per core
+    int numThreads = 0;
+    // The same seed seats, deals and decides everything the same way, with any number of threads
+    uint64_t seed = RandomSeed();
+    // Progress is saved in this checkpoint file between steps (or nowhere if it is empty), and is rewritten each time another
+    // checkpointHands hands have been played. The same tournaments run again with the same checkpoint file carry on from it
+    std::string checkpointFile;
+    long checkpointHands = 1000000;
+};
+
+// How one strategy did over every tournament played, with each entry costing 1 buy-in
+struct TournamentStrategyResult {
+    std::string name;
+    long entries = 0;
+    long wins = 0;
+    // The number of entries that finished in a paid place, and the buy-ins they won between them
+    long paid = 0;
+    double prizes = 0;
+};
+
+// The results of every tournament played, along with how quickly they ran
+struct TournamentResult {
+    long tournaments = 0;
+    long hands = 0;
+    // The number of times every table played handsPerStep hands and the tables were broken and balanced
+    long steps = 0;
+    long tablesBroken = 0;
+    long playersMoved = 0;
+    // The blinds when the last tournament finished
+    Blinds finalBlinds;
+    double seconds = 0;
+    double handsPerSecond = 0;
+    // When carrying on from a checkpoint: the tournaments it had finished, and the hands it had played (which are not counted in handsPerSecond)
+    long resumedTournaments = 0;
+    long resumedHands = 0;
+    std::vector<TournamentStrategyResult> strategies;
+    uint64_t seed = 0;
+};
+
+// Return the blinds for the given level (counting from 0): the level from the list, or the last level doubled for each level past the end
+Blinds BlindsForLevel(const std::vector<Blinds> &blindLevels, int level);
+// Return the share of the prize pool paid to each place, from 1st place down, for numPlayers entries
+std::vector<double> TournamentPayouts(const TournamentOptions &options);
+
+/* Play options.numTournaments multi-table tournaments between the built-in strategies. Each table is its own set of players
+   and deck playing its own Rounds, and every table plays handsPerStep hands at the same time as a task on a thread pool.
+   Once they have all finished, which is the only time the tables wait for each other, players knocked out in DivvyPots are
+   given their finishing place, tables are broken up as the field shrinks, players are moved so that no table has two more
+   players than another, and the blinds go up on schedule. Nothing is printed and no results are written to the txt file.
+   With options.checkpointFile set, the checkpoint file keeps the totals of every finished tournament along with the whole
+   tournament in progress (every table's players, chips, dealer and deck, each player's strategy generator and the places given
+   out so far). It is written between steps, to a temporary file first that is then renamed over the old one, so tournaments
+   killed at any point leave a whole checkpoint behind. Running them again carries on from the last step saved and gives exactly
+   the results they would have given had they never stopped. A checkpoint that cannot be written while playing is tried again later.
+   Throws std::invalid_argument for options that cannot be played, or a checkpoint file that is damaged or was written by
+   different tournaments (any option but the number of threads being different).
+*/
+TournamentResult RunTournaments(const TournamentOptions &options);
+// Print the speed of the tournaments, how often tables were broken and balanced, and each strategy's results and return on investment
+void PrintTournamentResult(const TournamentResult &result, const TournamentOptions &options);
+
+#endif